@@ -81,6 +81,7 @@ FMABoxed     *fma_boxed_new_from_string( guint type, const gchar *string );
 
 gboolean      fma_boxed_get_boolean    ( const FMABoxed *boxed );
 gconstpointer fma_boxed_get_pointer    ( const FMABoxed *boxed );
+guint         fma_boxed_get_stamp      ( const FMABoxed *boxed );
 gchar        *fma_boxed_get_string     ( const FMABoxed *boxed );
 GSList       *fma_boxed_get_string_list( const FMABoxed *boxed );
 guint         fma_boxed_get_uint       ( const FMABoxed *boxed );
@@ -99,7 +99,8 @@ gchar   *fma_core_utils_file_load_from_uri( const gchar *uri, gsize *length );
 
 /* miscellaneous
  */
-void     fma_core_utils_print_version( void );
+guint    fma_core_utils_get_processors_count( void );
+void     fma_core_utils_print_version       ( void );
 
 G_END_DECLS
 
@@ -158,6 +158,7 @@
  */
 
 #include <gdk-pixbuf/gdk-pixbuf.h>
+#include <gio/gio.h>
 #include "fma-object-item.h"
 
 G_BEGIN_DECLS
@@ -365,6 +366,38 @@ typedef struct {
 }
 	FMAIExporterBufferParmsv2;
 
+/**
+ * FMAIExporterStreamParms:
+ * @version:  [in] version of this structure;
+ *                 equals to 1;
+ *                 since structure version 1.
+ * @exported: [in] exported FMAObjectItem-derived object;
+ *                 since structure version 1.
+ * @format:   [in] export format string identifier;
+ *                 since structure version 1.
+ * @stream:   [in] the #GOutputStream the exported object is to be
+ *                 written to; it is neither flushed nor closed by the
+ *                 plugin;
+ *                 since structure version 1.
+ * @messages: [in/out] a #GSList list of localized strings;
+ *                 the provider may append messages to this list,
+ *                 but shouldn't reinitialize it;
+ *                 since structure version 1.
+ *
+ * The structure that the plugin receives as a parameter of
+ * #FMAIExporterInterface.to_stream () interface method.
+ *
+ * Since: 3.5
+ */
+typedef struct {
+	guint          version;
+	FMAObjectItem *exported;
+	gchar         *format;
+	GOutputStream *stream;
+	GSList        *messages;
+}
+	FMAIExporterStreamParms;
+
 /**
  * FMAIExporterInterface:
  * @get_version:  [should] returns the version of this interface the plugin implements.
@@ -373,6 +406,7 @@ typedef struct {
  * @free_formats: [should] free a list of formats
  * @to_file:      [should] exports an item to a file.
  * @to_buffer:    [should] exports an item to a buffer.
+ * @to_stream:    [may] exports an item to an output stream.
  *
  * This defines the interface that a #FMAIExporter should implement.
  */
@@ -494,6 +528,24 @@ typedef struct {
 	 * Since: 2.30
 	 */
 	guint   ( *to_buffer )  ( const FMAIExporter *instance, FMAIExporterBufferParmsv2 *parms );
+
+	/**
+	 * to_stream:
+	 * @instance: this FMAIExporter instance.
+	 * @parms: a FMAIExporterStreamParms structure.
+	 *
+	 * Exports the specified 'exported' in the required 'format',
+	 * writing it to the 'stream' as it is produced, so that the whole
+	 * output does not have to be held in memory.
+	 *
+	 * Return value: the FMAIExporterExportStatus status of the operation.
+	 *
+	 * Defaults to NULL, and &prodname; then writes to the stream the
+	 * buffer returned by the to_buffer() method.
+	 *
+	 * Since: 3.5
+	 */
+	guint   ( *to_stream )  ( const FMAIExporter *instance, FMAIExporterStreamParms *parms );
 }
 	FMAIExporterInterface;
 
@@ -253,6 +253,7 @@ typedef struct {
 GType         fma_ifactory_object_get_type       ( void );
 
 FMADataBoxed *fma_ifactory_object_get_data_boxed ( const FMAIFactoryObject *object, const gchar *name );
+void          fma_ifactory_object_get_data_boxed_v( const FMAIFactoryObject *object, const gchar * const *names, FMADataBoxed **boxed );
 FMADataGroup *fma_ifactory_object_get_data_groups( const FMAIFactoryObject *object );
 void         *fma_ifactory_object_get_as_void    ( const FMAIFactoryObject *object, const gchar *name );
 void          fma_ifactory_object_set_from_void  ( FMAIFactoryObject *object, const gchar *name, const void *data );
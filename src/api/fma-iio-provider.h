@@ -252,6 +252,9 @@ typedef struct _FMAIIOProviderInterfacePrivate     FMAIIOProviderInterfacePrivat
  * @write_item:          [should] writes an item.
  * @delete_item:         [should] deletes an item.
  * @duplicate_data:      [may]    let the I/O provider duplicates its specific data.
+ * @read_item:           [may]    reads a single item.
+ * @get_sources:         [may]    returns the sources the items are read from.
+ * @write_items:         [may]    writes and deletes a batch of items.
  *
  * This defines the methods that a #FMAIIOProvider may, should, or must
  * implement.
@@ -467,6 +470,90 @@ typedef struct {
 											FMAObjectItem *dest,
 											const FMAObjectItem *source,
 											GSList **messages );
+
+	/**
+	 * read_item:
+	 * @instance: the FMAIIOProvider provider.
+	 * @id: the identifier of the item to be read.
+	 * @messages: a pointer to a GSList list of strings; the provider
+	 *  may append messages to this list, but shouldn't reinitialize it.
+	 *
+	 * Reads a single item from the specified I/O provider.
+	 *
+	 * This lets &prodname; only reload the items the I/O provider has
+	 * reported as changed with fma_iio_provider_items_changed() or
+	 * fma_iio_provider_items_changed_full(), instead
+	 * of re-reading the whole items list.
+	 *
+	 * Return value: if implemented, this method must return the newly
+	 * allocated FMAObjectItem-derived object (menu or action) which has
+	 * the given @id, or %NULL if the item no longer exists.
+	 *
+	 * Defaults to NULL, and &prodname; then reloads the whole items list.
+	 *
+	 * Since: 3.5
+	 */
+	FMAObjectItem * ( *read_item )  ( const FMAIIOProvider *instance,
+											const gchar *id,
+											GSList **messages );
+
+	/**
+	 * get_sources:
+	 * @instance: the FMAIIOProvider provider.
+	 *
+	 * Lists the local paths, either directories or files, the items
+	 * of this I/O provider are read from.
+	 *
+	 * &prodname; stats these paths to check whether a cache of the
+	 * items it has already loaded is still up to date, and so whether
+	 * it may avoid to read them again. The returned list must so
+	 * include the directories (even those which do not exist yet) as
+	 * well as the files themselves.
+	 *
+	 * As the items may so not be read at all, the I/O provider should
+	 * take advantage of this call to set up its own monitoring of these
+	 * sources, if any.
+	 *
+	 * Return value: if implemented, this method must return a newly
+	 * allocated #GSList of newly allocated path strings.
+	 *
+	 * Defaults to NULL, and &prodname; then never caches the items
+	 * as long as this I/O provider is readable.
+	 *
+	 * Since: 3.5
+	 */
+	GSList * ( *get_sources )       ( const FMAIIOProvider *instance );
+
+	/**
+	 * write_items:
+	 * @instance: the FMAIIOProvider provider.
+	 * @items: a list of FMAObjectItem-derived items, menus or actions,
+	 *  to be written.
+	 * @deleted: a list of FMAObjectItem-derived items, menus or actions,
+	 *  to be deleted.
+	 * @messages: a pointer to a GSList list of strings; the provider
+	 *  may append messages to this list, but shouldn't reinitialize it.
+	 *
+	 * Deletes the @deleted items, and then writes the @items, down to
+	 * the underlying storage subsystem, as a single operation.
+	 *
+	 * The I/O provider should do its best for the batch to be applied
+	 * as a whole: if an error occurs, its storage subsystem should be
+	 * left as it was before the call.
+	 *
+	 * Return value: IIO_PROVIDER_CODE_OK if the whole batch has been
+	 * successfully written, or another code depending of the detected
+	 * error, in which case all the items are considered as not written.
+	 *
+	 * Defaults to NULL, and &prodname; then calls delete_item() and
+	 * write_item() methods for each item of the batch.
+	 *
+	 * Since: 3.5
+	 */
+	guint    ( *write_items )        ( const FMAIIOProvider *instance,
+											const GList *items,
+											const GList *deleted,
+											GSList **messages );
 }
 	FMAIIOProviderInterface;
 
@@ -536,11 +623,46 @@ typedef enum {
 }
 	FMAIIOProviderOperationStatus;
 
-GType fma_iio_provider_get_type    ( void );
+/**
+ * FMAIIOProviderChangeType:
+ * @IIO_PROVIDER_CHANGE_CREATED: the item has been created.
+ * @IIO_PROVIDER_CHANGE_UPDATED: the item has been updated.
+ * @IIO_PROVIDER_CHANGE_DELETED: the item has been deleted.
+ *
+ * The kind of a change detected by an I/O provider on one of its items.
+ *
+ * Since: 3.5
+ */
+typedef enum {
+	IIO_PROVIDER_CHANGE_CREATED = 1,
+	IIO_PROVIDER_CHANGE_UPDATED,
+	IIO_PROVIDER_CHANGE_DELETED,
+}
+	FMAIIOProviderChangeType;
+
+/**
+ * FMAIIOProviderChange:
+ * @id: the identifier of the changed item (menu or action).
+ * @type: the #FMAIIOProviderChangeType of the change.
+ *
+ * A change detected by an I/O provider, as reported by
+ * fma_iio_provider_items_changed_full().
+ *
+ * Since: 3.5
+ */
+typedef struct {
+	gchar                   *id;
+	FMAIIOProviderChangeType type;
+}
+	FMAIIOProviderChange;
+
+GType fma_iio_provider_get_type          ( void );
 
 /* -- to be called by the I/O provider when an item has changed
  */
-void  fma_iio_provider_item_changed( const FMAIIOProvider *instance );
+void  fma_iio_provider_item_changed      ( const FMAIIOProvider *instance );
+void  fma_iio_provider_items_changed     ( const FMAIIOProvider *instance, GSList *ids );
+void  fma_iio_provider_items_changed_full( const FMAIIOProvider *instance, GSList *changes );
 
 G_END_DECLS
 
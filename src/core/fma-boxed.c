@@ -73,6 +73,7 @@ struct _FMABoxedPrivate {
 	gboolean         dispose_has_run;
 	const sBoxedDef *def;
 	gboolean         is_set;
+	guint            stamp;
 	union {
 		gboolean  boolean;
 		void     *pointer;
@@ -87,6 +88,7 @@ struct _FMABoxedPrivate {
 #define DEBUG							if( 0 ) g_debug
 
 static GObjectClass *st_parent_class    = NULL;
+static volatile gint st_last_stamp      = 0;
 
 static GType            register_type( void );
 static void             class_init( FMABoxedClass *klass );
@@ -95,6 +97,7 @@ static void             instance_dispose( GObject *object );
 static void             instance_finalize( GObject *object );
 
 static FMABoxed        *boxed_new( const sBoxedDef *def );
+static guint            boxed_next_stamp( void );
 static const sBoxedDef *get_boxed_def( guint type );
 static gchar          **string_to_array( const gchar *string );
 
@@ -366,6 +369,7 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private->dispose_has_run = FALSE;
 	self->private->def = NULL;
 	self->private->is_set = FALSE;
+	self->private->stamp = boxed_next_stamp();
 }
 
 static void
@@ -425,6 +429,17 @@ boxed_new( const sBoxedDef *def )
 	return( boxed );
 }
 
+/*
+ * the stamps are unique among all the boxed of the program: a boxed
+ * gets a new one each time its value is set, so that two identical
+ * stamps on the same boxed imply an unchanged value
+ */
+static guint
+boxed_next_stamp( void )
+{
+	return(( guint ) g_atomic_int_add( &st_last_stamp, 1 ) + 1 );
+}
+
 static const sBoxedDef *
 get_boxed_def( guint type )
 {
@@ -499,6 +514,7 @@ fma_boxed_set_type( FMABoxed *boxed, guint type )
 	g_return_if_fail( boxed->private->def == NULL );
 
 	boxed->private->def = get_boxed_def( type );
+	boxed->private->stamp = boxed_next_stamp();
 }
 
 /**
@@ -672,6 +688,27 @@ fma_boxed_get_pointer( const FMABoxed *boxed )
 	return( value );
 }
 
+/**
+ * fma_boxed_get_stamp:
+ * @boxed: the #FMABoxed structure.
+ *
+ * The stamp of a #FMABoxed is renewed each time its value is set.
+ * As stamps are never reused, a @boxed whose stamp has not changed
+ * still holds the same value, and does not need to be compared again.
+ *
+ * Returns: the current stamp of the @boxed.
+ *
+ * Since: 3.5
+ */
+guint
+fma_boxed_get_stamp( const FMABoxed *boxed )
+{
+	g_return_val_if_fail( FMA_IS_BOXED( boxed ), 0 );
+	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, 0 );
+
+	return( boxed->private->stamp );
+}
+
 /**
  * fma_boxed_get_string:
  * @boxed: the #FMABoxed structure.
@@ -839,6 +876,7 @@ fma_boxed_set_from_boxed( FMABoxed *boxed, const FMABoxed *value )
 	( *boxed->private->def->free )( boxed );
 	( *boxed->private->def->copy )( boxed, value );
 	boxed->private->is_set = TRUE;
+	boxed->private->stamp = boxed_next_stamp();
 }
 
 /**
@@ -862,6 +900,7 @@ fma_boxed_set_from_string( FMABoxed *boxed, const gchar *value )
 	( *boxed->private->def->free )( boxed );
 	( *boxed->private->def->from_string )( boxed, value );
 	boxed->private->is_set = TRUE;
+	boxed->private->stamp = boxed_next_stamp();
 }
 
 /**
@@ -885,6 +924,7 @@ fma_boxed_set_from_value( FMABoxed *boxed, const GValue *value )
 	( *boxed->private->def->free )( boxed );
 	( *boxed->private->def->from_value )( boxed, value );
 	boxed->private->is_set = TRUE;
+	boxed->private->stamp = boxed_next_stamp();
 }
 
 /**
@@ -908,6 +948,7 @@ fma_boxed_set_from_void( FMABoxed *boxed, const void *value )
 	( *boxed->private->def->free )( boxed );
 	( *boxed->private->def->from_void )( boxed, value );
 	boxed->private->is_set = TRUE;
+	boxed->private->stamp = boxed_next_stamp();
 }
 
 static gboolean
@@ -0,0 +1,571 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include <api/fma-core-utils.h>
+#include <api/fma-object-api.h>
+
+#include "fma-candidate-index.h"
+#include "fma-mime-type.h"
+#include "fma-selected-info.h"
+
+/* the target bits of an indexed action
+ * other contexts (menus, profiles) are not subject to the target check
+ */
+#define TARGET_BIT( t )					( 1 << ( t ))
+
+struct _FMACandidateIndex {
+	GHashTable *contexts;				/* FMAIContext -> IndexEntry */
+	GHashTable *any_scheme;				/* set of contexts which accept any scheme */
+	GHashTable *schemes;				/* scheme -> set of contexts */
+	GHashTable *any_mimetype;			/* set of contexts which accept any mimetype */
+	GHashTable *mimetypes;				/* condition mimetype -> set of contexts */
+};
+
+/* what we have recorded for each indexed context
+ * so that we are able to remove it later
+ */
+typedef struct {
+	guint   targets;					/* 0 if not an action */
+	guint   attributes;					/* the file attributes needed by the conditions */
+	GSList *scheme_keys;
+	GSList *mimetype_keys;
+}
+	IndexEntry;
+
+static void        add_items_rec( FMACandidateIndex *index, GList *tree );
+static void        add_context( FMACandidateIndex *index, FMAObject *context );
+static void        remove_items_rec( FMACandidateIndex *index, GList *tree );
+static void        remove_context( FMACandidateIndex *index, FMAObject *context );
+static guint       get_attributes( FMAObject *context );
+static GSList     *get_positive_keys( GSList *conditions, gboolean *is_any );
+static gboolean    is_any_mimetype( const gchar *mimetype );
+static void        bucket_add( GHashTable *buckets, const gchar *key, FMAObject *context );
+static void        bucket_remove( GHashTable *buckets, const gchar *key, FMAObject *context );
+static GHashTable *set_new( void );
+static GHashTable *get_mimetype_set( const FMACandidateIndex *index, const gchar *ftype );
+static gboolean    is_target_candidate( const IndexEntry *entry, guint target );
+static void        entry_free( IndexEntry *entry );
+
+/*
+ * fma_candidate_index_new:
+ *
+ * Returns: a newly allocated empty #FMACandidateIndex, which should be
+ * fma_candidate_index_free() by the caller.
+ */
+FMACandidateIndex *
+fma_candidate_index_new( void )
+{
+	FMACandidateIndex *index;
+
+	index = g_new0( FMACandidateIndex, 1 );
+
+	index->contexts = g_hash_table_new_full( g_direct_hash, g_direct_equal, NULL, ( GDestroyNotify ) entry_free );
+	index->any_scheme = set_new();
+	index->schemes = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, ( GDestroyNotify ) g_hash_table_destroy );
+	index->any_mimetype = set_new();
+	index->mimetypes = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, ( GDestroyNotify ) g_hash_table_destroy );
+
+	return( index );
+}
+
+/*
+ * fma_candidate_index_free:
+ * @index: this #FMACandidateIndex structure.
+ *
+ * Releases the resources allocated to the @index.
+ * The indexed items are left untouched.
+ */
+void
+fma_candidate_index_free( FMACandidateIndex *index )
+{
+	if( index ){
+		g_hash_table_destroy( index->contexts );
+		g_hash_table_destroy( index->any_scheme );
+		g_hash_table_destroy( index->schemes );
+		g_hash_table_destroy( index->any_mimetype );
+		g_hash_table_destroy( index->mimetypes );
+		g_free( index );
+	}
+}
+
+/*
+ * fma_candidate_index_add_items:
+ * @index: this #FMACandidateIndex structure.
+ * @tree: a list of #FMAObjectItem -derived objects.
+ *
+ * Recursively adds the @tree items, along with their subitems and their
+ * profiles, to the @index.
+ */
+void
+fma_candidate_index_add_items( FMACandidateIndex *index, GList *tree )
+{
+	g_return_if_fail( index != NULL );
+
+	add_items_rec( index, tree );
+}
+
+static void
+add_items_rec( FMACandidateIndex *index, GList *tree )
+{
+	GList *it;
+
+	for( it = tree ; it ; it = it->next ){
+		if( FMA_IS_ICONTEXT( it->data )){
+			add_context( index, FMA_OBJECT( it->data ));
+		}
+		if( FMA_IS_OBJECT_ITEM( it->data )){
+			add_items_rec( index, fma_object_get_items( it->data ));
+		}
+	}
+}
+
+static void
+add_context( FMACandidateIndex *index, FMAObject *context )
+{
+	IndexEntry *entry;
+	GSList *conditions, *ik;
+	gboolean is_any;
+
+	if( g_hash_table_lookup( index->contexts, context )){
+		remove_context( index, context );
+	}
+
+	entry = g_new0( IndexEntry, 1 );
+
+	if( FMA_IS_OBJECT_ACTION( context )){
+		if( fma_object_is_target_selection( context )){
+			entry->targets |= TARGET_BIT( ITEM_TARGET_SELECTION );
+		}
+		if( fma_object_is_target_location( context )){
+			entry->targets |= TARGET_BIT( ITEM_TARGET_LOCATION );
+		}
+		if( fma_object_is_target_toolbar( context )){
+			entry->targets |= TARGET_BIT( ITEM_TARGET_TOOLBAR );
+		}
+		/* an action without any target is never candidate,
+		 * but must still be distinguished from a non-action
+		 */
+		entry->targets |= TARGET_BIT( ITEM_TARGET_ANY );
+	}
+
+	entry->attributes = get_attributes( context );
+
+	conditions = fma_object_get_schemes( context );
+	entry->scheme_keys = get_positive_keys( conditions, &is_any );
+	fma_core_utils_slist_free( conditions );
+
+	if( is_any ){
+		fma_core_utils_slist_free( entry->scheme_keys );
+		entry->scheme_keys = NULL;
+		g_hash_table_add( index->any_scheme, context );
+	} else {
+		for( ik = entry->scheme_keys ; ik ; ik = ik->next ){
+			bucket_add( index->schemes, ( const gchar * ) ik->data, context );
+		}
+	}
+
+	is_any = fma_object_get_all_mimetypes( context );
+	if( !is_any ){
+		conditions = fma_object_get_mimetypes( context );
+		entry->mimetype_keys = get_positive_keys( conditions, &is_any );
+		fma_core_utils_slist_free( conditions );
+
+		for( ik = entry->mimetype_keys ; ik && !is_any ; ik = ik->next ){
+			is_any = is_any_mimetype(( const gchar * ) ik->data );
+		}
+	}
+
+	if( is_any ){
+		fma_core_utils_slist_free( entry->mimetype_keys );
+		entry->mimetype_keys = NULL;
+		g_hash_table_add( index->any_mimetype, context );
+	} else {
+		for( ik = entry->mimetype_keys ; ik ; ik = ik->next ){
+			bucket_add( index->mimetypes, ( const gchar * ) ik->data, context );
+		}
+	}
+
+	g_hash_table_insert( index->contexts, context, entry );
+}
+
+/*
+ * the file attributes which will have to be queried for the selected
+ * files when evaluating the conditions of the @context
+ * this must be kept consistent with fma_icontext_is_candidate()
+ */
+static guint
+get_attributes( FMAObject *context )
+{
+	guint attributes;
+	GSList *capabilities, *ic;
+	const gchar *cap;
+
+	attributes = 0;
+
+	if( !fma_object_get_all_mimetypes( context )){
+		attributes |= SELECTED_INFO_ATTR_TYPE | SELECTED_INFO_ATTR_MIMETYPE;
+	}
+
+	capabilities = fma_object_get_capabilities( context );
+
+	for( ic = capabilities ; ic ; ic = ic->next ){
+		cap = ( const gchar * ) ic->data;
+		if( cap[0] == '!' ){
+			cap += 1;
+		}
+		if( !strcmp( cap, "Owner" )){
+			attributes |= SELECTED_INFO_ATTR_OWNER;
+
+		} else if( !strcmp( cap, "Readable" ) || !strcmp( cap, "Writable" ) || !strcmp( cap, "Executable" )){
+			attributes |= SELECTED_INFO_ATTR_ACCESS;
+		}
+	}
+
+	fma_core_utils_slist_free( capabilities );
+
+	return( attributes );
+}
+
+/*
+ * fma_candidate_index_remove_items:
+ * @index: this #FMACandidateIndex structure.
+ * @tree: a list of #FMAObjectItem -derived objects.
+ *
+ * Recursively removes the @tree items, along with their subitems and
+ * their profiles, from the @index.
+ */
+void
+fma_candidate_index_remove_items( FMACandidateIndex *index, GList *tree )
+{
+	g_return_if_fail( index != NULL );
+
+	remove_items_rec( index, tree );
+}
+
+static void
+remove_items_rec( FMACandidateIndex *index, GList *tree )
+{
+	GList *it;
+
+	for( it = tree ; it ; it = it->next ){
+		remove_context( index, FMA_OBJECT( it->data ));
+		if( FMA_IS_OBJECT_ITEM( it->data )){
+			remove_items_rec( index, fma_object_get_items( it->data ));
+		}
+	}
+}
+
+static void
+remove_context( FMACandidateIndex *index, FMAObject *context )
+{
+	IndexEntry *entry;
+	GSList *ik;
+
+	entry = ( IndexEntry * ) g_hash_table_lookup( index->contexts, context );
+
+	if( entry ){
+		g_hash_table_remove( index->any_scheme, context );
+		for( ik = entry->scheme_keys ; ik ; ik = ik->next ){
+			bucket_remove( index->schemes, ( const gchar * ) ik->data, context );
+		}
+
+		g_hash_table_remove( index->any_mimetype, context );
+		for( ik = entry->mimetype_keys ; ik ; ik = ik->next ){
+			bucket_remove( index->mimetypes, ( const gchar * ) ik->data, context );
+		}
+
+		g_hash_table_remove( index->contexts, context );
+	}
+}
+
+/*
+ * returns the distinct positive conditions of the list
+ *
+ * is_any is set if the list is empty, or only has negative assertions,
+ * or has a positive '*' assertion: in all these cases, this dimension
+ * is not discriminant for the index
+ */
+static GSList *
+get_positive_keys( GSList *conditions, gboolean *is_any )
+{
+	GSList *keys, *ic;
+	const gchar *cond;
+	gchar *stripped;
+
+	keys = NULL;
+	*is_any = FALSE;
+
+	for( ic = conditions ; ic && !*is_any ; ic = ic->next ){
+		cond = ( const gchar * ) ic->data;
+		if( !cond || !strlen( cond )){
+			continue;
+		}
+		stripped = g_strstrip( g_strdup( cond ));
+		if( strlen( stripped ) && stripped[0] != '!' ){
+			if( !strcmp( stripped, "*" )){
+				*is_any = TRUE;
+
+			} else if( !fma_core_utils_slist_count( keys, stripped )){
+				keys = g_slist_prepend( keys, stripped );
+				stripped = NULL;
+			}
+		}
+		g_free( stripped );
+	}
+
+	if( !keys ){
+		*is_any = TRUE;
+	}
+
+	return( keys );
+}
+
+/*
+ * 'all' mimetypes, and 'allfiles' which depends of the regular status
+ * of the file, are not discriminant for the index
+ */
+static gboolean
+is_any_mimetype( const gchar *mimetype )
+{
+	return( fma_mime_type_get_class( mimetype ) != MIME_TYPE_CLASS_OTHER );
+}
+
+static void
+bucket_add( GHashTable *buckets, const gchar *key, FMAObject *context )
+{
+	GHashTable *set;
+
+	set = ( GHashTable * ) g_hash_table_lookup( buckets, key );
+	if( !set ){
+		set = set_new();
+		g_hash_table_insert( buckets, g_strdup( key ), set );
+	}
+	g_hash_table_add( set, context );
+}
+
+static void
+bucket_remove( GHashTable *buckets, const gchar *key, FMAObject *context )
+{
+	GHashTable *set;
+
+	set = ( GHashTable * ) g_hash_table_lookup( buckets, key );
+	if( set ){
+		g_hash_table_remove( set, context );
+		if( !g_hash_table_size( set )){
+			g_hash_table_remove( buckets, key );
+		}
+	}
+}
+
+static GHashTable *
+set_new( void )
+{
+	return( g_hash_table_new( g_direct_hash, g_direct_equal ));
+}
+
+/*
+ * fma_candidate_index_get_candidates:
+ * @index: this #FMACandidateIndex structure.
+ * @target: the current target.
+ * @selection: the current selection, as a list of #FMASelectedInfo objects.
+ *
+ * Returns: the set of #FMAIContext objects which may be candidate for
+ * the @target and the @selection, as a #GHashTable whose both keys and
+ * values are the indexed objects.
+ * The returned set should be g_hash_table_destroy() by the caller.
+ *
+ * Each object of the returned set still has to be checked against the
+ * full set of conditions with fma_icontext_is_candidate(), while objects
+ * which are not in the set can safely be ignored.
+ */
+GHashTable *
+fma_candidate_index_get_candidates( const FMACandidateIndex *index, guint target, GList *selection )
+{
+	static const gchar *thisfn = "fma_candidate_index_get_candidates";
+	GHashTable *candidates;
+	GSList *schemes, *ftypes, *is;
+	GSList *scheme_sets, *mimetype_sets;
+	GList *it;
+	GHashTableIter iter;
+	FMAObject *context;
+	IndexEntry *entry;
+	gchar *value;
+	gboolean ok;
+
+	g_return_val_if_fail( index != NULL, NULL );
+
+	/* distinct schemes and mimetypes of the selection
+	 */
+	schemes = NULL;
+	ftypes = NULL;
+
+	for( it = selection ; it ; it = it->next ){
+		value = fma_selected_info_get_uri_scheme( FMA_SELECTED_INFO( it->data ));
+		if( value && !fma_core_utils_slist_count( schemes, value )){
+			schemes = g_slist_prepend( schemes, value );
+		} else {
+			g_free( value );
+		}
+		/* do not have the mimetype be queried if no context needs it */
+		if( g_hash_table_size( index->any_mimetype ) < g_hash_table_size( index->contexts )){
+			value = fma_selected_info_get_mime_type( FMA_SELECTED_INFO( it->data ));
+			if( value && !fma_core_utils_slist_count( ftypes, value )){
+				ftypes = g_slist_prepend( ftypes, value );
+			} else {
+				g_free( value );
+			}
+		}
+	}
+
+	/* the scheme buckets are directly usable, while the mimetype sets
+	 * have to be computed as the union of all matching buckets
+	 * a missing bucket is recorded as an empty set
+	 */
+	scheme_sets = NULL;
+	for( is = schemes ; is ; is = is->next ){
+		scheme_sets = g_slist_prepend( scheme_sets, g_hash_table_lookup( index->schemes, is->data ));
+	}
+
+	mimetype_sets = NULL;
+	for( is = ftypes ; is ; is = is->next ){
+		mimetype_sets = g_slist_prepend( mimetype_sets, get_mimetype_set( index, ( const gchar * ) is->data ));
+	}
+
+	candidates = set_new();
+	g_hash_table_iter_init( &iter, index->contexts );
+
+	while( g_hash_table_iter_next( &iter, ( gpointer * ) &context, ( gpointer * ) &entry )){
+		ok = is_target_candidate( entry, target );
+
+		if( ok && !g_hash_table_contains( index->any_scheme, context )){
+			for( is = scheme_sets ; is && ok ; is = is->next ){
+				ok = ( is->data && g_hash_table_contains(( GHashTable * ) is->data, context ));
+			}
+		}
+
+		if( ok && !g_hash_table_contains( index->any_mimetype, context )){
+			for( is = mimetype_sets ; is && ok ; is = is->next ){
+				ok = g_hash_table_contains(( GHashTable * ) is->data, context );
+			}
+		}
+
+		if( ok ){
+			g_hash_table_add( candidates, context );
+		}
+	}
+
+	g_debug( "%s: target=%u, selection_count=%u, indexed=%u, candidates=%u",
+			thisfn, target, g_list_length( selection ),
+			g_hash_table_size( index->contexts ), g_hash_table_size( candidates ));
+
+	g_slist_free_full( mimetype_sets, ( GDestroyNotify ) g_hash_table_destroy );
+	g_slist_free( scheme_sets );
+	fma_core_utils_slist_free( ftypes );
+	fma_core_utils_slist_free( schemes );
+
+	return( candidates );
+}
+
+/*
+ * fma_candidate_index_get_attributes:
+ * @index: this #FMACandidateIndex structure.
+ *
+ * Returns: the union of the SELECTED_INFO_ATTR_xxx file attributes which
+ * are needed to evaluate the conditions of all the indexed contexts.
+ */
+guint
+fma_candidate_index_get_attributes( const FMACandidateIndex *index )
+{
+	guint attributes;
+	GHashTableIter iter;
+	IndexEntry *entry;
+
+	g_return_val_if_fail( index != NULL, SELECTED_INFO_ATTR_ALL );
+
+	attributes = 0;
+	g_hash_table_iter_init( &iter, index->contexts );
+
+	while( attributes != SELECTED_INFO_ATTR_ALL && g_hash_table_iter_next( &iter, NULL, ( gpointer * ) &entry )){
+		attributes |= entry->attributes;
+	}
+
+	return( attributes );
+}
+
+/*
+ * the set of contexts which have at least one positive mimetype condition
+ * the @ftype file mimetype is 'a sort of'
+ */
+static GHashTable *
+get_mimetype_set( const FMACandidateIndex *index, const gchar *ftype )
+{
+	GHashTable *set;
+	GHashTableIter iter, iset;
+	gchar *key;
+	GHashTable *bucket;
+	gpointer context;
+
+	set = set_new();
+	g_hash_table_iter_init( &iter, index->mimetypes );
+
+	while( g_hash_table_iter_next( &iter, ( gpointer * ) &key, ( gpointer * ) &bucket )){
+		if( fma_mime_type_is_a( ftype, key )){
+			g_hash_table_iter_init( &iset, bucket );
+			while( g_hash_table_iter_next( &iset, &context, NULL )){
+				g_hash_table_add( set, context );
+			}
+		}
+	}
+
+	return( set );
+}
+
+static gboolean
+is_target_candidate( const IndexEntry *entry, guint target )
+{
+	if( !entry->targets || target == ITEM_TARGET_ANY ){
+		return( TRUE );
+	}
+
+	return(( entry->targets & TARGET_BIT( target )) != 0 );
+}
+
+static void
+entry_free( IndexEntry *entry )
+{
+	fma_core_utils_slist_free( entry->scheme_keys );
+	fma_core_utils_slist_free( entry->mimetype_keys );
+	g_free( entry );
+}
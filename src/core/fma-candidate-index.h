@@ -0,0 +1,75 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_CANDIDATE_INDEX_H__
+#define __CORE_FMA_CANDIDATE_INDEX_H__
+
+/* @title: FMACandidateIndex
+ * @short_description: The FMACandidateIndex Structure Definition
+ * @include: core/fma-candidate-index.h
+ *
+ * The FMACandidateIndex is a pre-compiled view of the conditions which
+ * are the cheapest to evaluate against a selection, i.e. the target,
+ * the schemes and the mimetypes of each #FMAIContext object of a tree
+ * of items.
+ *
+ * Contexts are bucketed by these conditions when the index is built,
+ * so that, at popup time, only the contexts which are found in the
+ * buckets matching the current selection have to go through the full
+ * fma_icontext_is_candidate() evaluation.
+ *
+ * The index is conservative: it never discards a context which would
+ * have been candidate, while it may keep a context which will be later
+ * rejected by fma_icontext_is_candidate(). In particular, negative
+ * assertions are not taken into account here.
+ *
+ * The index does not take a reference on the indexed objects: it is up
+ * to the caller to make sure that the indexed tree stays alive as long
+ * as the index is used, and to remove the items from the index before
+ * releasing them.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _FMACandidateIndex FMACandidateIndex;
+
+FMACandidateIndex *fma_candidate_index_new           ( void );
+void               fma_candidate_index_free          ( FMACandidateIndex *index );
+
+void               fma_candidate_index_add_items     ( FMACandidateIndex *index, GList *tree );
+void               fma_candidate_index_remove_items  ( FMACandidateIndex *index, GList *tree );
+
+GHashTable        *fma_candidate_index_get_candidates( const FMACandidateIndex *index, guint target, GList *selection );
+guint              fma_candidate_index_get_attributes( const FMACandidateIndex *index );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_CANDIDATE_INDEX_H__ */
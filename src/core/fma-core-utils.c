@@ -34,6 +34,7 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <gio/gio.h>
 #include <glib/gstdio.h>
@@ -1202,6 +1203,27 @@ fma_core_utils_file_load_from_uri( const gchar *uri, gsize *length )
 	return( data );
 }
 
+/**
+ * fma_core_utils_get_processors_count:
+ *
+ * Returns: the count of available processors, which is at least one.
+ *
+ * Since: 3.5
+ */
+guint
+fma_core_utils_get_processors_count( void )
+{
+	glong count;
+
+#if GLIB_CHECK_VERSION( 2,36, 0 )
+	count = g_get_num_processors();
+#else
+	count = sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+
+	return( count > 0 ? ( guint ) count : 1 );
+}
+
 /**
  * fma_core_utils_print_version:
  *
@@ -0,0 +1,479 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <glib/gi18n.h>
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "fma-display-output.h"
+
+#define DISPLAY_OUTPUT_RING_SIZE		65536		/* bytes kept in memory for each stream */
+#define DISPLAY_OUTPUT_UPDATE_DELAY		250			/* msec between two updates of the dialog */
+
+/* one captured stream
+ */
+typedef struct {
+	FMADisplayOutput *output;
+	GIOChannel       *channel;
+	gchar            *ring;
+	gsize             start;			/* index of the oldest byte in the ring */
+	gsize             len;				/* count of bytes in the ring */
+	gint              spill_fd;			/* -1 until the ring overflows */
+	gchar            *spill_path;
+}
+	Stream;
+
+enum {
+	STREAM_STDOUT = 0,
+	STREAM_STDERR,
+	STREAM_N
+};
+
+struct _FMADisplayOutput {
+	gchar     *command;
+	Stream     streams[STREAM_N];
+	gboolean   exited;
+	gint       status;
+	GtkWidget *dialog;
+	guint      update_id;
+	guint      refcount;
+};
+
+static void      output_unref( FMADisplayOutput *output );
+static void      output_schedule_update( FMADisplayOutput *output );
+static gboolean  on_update_timeout( FMADisplayOutput *output );
+static void      on_dialog_destroy( GtkWidget *dialog, FMADisplayOutput *output );
+static void      update_dialog( FMADisplayOutput *output );
+static gboolean  stream_open( Stream *stream, FMADisplayOutput *output, gint fd );
+static gboolean  on_stream_readable( GIOChannel *channel, GIOCondition condition, Stream *stream );
+static void      stream_append( Stream *stream, const gchar *buf, gsize count );
+static void      stream_spill( Stream *stream, const gchar *buf, gsize count );
+static gchar    *stream_get_display( const Stream *stream );
+static gchar    *make_valid_utf8( const gchar *str, gsize len );
+static gboolean  write_all( gint fd, const gchar *buf, gsize count );
+
+/*
+ * fma_display_output_new:
+ * @command: the run command.
+ * @fd_stdout: the read end of the standard output pipe of the child.
+ * @fd_stderr: the read end of the standard error pipe of the child.
+ *
+ * Starts capturing the outputs of the child, and displays the dialog.
+ * The file descriptors are closed when the streams have been drained.
+ *
+ * Returns: a new #FMADisplayOutput structure, which will release itself
+ * once fma_display_output_child_exited() has been called, the streams
+ * have been closed and the dialog has been dismissed. The temporary
+ * files the overflowing outputs have been spilled to are then removed.
+ */
+FMADisplayOutput *
+fma_display_output_new( const gchar *command, gint fd_stdout, gint fd_stderr )
+{
+	static const gchar *thisfn = "fma_display_output_new";
+	FMADisplayOutput *output;
+
+	g_debug( "%s: command=%s, fd_stdout=%d, fd_stderr=%d", thisfn, command, fd_stdout, fd_stderr );
+
+	output = g_new0( FMADisplayOutput, 1 );
+	output->command = g_strdup( command );
+	output->exited = FALSE;
+	output->status = 0;
+	output->update_id = 0;
+
+	/* one reference is released when the child exits, another one when
+	 * the dialog is destroyed
+	 */
+	output->refcount = 2;
+
+	if( stream_open( &output->streams[STREAM_STDOUT], output, fd_stdout )){
+		output->refcount += 1;
+	}
+	if( stream_open( &output->streams[STREAM_STDERR], output, fd_stderr )){
+		output->refcount += 1;
+	}
+
+	output->dialog = gtk_message_dialog_new_with_markup(
+			NULL, 0, GTK_MESSAGE_INFO, GTK_BUTTONS_OK, "<b>%s</b>", _( "Output of the run command" ));
+	g_object_set( G_OBJECT( output->dialog ) , "title", PACKAGE_NAME, NULL );
+
+	g_signal_connect( output->dialog, "response", G_CALLBACK( gtk_widget_destroy ), NULL );
+	g_signal_connect( output->dialog, "destroy", G_CALLBACK( on_dialog_destroy ), output );
+
+	update_dialog( output );
+	gtk_widget_show( output->dialog );
+
+	return( output );
+}
+
+/*
+ * fma_display_output_child_exited:
+ * @output: this #FMADisplayOutput structure.
+ * @status: the exit status of the child.
+ *
+ * Records the end of the child.
+ * The structure may be released on return, and must no more be used by
+ * the caller.
+ */
+void
+fma_display_output_child_exited( FMADisplayOutput *output, gint status )
+{
+	g_return_if_fail( output );
+
+	output->exited = TRUE;
+	output->status = status;
+
+	output_schedule_update( output );
+	output_unref( output );
+}
+
+static void
+output_unref( FMADisplayOutput *output )
+{
+	static const gchar *thisfn = "fma_display_output_unref";
+	guint i;
+
+	output->refcount -= 1;
+
+	if( !output->refcount ){
+		g_debug( "%s: output=%p", thisfn, ( void * ) output );
+
+		if( output->update_id ){
+			g_source_remove( output->update_id );
+		}
+
+		for( i = 0 ; i < STREAM_N ; ++i ){
+			if( output->streams[i].spill_fd >= 0 ){
+				close( output->streams[i].spill_fd );
+			}
+			if( output->streams[i].spill_path && strlen( output->streams[i].spill_path )){
+				g_unlink( output->streams[i].spill_path );
+			}
+			g_free( output->streams[i].spill_path );
+			g_free( output->streams[i].ring );
+		}
+
+		g_free( output->command );
+		g_free( output );
+	}
+}
+
+static void
+output_schedule_update( FMADisplayOutput *output )
+{
+	if( output->dialog && !output->update_id ){
+		output->update_id = g_timeout_add( DISPLAY_OUTPUT_UPDATE_DELAY, ( GSourceFunc ) on_update_timeout, output );
+	}
+}
+
+static gboolean
+on_update_timeout( FMADisplayOutput *output )
+{
+	output->update_id = 0;
+
+	if( output->dialog ){
+		update_dialog( output );
+	}
+
+	return( FALSE );
+}
+
+static void
+on_dialog_destroy( GtkWidget *dialog, FMADisplayOutput *output )
+{
+	output->dialog = NULL;
+
+	if( output->update_id ){
+		g_source_remove( output->update_id );
+		output->update_id = 0;
+	}
+
+	/* streams keep on being drained until the child closes them
+	 */
+	output_unref( output );
+}
+
+static void
+update_dialog( FMADisplayOutput *output )
+{
+	gchar *command, *std_output, *std_error, *status;
+
+	command = g_markup_escape_text( output->command, -1 );
+	std_output = stream_get_display( &output->streams[STREAM_STDOUT] );
+	std_error = stream_get_display( &output->streams[STREAM_STDERR] );
+
+	if( !output->exited ){
+		status = g_strdup( _( "Running…" ));
+
+	} else if( WIFEXITED( output->status )){
+		status = g_strdup_printf( _( "Exit status: %d" ), WEXITSTATUS( output->status ));
+
+	} else {
+		status = g_strdup( _( "Terminated abnormally" ));
+	}
+
+	gtk_message_dialog_format_secondary_markup( GTK_MESSAGE_DIALOG( output->dialog ),
+			"<b>%s</b>\n%s\n\n<b>%s</b>\n%s\n\n<b>%s</b>\n%s\n\n<i>%s</i>",
+					_( "Run command:" ), command,
+					_( "Standard output:" ), std_output,
+					_( "Standard error:" ), std_error,
+					status );
+
+	g_free( status );
+	g_free( std_error );
+	g_free( std_output );
+	g_free( command );
+}
+
+/*
+ * returns TRUE if the stream is actually captured
+ */
+static gboolean
+stream_open( Stream *stream, FMADisplayOutput *output, gint fd )
+{
+	stream->output = output;
+	stream->channel = NULL;
+	stream->ring = g_new( gchar, DISPLAY_OUTPUT_RING_SIZE );
+	stream->start = 0;
+	stream->len = 0;
+	stream->spill_fd = -1;
+	stream->spill_path = NULL;
+
+	if( fd <= 0 ){
+		return( FALSE );
+	}
+
+	stream->channel = g_io_channel_unix_new( fd );
+	g_io_channel_set_close_on_unref( stream->channel, TRUE );
+	g_io_channel_set_encoding( stream->channel, NULL, NULL );
+	g_io_channel_set_buffered( stream->channel, FALSE );
+	g_io_channel_set_flags( stream->channel, G_IO_FLAG_NONBLOCK, NULL );
+
+	g_io_add_watch( stream->channel, G_IO_IN | G_IO_HUP | G_IO_ERR, ( GIOFunc ) on_stream_readable, stream );
+
+	return( TRUE );
+}
+
+static gboolean
+on_stream_readable( GIOChannel *channel, GIOCondition condition, Stream *stream )
+{
+	static const gchar *thisfn = "fma_display_output_on_stream_readable";
+	gchar buf[4096];
+	gsize count;
+	GIOStatus status;
+	GError *error;
+
+	error = NULL;
+	count = 0;
+	status = g_io_channel_read_chars( channel, buf, sizeof( buf ), &count, &error );
+
+	if( count ){
+		stream_append( stream, buf, count );
+		output_schedule_update( stream->output );
+	}
+
+	if( status == G_IO_STATUS_NORMAL || status == G_IO_STATUS_AGAIN ){
+		return( TRUE );
+	}
+
+	if( error ){
+		g_warning( "%s: g_io_channel_read_chars: %s", thisfn, error->message );
+		g_error_free( error );
+	}
+
+	g_io_channel_unref( stream->channel );
+	stream->channel = NULL;
+
+	output_schedule_update( stream->output );
+	output_unref( stream->output );
+
+	return( FALSE );
+}
+
+/*
+ * keeps the last DISPLAY_OUTPUT_RING_SIZE bytes in memory, spilling the
+ * whole stream to a temporary file as soon as the ring overflows
+ */
+static void
+stream_append( Stream *stream, const gchar *buf, gsize count )
+{
+	gsize pos, first;
+
+	if( stream->spill_fd >= 0 || stream->len+count > DISPLAY_OUTPUT_RING_SIZE ){
+		stream_spill( stream, buf, count );
+	}
+
+	if( count >= DISPLAY_OUTPUT_RING_SIZE ){
+		memcpy( stream->ring, buf+count-DISPLAY_OUTPUT_RING_SIZE, DISPLAY_OUTPUT_RING_SIZE );
+		stream->start = 0;
+		stream->len = DISPLAY_OUTPUT_RING_SIZE;
+
+	} else {
+		pos = ( stream->start+stream->len ) % DISPLAY_OUTPUT_RING_SIZE;
+		first = MIN( count, DISPLAY_OUTPUT_RING_SIZE-pos );
+		memcpy( stream->ring+pos, buf, first );
+		memcpy( stream->ring, buf+first, count-first );
+
+		stream->len += count;
+		if( stream->len > DISPLAY_OUTPUT_RING_SIZE ){
+			stream->start = ( stream->start+stream->len-DISPLAY_OUTPUT_RING_SIZE ) % DISPLAY_OUTPUT_RING_SIZE;
+			stream->len = DISPLAY_OUTPUT_RING_SIZE;
+		}
+	}
+}
+
+/*
+ * on first overflow, the ring still holds the whole stream, which is
+ * written first to the new temporary file
+ */
+static void
+stream_spill( Stream *stream, const gchar *buf, gsize count )
+{
+	static const gchar *thisfn = "fma_display_output_stream_spill";
+	GError *error;
+	gsize first;
+
+	if( stream->spill_fd < 0 ){
+		if( stream->spill_path ){
+			return;						/* a previous error */
+		}
+
+		error = NULL;
+		stream->spill_fd = g_file_open_tmp( "fma-output-XXXXXX", &stream->spill_path, &error );
+
+		if( stream->spill_fd < 0 ){
+			g_warning( "%s: g_file_open_tmp: %s", thisfn, error->message );
+			g_error_free( error );
+			stream->spill_path = g_strdup( "" );
+			return;
+		}
+
+		first = MIN( stream->len, DISPLAY_OUTPUT_RING_SIZE-stream->start );
+		write_all( stream->spill_fd, stream->ring+stream->start, first );
+		write_all( stream->spill_fd, stream->ring, stream->len-first );
+	}
+
+	if( !write_all( stream->spill_fd, buf, count )){
+		g_warning( "%s: %s: %s", thisfn, stream->spill_path, g_strerror( errno ));
+	}
+}
+
+/*
+ * returns the content of the ring as an escaped UTF-8 string
+ */
+static gchar *
+stream_get_display( const Stream *stream )
+{
+	gchar *raw, *utf8, *escaped, *display;
+	gchar *note, *escaped_note;
+	gsize first;
+
+	raw = g_new( gchar, stream->len+1 );
+	first = MIN( stream->len, DISPLAY_OUTPUT_RING_SIZE-stream->start );
+	memcpy( raw, stream->ring+stream->start, first );
+	memcpy( raw+first, stream->ring, stream->len-first );
+	raw[stream->len] = '\0';
+
+	/* the start of the ring may cut a multi-bytes character
+	 */
+	utf8 = g_get_charset( NULL ) ? NULL : g_locale_to_utf8( raw, stream->len, NULL, NULL, NULL );
+	if( !utf8 ){
+		utf8 = make_valid_utf8( raw, stream->len );
+	}
+
+	escaped = g_markup_escape_text( utf8, -1 );
+
+	if( stream->spill_path && strlen( stream->spill_path )){
+		/* i18n: the placeholder is the path to a temporary file */
+		note = g_strdup_printf( _( "(output truncated, see the full content in %s)" ), stream->spill_path );
+		escaped_note = g_markup_escape_text( note, -1 );
+		display = g_strdup_printf( "%s\n<i>%s</i>", escaped, escaped_note );
+		g_free( escaped_note );
+		g_free( note );
+
+	} else {
+		display = g_strdup( escaped );
+	}
+
+	g_free( escaped );
+	g_free( utf8 );
+	g_free( raw );
+
+	return( display );
+}
+
+/*
+ * invalid sequences are replaced with a question mark
+ */
+static gchar *
+make_valid_utf8( const gchar *str, gsize len )
+{
+	GString *valid;
+	const gchar *end;
+
+	valid = g_string_sized_new( len );
+
+	while( len && !g_utf8_validate( str, len, &end )){
+		valid = g_string_append_len( valid, str, end-str );
+		valid = g_string_append_c( valid, '?' );
+		len -= end-str+1;
+		str = end+1;
+	}
+
+	valid = g_string_append_len( valid, str, len );
+
+	return( g_string_free( valid, FALSE ));
+}
+
+static gboolean
+write_all( gint fd, const gchar *buf, gsize count )
+{
+	gssize written;
+
+	while( count ){
+		written = write( fd, buf, count );
+		if( written < 0 ){
+			if( errno == EINTR ){
+				continue;
+			}
+			return( FALSE );
+		}
+		buf += written;
+		count -= written;
+	}
+
+	return( TRUE );
+}
@@ -0,0 +1,62 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_DISPLAY_OUTPUT_H__
+#define __CORE_FMA_DISPLAY_OUTPUT_H__
+
+/* @title: FMADisplayOutput
+ * @short_description: The FMADisplayOutput Structure Definition
+ * @include: core/fma-display-output.h
+ *
+ * The FMADisplayOutput captures the standard output and error streams
+ * of a command run in 'DisplayOutput' execution mode, and displays them
+ * in a non-modal dialog which is updated while the command runs.
+ *
+ * The pipes are drained as soon as data is available, so that the
+ * child never stalls on a full pipe. The last bytes of each stream are
+ * kept in a bounded ring buffer; when a stream overflows this buffer,
+ * its whole content is spilled to a temporary file whose path is then
+ * displayed.
+ *
+ * The structure releases itself once both streams have been closed,
+ * the child has exited and the dialog has been dismissed.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _FMADisplayOutput FMADisplayOutput;
+
+FMADisplayOutput *fma_display_output_new         ( const gchar *command, gint fd_stdout, gint fd_stderr );
+void              fma_display_output_child_exited( FMADisplayOutput *output, gint status );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_DISPLAY_OUTPUT_H__ */
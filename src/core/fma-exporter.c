@@ -388,6 +388,88 @@ fma_exporter_to_file( const FMAPivot *pivot,
 	return( export_uri );
 }
 
+/*
+ * fma_exporter_to_stream:
+ * @pivot: the #FMAPivot pivot for the running application.
+ * @item: a #FMAObjectItem-derived object.
+ * @format: the target format identifier.
+ * @stream: the #GOutputStream to write to.
+ * @messages: a pointer to a #GSList list of strings; the provider
+ *  may append messages to this list, but shouldn't reinitialize it.
+ *
+ * Exports the specified @item in the required @format, appending it to
+ * the @stream.
+ *
+ * When the exporter does not implement the to_stream() method, the
+ * buffer returned by its to_buffer() method is written instead.
+ *
+ * Returns: %TRUE if the @item has been successfully written, %FALSE else.
+ */
+gboolean
+fma_exporter_to_stream( const FMAPivot *pivot,
+		const FMAObjectItem *item, const gchar *format, GOutputStream *stream, GSList **messages )
+{
+	static const gchar *thisfn = "fma_exporter_to_stream";
+	gboolean ok;
+	FMAIExporterStreamParms parms;
+	FMAIExporter *exporter;
+	gchar *buffer;
+	gchar *msg;
+	GError *error;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), FALSE );
+	g_return_val_if_fail( FMA_IS_OBJECT_ITEM( item ), FALSE );
+	g_return_val_if_fail( G_IS_OUTPUT_STREAM( stream ), FALSE );
+
+	ok = FALSE;
+
+	g_debug( "%s: pivot=%p, item=%p (%s), format=%s, stream=%p, messages=%p",
+			thisfn,
+			( void * ) pivot,
+			( void * ) item, G_OBJECT_TYPE_NAME( item ),
+			format,
+			( void * ) stream,
+			( void * ) messages );
+
+	exporter = fma_exporter_find_for_format( pivot, format );
+
+	if( exporter && FMA_IEXPORTER_GET_INTERFACE( exporter )->to_stream ){
+		parms.version = 1;
+		parms.exported = ( FMAObjectItem * ) item;
+		parms.format = g_strdup( format );
+		parms.stream = stream;
+		parms.messages = messages ? *messages : NULL;
+
+		ok = ( FMA_IEXPORTER_GET_INTERFACE( exporter )->to_stream( exporter, &parms ) == FMA_IEXPORTER_CODE_OK );
+
+		if( messages ){
+			*messages = parms.messages;
+		}
+		g_free( parms.format );
+
+	} else {
+		buffer = fma_exporter_to_buffer( pivot, item, format, messages );
+
+		if( buffer ){
+			error = NULL;
+			ok = g_output_stream_write_all( stream, buffer, strlen( buffer ), NULL, NULL, &error );
+			if( !ok ){
+				msg = g_strdup_printf( "%s: %s", thisfn, error->message );
+				g_warning( "%s", msg );
+				if( messages ){
+					*messages = g_slist_append( *messages, msg );
+				} else {
+					g_free( msg );
+				}
+				g_error_free( error );
+			}
+			g_free( buffer );
+		}
+	}
+
+	return( ok );
+}
+
 static gchar *
 exporter_get_name( const FMAIExporter *exporter )
 {
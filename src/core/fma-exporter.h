@@ -61,6 +61,12 @@ gchar        *fma_exporter_to_file        ( const FMAPivot *pivot,
                                             const gchar *format,
                                             GSList **messages );
 
+gboolean      fma_exporter_to_stream      ( const FMAPivot *pivot,
+                                            const FMAObjectItem *item,
+                                            const gchar *format,
+                                            GOutputStream *stream,
+                                            GSList **messages );
+
 FMAIExporter *fma_exporter_find_for_format( const FMAPivot *pivot,
 		                                    const gchar *format );
 
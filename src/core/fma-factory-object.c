@@ -52,6 +52,7 @@ enum {
 	DATA_DEF_ITER_SET_DEFAULTS,
 	DATA_DEF_ITER_IS_VALID,
 	DATA_DEF_ITER_READ_ITEM,
+	DATA_DEF_ITER_ALL,
 };
 
 /* while iterating on read item
@@ -89,6 +90,58 @@ typedef struct {
 }
 	NafoDefaultIter;
 
+/* the layout of the elementary data of a class:
+ * each FMADataDef name is resolved to a fixed slot index once per class
+ */
+typedef struct {
+	GHashTable  *slots;						/* name -> GUINT_TO_POINTER( slot+1 ) */
+	FMADataDef **defs;						/* slot -> FMADataDef */
+	guint        count;
+}
+	FactoryLayout;
+
+/* the FMADataBoxed attached to an object, as a dense array indexed by
+ * the slots of the class layout
+ * the FMA_IFACTORY_OBJECT_PROP_DATA list is kept alongside in order to
+ * preserve the attachment order when iterating
+ */
+typedef struct {
+	const FactoryLayout *layout;
+	FMADataBoxed       **boxed;
+}
+	FactorySlots;
+
+#define FMA_IFACTORY_OBJECT_PROP_SLOTS	"fma-ifactory-object-prop-slots"
+
+/* the result of the last comparison of each slot of an object with
+ * the same slot of its origin, along with the stamps of the compared
+ * FMADataBoxed: a slot only has to be compared again when one of its
+ * boxed has been replaced or set since
+ */
+typedef struct {
+	const FMADataBoxed *a_boxed;
+	guint               a_stamp;
+	const FMADataBoxed *b_boxed;
+	guint               b_stamp;
+	gboolean            known;
+	gboolean            differs;
+}
+	CompareSlot;
+
+typedef struct {
+	const FMAIFactoryObject *origin;
+	const FactoryLayout     *layout;
+	CompareSlot             *slots;
+	guint                    diff_count;
+}
+	CompareCache;
+
+#define FMA_IFACTORY_OBJECT_PROP_COMPARE	"fma-ifactory-object-prop-compare"
+
+G_LOCK_DEFINE_STATIC( st_layouts );
+
+static GHashTable                *st_layouts = NULL;	/* GType -> FactoryLayout */
+
 extern gboolean                   ifactory_object_initialized;
 extern gboolean                   ifactory_object_finalized;
 
@@ -108,6 +161,16 @@ static guint         v_write_start( FMAIFactoryObject *serializable, const FMAIF
 static guint         v_write_done( FMAIFactoryObject *serializable, const FMAIFactoryProvider *reader, void *reader_data, GSList **messages );
 
 static void          attach_boxed_to_object( FMAIFactoryObject *object, FMADataBoxed *boxed );
+static void          detach_boxed_from_slots( const FMAIFactoryObject *object, FMADataBoxed *boxed );
+static FactorySlots *get_slots( const FMAIFactoryObject *object );
+static const FactoryLayout *get_layout( const FMAIFactoryObject *object );
+static gboolean      build_layout_iter( FMADataDef *def, FactoryLayout *layout );
+static gint          get_slot( const FactoryLayout *layout, const gchar *name );
+static void          free_slots( FactorySlots *slots );
+static gboolean      are_equal_by_slots( const FMAIFactoryObject *a, const FMAIFactoryObject *b );
+static gboolean      are_equal_by_lists( const FMAIFactoryObject *a, const FMAIFactoryObject *b );
+static gboolean      compare_slot( const FMAIFactoryObject *a, CompareSlot *cmp, const FMADataDef *def, const FMADataBoxed *a_boxed, const FMADataBoxed *b_boxed );
+static void          free_compare_cache( CompareCache *cache );
 static void          free_data_boxed_list( FMAIFactoryObject *object );
 static void          iter_on_data_defs( const FMADataGroup *idgroups, guint mode, FMADataDefIterFunc pfn, void *user_data );
 
@@ -166,29 +229,69 @@ define_class_properties_iter( const FMADataDef *def, GObjectClass *class )
 FMADataDef *
 fma_factory_object_get_data_def( const FMAIFactoryObject *object, const gchar *name )
 {
-	FMADataDef *def;
+	const FactoryLayout *layout;
+	gint slot;
 
 	g_return_val_if_fail( FMA_IS_IFACTORY_OBJECT( object ), NULL );
 
-	def = NULL;
+	layout = get_layout( object );
+	slot = get_slot( layout, name );
 
-	FMADataGroup *groups = v_get_groups( object );
-	while( groups->group ){
+	return( slot >= 0 ? layout->defs[slot] : NULL );
+}
 
-		FMADataDef *def = groups->def;
-		if( def ){
-			while( def->name ){
+/*
+ * fma_factory_object_get_data_boxed:
+ * @object: this #FMAIFactoryObject object.
+ * @name: the name of the elementary data we are searching for.
+ *
+ * Returns: The #FMADataBoxed object which contains the specified data,
+ * or %NULL.
+ *
+ * All the data attached to an object are defined by its class, and so
+ * have a slot in the class layout: a name without slot (e.g. an action
+ * only data searched for in a profile or a menu) is just not there.
+ */
+FMADataBoxed *
+fma_factory_object_get_data_boxed( const FMAIFactoryObject *object, const gchar *name )
+{
+	FactorySlots *slots;
+	gint slot;
 
-				if( !strcmp( def->name, name )){
-					return( def );
-				}
-				def++;
-			}
-		}
-		groups++;
-	}
+	g_return_val_if_fail( FMA_IS_IFACTORY_OBJECT( object ), NULL );
+
+	slots = get_slots( object );
+	slot = get_slot( slots->layout, name );
+
+	return( slot >= 0 ? slots->boxed[slot] : NULL );
+}
+
+/*
+ * fma_factory_object_get_data_boxed_v:
+ * @object: this #FMAIFactoryObject object.
+ * @names: a %NULL-terminated array of elementary data names.
+ * @boxed: an array of at least as many elements as @names.
+ *
+ * Fills the @boxed array with the #FMADataBoxed which contain the
+ * specified data, or %NULL.
+ */
+void
+fma_factory_object_get_data_boxed_v( const FMAIFactoryObject *object, const gchar * const *names, FMADataBoxed **boxed )
+{
+	FactorySlots *slots;
+	gint slot;
+	guint i;
 
-	return( def );
+	g_return_if_fail( FMA_IS_IFACTORY_OBJECT( object ));
+	g_return_if_fail( names != NULL );
+	g_return_if_fail( boxed != NULL );
+
+	slots = get_slots( object );
+
+	for( i = 0 ; names[i] ; ++i ){
+		slot = get_slot( slots->layout, names[i] );
+		boxed[i] = ( slot >= 0 ) ? slots->boxed[slot] : NULL;
+	}
 }
 
 /*
@@ -337,6 +440,7 @@ fma_factory_object_move_boxed( FMAIFactoryObject *target, const FMAIFactoryObjec
 	if( g_list_find( src_list, boxed )){
 		src_list = g_list_remove( src_list, boxed );
 		g_object_set_data( G_OBJECT( source ), FMA_IFACTORY_OBJECT_PROP_DATA, src_list );
+		detach_boxed_from_slots( source, boxed );
 
 		attach_boxed_to_object( target, boxed );
 
@@ -384,7 +488,9 @@ fma_factory_object_copy( FMAIFactoryObject *target, const FMAIFactoryObject *sou
 		def = fma_data_boxed_get_data_def( boxed );
 		if( def->copyable ){
 			dest_list = g_list_remove_link( dest_list, idest );
+			detach_boxed_from_slots( target, boxed );
 			g_object_unref( idest->data );
+			g_list_free_1( idest );
 		}
 		idest = inext;
 	}
@@ -421,6 +527,10 @@ fma_factory_object_copy( FMAIFactoryObject *target, const FMAIFactoryObject *sou
  * @a: the first (original) #FMAIFactoryObject instance.
  * @b: the second (current) #FMAIFactoryObject isntance.
  *
+ * When @a and @b share the same layout, the result of the previous
+ * comparison is kept with @b, and only the elementary data which have
+ * been set or replaced since are compared again.
+ *
  * Returns: %TRUE if @a is equal to @b, %FALSE else.
  */
 gboolean
@@ -428,15 +538,125 @@ fma_factory_object_are_equal( const FMAIFactoryObject *a, const FMAIFactoryObjec
 {
 	static const gchar *thisfn = "fma_factory_object_are_equal";
 	gboolean are_equal;
-	GList *a_list, *b_list, *ia, *ib;
 
-	are_equal = FALSE;
+	g_debug( "%s: a=%p, b=%p", thisfn, ( void * ) a, ( void * ) b );
+
+	if( G_OBJECT_TYPE( a ) == G_OBJECT_TYPE( b )){
+		are_equal = are_equal_by_slots( a, b );
+
+	} else {
+		are_equal = are_equal_by_lists( a, b );
+	}
+
+	are_equal &= v_are_equal( a, b );
+
+	return( are_equal );
+}
+
+/*
+ * both objects share the same layout: walk through the slots, only
+ * comparing again those whose boxed have changed since last time
+ */
+static gboolean
+are_equal_by_slots( const FMAIFactoryObject *a, const FMAIFactoryObject *b )
+{
+	FactorySlots *a_slots, *b_slots;
+	CompareCache *cache;
+	CompareSlot *cmp;
+	gboolean was_different, differs;
+	guint i;
+
+	a_slots = get_slots( a );
+	b_slots = get_slots( b );
+
+	cache = ( CompareCache * ) g_object_get_data( G_OBJECT( b ), FMA_IFACTORY_OBJECT_PROP_COMPARE );
+
+	if( !cache || cache->origin != a || cache->layout != b_slots->layout ){
+		cache = g_new0( CompareCache, 1 );
+		cache->origin = a;
+		cache->layout = b_slots->layout;
+		cache->slots = g_new0( CompareSlot, MAX( 1, cache->layout->count ));
+		g_object_set_data_full( G_OBJECT( b ), FMA_IFACTORY_OBJECT_PROP_COMPARE, cache, ( GDestroyNotify ) free_compare_cache );
+	}
+
+	for( i = 0 ; i < cache->layout->count ; ++i ){
+		if( cache->layout->defs[i]->comparable ){
+			cmp = &cache->slots[i];
+			was_different = cmp->known && cmp->differs;
+			differs = compare_slot( a, cmp, cache->layout->defs[i], a_slots->boxed[i], b_slots->boxed[i] );
+
+			if( differs != was_different ){
+				if( differs ){
+					cache->diff_count += 1;
+				} else {
+					cache->diff_count -= 1;
+				}
+			}
+		}
+	}
+
+	return( cache->diff_count == 0 );
+}
+
+/*
+ * returns %TRUE if the slot differs between the two objects, only
+ * comparing the boxed if they are not those of the last comparison
+ */
+static gboolean
+compare_slot( const FMAIFactoryObject *a, CompareSlot *cmp, const FMADataDef *def, const FMADataBoxed *a_boxed, const FMADataBoxed *b_boxed )
+{
+	static const gchar *thisfn = "fma_factory_object_compare_slot";
+	guint a_stamp, b_stamp;
+
+	a_stamp = a_boxed ? fma_boxed_get_stamp( FMA_BOXED( a_boxed )) : 0;
+	b_stamp = b_boxed ? fma_boxed_get_stamp( FMA_BOXED( b_boxed )) : 0;
+
+	if( !cmp->known ||
+			cmp->a_boxed != a_boxed || cmp->a_stamp != a_stamp ||
+			cmp->b_boxed != b_boxed || cmp->b_stamp != b_stamp ){
+
+		if( a_boxed && b_boxed ){
+			cmp->differs = !fma_boxed_are_equal( FMA_BOXED( a_boxed ), FMA_BOXED( b_boxed ));
+			if( cmp->differs ){
+				g_debug( "%s: %s not equal as %s different", thisfn, G_OBJECT_TYPE_NAME( a ), def->name );
+			}
+
+		} else if( a_boxed ){
+			cmp->differs = TRUE;
+			g_debug( "%s: %s not equal as %s has disappeared", thisfn, G_OBJECT_TYPE_NAME( a ), def->name );
+
+		} else if( b_boxed ){
+			cmp->differs = TRUE;
+			g_debug( "%s: %s not equal as %s was not set", thisfn, G_OBJECT_TYPE_NAME( a ), def->name );
+
+		} else {
+			cmp->differs = FALSE;
+		}
+
+		cmp->a_boxed = a_boxed;
+		cmp->a_stamp = a_stamp;
+		cmp->b_boxed = b_boxed;
+		cmp->b_stamp = b_stamp;
+		cmp->known = TRUE;
+	}
+
+	return( cmp->differs );
+}
+
+/*
+ * the objects do not share the same layout: compare their whole
+ * lists of elementary data
+ */
+static gboolean
+are_equal_by_lists( const FMAIFactoryObject *a, const FMAIFactoryObject *b )
+{
+	static const gchar *thisfn = "fma_factory_object_are_equal_by_lists";
+	gboolean are_equal;
+	GList *a_list, *b_list, *ia, *ib;
 
 	a_list = g_object_get_data( G_OBJECT( a ), FMA_IFACTORY_OBJECT_PROP_DATA );
 	b_list = g_object_get_data( G_OBJECT( b ), FMA_IFACTORY_OBJECT_PROP_DATA );
 
-	g_debug( "%s: a=%p, b=%p", thisfn, ( void * ) a, ( void * ) b );
-
 	are_equal = TRUE;
 	for( ia = a_list ; ia && are_equal ; ia = ia->next ){
 
@@ -472,11 +692,16 @@ fma_factory_object_are_equal( const FMAIFactoryObject *a, const FMAIFactoryObjec
 		}
 	}
 
-	are_equal &= v_are_equal( a, b );
-
 	return( are_equal );
 }
 
+static void
+free_compare_cache( CompareCache *cache )
+{
+	g_free( cache->slots );
+	g_free( cache );
+}
+
 /*
  * fma_factory_object_is_valid:
  * @object: the #FMAIFactoryObject instance whose validity is to be checked.
@@ -942,9 +1167,31 @@ v_write_done( FMAIFactoryObject *serializable, const FMAIFactoryProvider *writer
 static void
 attach_boxed_to_object( FMAIFactoryObject *object, FMADataBoxed *boxed )
 {
+	FactorySlots *slots;
+	gint slot;
+
 	GList *list = g_object_get_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA );
 	list = g_list_prepend( list, boxed );
 	g_object_set_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA, list );
+
+	slots = get_slots( object );
+	slot = get_slot( slots->layout, fma_data_boxed_get_data_def( boxed )->name );
+	if( slot >= 0 ){
+		slots->boxed[slot] = boxed;
+	}
+}
+
+static void
+detach_boxed_from_slots( const FMAIFactoryObject *object, FMADataBoxed *boxed )
+{
+	FactorySlots *slots;
+	gint slot;
+
+	slots = get_slots( object );
+	slot = get_slot( slots->layout, fma_data_boxed_get_data_def( boxed )->name );
+	if( slot >= 0 && slots->boxed[slot] == boxed ){
+		slots->boxed[slot] = NULL;
+	}
 }
 
 static void
@@ -958,6 +1205,98 @@ free_data_boxed_list( FMAIFactoryObject *object )
 	g_list_free( list );
 
 	g_object_set_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA, NULL );
+	g_object_set_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_SLOTS, NULL );
+	g_object_set_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_COMPARE, NULL );
+}
+
+/*
+ * returns the dense array of FMADataBoxed of the object, allocating it
+ * on first call
+ */
+static FactorySlots *
+get_slots( const FMAIFactoryObject *object )
+{
+	FactorySlots *slots;
+
+	slots = ( FactorySlots * ) g_object_get_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_SLOTS );
+
+	if( !slots ){
+		slots = g_new0( FactorySlots, 1 );
+		slots->layout = get_layout( object );
+		slots->boxed = g_new0( FMADataBoxed *, MAX( 1, slots->layout->count ));
+		g_object_set_data_full( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_SLOTS, slots, ( GDestroyNotify ) free_slots );
+	}
+
+	return( slots );
+}
+
+/*
+ * layouts are built once per class, and are kept until the end of the
+ * program, as the classes themselves
+ */
+static const FactoryLayout *
+get_layout( const FMAIFactoryObject *object )
+{
+	FactoryLayout *layout;
+	FMADataGroup *groups;
+	GType type;
+
+	type = G_OBJECT_TYPE( object );
+
+	G_LOCK( st_layouts );
+
+	if( !st_layouts ){
+		st_layouts = g_hash_table_new( g_direct_hash, g_direct_equal );
+	}
+
+	layout = ( FactoryLayout * ) g_hash_table_lookup( st_layouts, GSIZE_TO_POINTER( type ));
+
+	if( !layout ){
+		layout = g_new0( FactoryLayout, 1 );
+		layout->slots = g_hash_table_new( g_str_hash, g_str_equal );
+
+		groups = v_get_groups( object );
+		if( groups ){
+			iter_on_data_defs( groups, DATA_DEF_ITER_ALL, ( FMADataDefIterFunc ) build_layout_iter, layout );
+		}
+
+		g_hash_table_insert( st_layouts, GSIZE_TO_POINTER( type ), layout );
+	}
+
+	G_UNLOCK( st_layouts );
+
+	return( layout );
+}
+
+/*
+ * if a name is defined twice, the first definition is kept, as
+ * fma_factory_object_get_data_def() used to do
+ */
+static gboolean
+build_layout_iter( FMADataDef *def, FactoryLayout *layout )
+{
+	if( !g_hash_table_lookup( layout->slots, def->name )){
+		layout->defs = g_renew( FMADataDef *, layout->defs, layout->count+1 );
+		layout->defs[layout->count] = def;
+		layout->count += 1;
+		g_hash_table_insert( layout->slots, ( gpointer ) def->name, GUINT_TO_POINTER( layout->count ));
+	}
+
+	/* do not stop */
+	return( FALSE );
+}
+
+static gint
+get_slot( const FactoryLayout *layout, const gchar *name )
+{
+	return(( gint ) GPOINTER_TO_UINT( g_hash_table_lookup( layout->slots, name )) - 1 );
+}
+
+static void
+free_slots( FactorySlots *slots )
+{
+	g_free( slots->boxed );
+	g_free( slots );
 }
 
 /*
@@ -996,6 +1335,7 @@ iter_on_data_defs( const FMADataGroup *groups, guint mode, FMADataDefIterFunc pf
 						break;
 
 					case DATA_DEF_ITER_IS_VALID:
+					case DATA_DEF_ITER_ALL:
 						stop = ( *pfn )( def, user_data );
 						break;
 
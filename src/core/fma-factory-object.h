@@ -48,6 +48,8 @@ typedef gboolean ( *FMAFactoryObjectIterBoxedFn )( const FMAIFactoryObject *obje
 
 void          fma_factory_object_define_properties( GObjectClass *class, const FMADataGroup *groups );
 FMADataDef   *fma_factory_object_get_data_def     ( const FMAIFactoryObject *object, const gchar *name );
+FMADataBoxed *fma_factory_object_get_data_boxed   ( const FMAIFactoryObject *object, const gchar *name );
+void          fma_factory_object_get_data_boxed_v ( const FMAIFactoryObject *object, const gchar * const *names, FMADataBoxed **boxed );
 FMADataGroup *fma_factory_object_get_data_groups  ( const FMAIFactoryObject *object );
 void          fma_factory_object_iter_on_boxed    ( const FMAIFactoryObject *object, FMAFactoryObjectIterBoxedFn pfn, void *user_data );
 
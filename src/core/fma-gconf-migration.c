@@ -31,10 +31,30 @@
 #include <config.h>
 #endif
 
+#include <glib/gstdio.h>
+#include <string.h>
+
 #include "fma-gconf-migration.h"
 
 #define MIGRATION_COMMAND				PKGLIBEXECDIR "/fma-gconf2key.sh -delete -nodummy -verbose"
 
+/* the stamp file records the state of the GConf tree after the last
+ * migration; the migration is not run again while this state doesn't
+ * change
+ * the version is to be incremented each time the migration script
+ * migrates more data
+ */
+#define MIGRATION_STAMP					"gconf-migration.stamp"
+#define MIGRATION_VERSION				1
+
+#ifdef HAVE_GCONF
+static void     migration_run( const gchar *stamp_path );
+static gchar   *get_stamp_path( void );
+static gchar   *get_tree_state( void );
+static void     add_path_state( GString *state, const gchar *path );
+static void     scan_dir( const gchar *path, guint *count, goffset *size, gint64 *mtime );
+#endif
+
 /**
  * fma_gconf_migration_run:
  *
@@ -42,6 +62,9 @@
  * Disable GConf I/O provider both for reading and writing.
  * Migrate users preferences to FMASettings.
  *
+ * The migration is skipped when the GConf tree has not changed since
+ * the last migration, as recorded in the stamp file.
+ *
  * Since: 3.1
  */
 void
@@ -49,7 +72,65 @@ fma_gconf_migration_run( void )
 {
 	static const gchar *thisfn = "fma_gconf_migration_run";
 #ifdef HAVE_GCONF
-	gchar *out, *err;
+	gchar *stamp_path, *stamp, *state;
+	gboolean uptodate;
+
+	stamp_path = get_stamp_path();
+	uptodate = FALSE;
+
+	if( g_file_get_contents( stamp_path, &stamp, NULL, NULL )){
+		state = get_tree_state();
+		uptodate = !strcmp( stamp, state );
+		g_free( state );
+		g_free( stamp );
+	}
+
+	if( uptodate ){
+		g_debug( "%s: GConf tree unchanged since last migration", thisfn );
+
+	} else {
+		migration_run( stamp_path );
+	}
+
+	g_free( stamp_path );
+#else
+	g_debug( "%s: GConf support is disabled, no migration", thisfn );
+#endif /* HAVE_GCONF */
+}
+
+/**
+ * fma_gconf_migration_force:
+ *
+ * Runs the migration, even if the GConf tree has not changed since the
+ * last migration.
+ *
+ * Since: 3.5
+ */
+void
+fma_gconf_migration_force( void )
+{
+	static const gchar *thisfn = "fma_gconf_migration_force";
+#ifdef HAVE_GCONF
+	gchar *stamp_path;
+
+	stamp_path = get_stamp_path();
+	migration_run( stamp_path );
+	g_free( stamp_path );
+#else
+	g_debug( "%s: GConf support is disabled, no migration", thisfn );
+#endif /* HAVE_GCONF */
+}
+
+#ifdef HAVE_GCONF
+/*
+ * the stamp is only written when the migration script has been run,
+ * with the state of the tree it has left
+ */
+static void
+migration_run( const gchar *stamp_path )
+{
+	static const gchar *thisfn = "fma_gconf_migration_migration_run";
+	gchar *out, *err, *dir, *state;
 	GError *error;
 
 	g_debug( "%s: running %s", thisfn, MIGRATION_COMMAND );
@@ -65,8 +146,102 @@ fma_gconf_migration_run( void )
 		g_debug( "%s: err=%s", thisfn, err );
 		g_free( out );
 		g_free( err );
+
+		dir = g_path_get_dirname( stamp_path );
+		g_mkdir_with_parents( dir, 0700 );
+		g_free( dir );
+
+		state = get_tree_state();
+		if( !g_file_set_contents( stamp_path, state, -1, &error )){
+			g_warning( "%s: %s", thisfn, error->message );
+			g_error_free( error );
+		}
+		g_free( state );
 	}
-#else
-	g_debug( "%s: GConf support is disabled, no migration", thisfn );
-#endif /* HAVE_GCONF */
 }
+
+static gchar *
+get_stamp_path( void )
+{
+	return( g_build_filename( g_get_user_config_dir(), PACKAGE, MIGRATION_STAMP, NULL ));
+}
+
+/*
+ * the state of the GConf tree is made of:
+ * - the user tree of the package (XML backend), scanned recursively as
+ *   adding an item only modifies its parent directory;
+ * - the merged defaults and mandatory trees
+ */
+static gchar *
+get_tree_state( void )
+{
+	GString *state;
+	gchar *path;
+
+	state = g_string_new( "" );
+	g_string_append_printf( state, "version=%d\n", MIGRATION_VERSION );
+
+	path = g_build_filename( g_get_home_dir(), ".gconf", "apps", PACKAGE, NULL );
+	add_path_state( state, path );
+	g_free( path );
+
+	add_path_state( state, "/etc/gconf/gconf.xml.defaults/%gconf-tree.xml" );
+	add_path_state( state, "/etc/gconf/gconf.xml.mandatory/%gconf-tree.xml" );
+
+	return( g_string_free( state, FALSE ));
+}
+
+static void
+add_path_state( GString *state, const gchar *path )
+{
+	GStatBuf st;
+	guint count;
+	goffset size;
+	gint64 mtime;
+
+	if( g_stat( path, &st ) != 0 ){
+		g_string_append_printf( state, "%s=none\n", path );
+
+	} else {
+		count = 1;
+		size = st.st_size;
+		mtime = st.st_mtime;
+
+		if( g_file_test( path, G_FILE_TEST_IS_DIR )){
+			scan_dir( path, &count, &size, &mtime );
+		}
+
+		g_string_append_printf( state, "%s=%u;%" G_GINT64_FORMAT ";%" G_GINT64_FORMAT "\n",
+				path, count, ( gint64 ) size, mtime );
+	}
+}
+
+static void
+scan_dir( const gchar *path, guint *count, goffset *size, gint64 *mtime )
+{
+	GDir *dir;
+	const gchar *name;
+	gchar *child;
+	GStatBuf st;
+
+	dir = g_dir_open( path, 0, NULL );
+	if( dir ){
+		while(( name = g_dir_read_name( dir ))){
+			child = g_build_filename( path, name, NULL );
+
+			if( g_lstat( child, &st ) == 0 ){
+				*count += 1;
+				*size += st.st_size;
+				*mtime = MAX( *mtime, ( gint64 ) st.st_mtime );
+
+				if( S_ISDIR( st.st_mode )){
+					scan_dir( child, count, size, mtime );
+				}
+			}
+
+			g_free( child );
+		}
+		g_dir_close( dir );
+	}
+}
+#endif /* HAVE_GCONF */
@@ -34,7 +34,8 @@
 
 G_BEGIN_DECLS
 
-void  fma_gconf_migration_run( void );
+void  fma_gconf_migration_run  ( void );
+void  fma_gconf_migration_force( void );
 
 G_END_DECLS
 
@@ -42,8 +42,6 @@
 #include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
-#include <glibtop/proclist.h>
-#include <glibtop/procstate.h>
 
 #include <libnautilus-extension/nautilus-file-info.h>
 
@@ -52,8 +50,10 @@
 
 #include "fma-desktop-environment.h"
 #include "fma-gnome-vfs-uri.h"
+#include "fma-mime-type.h"
 #include "fma-selected-info.h"
 #include "fma-settings.h"
+#include "fma-show-if.h"
 
 /* private interface data
  */
@@ -63,28 +63,74 @@ struct _FMAIContextInterfacePrivate {
 
 static guint st_initializations = 0;	/* interface initialization count */
 
+/* the conditions which are fetched in one call when checking whether
+ * an object is candidate; the enum must be kept in the same order than
+ * the names array
+ */
+enum {
+	CONDITION_TARGET_SELECTION = 0,
+	CONDITION_TARGET_LOCATION,
+	CONDITION_TARGET_TOOLBAR,
+	CONDITION_ONLY_SHOW,
+	CONDITION_NOT_SHOW,
+	CONDITION_TRY_EXEC,
+	CONDITION_SHOW_IF_REGISTERED,
+	CONDITION_SHOW_IF_TRUE,
+	CONDITION_SHOW_IF_RUNNING,
+	CONDITION_MIMETYPES_IS_ALL,
+	CONDITION_MIMETYPES,
+	CONDITION_BASENAMES,
+	CONDITION_MATCHCASE,
+	CONDITION_SELECTION_COUNT,
+	CONDITION_SCHEMES,
+	CONDITION_FOLDERS,
+	CONDITION_CAPABILITIES,
+	CONDITION_N
+};
+
+static const gchar *st_condition_names[CONDITION_N+1] = {
+	FMAFO_DATA_TARGET_SELECTION,
+	FMAFO_DATA_TARGET_LOCATION,
+	FMAFO_DATA_TARGET_TOOLBAR,
+	FMAFO_DATA_ONLY_SHOW,
+	FMAFO_DATA_NOT_SHOW,
+	FMAFO_DATA_TRY_EXEC,
+	FMAFO_DATA_SHOW_IF_REGISTERED,
+	FMAFO_DATA_SHOW_IF_TRUE,
+	FMAFO_DATA_SHOW_IF_RUNNING,
+	FMAFO_DATA_MIMETYPES_IS_ALL,
+	FMAFO_DATA_MIMETYPES,
+	FMAFO_DATA_BASENAMES,
+	FMAFO_DATA_MATCHCASE,
+	FMAFO_DATA_SELECTION_COUNT,
+	FMAFO_DATA_SCHEMES,
+	FMAFO_DATA_FOLDERS,
+	FMAFO_DATA_CAPABILITITES,
+	NULL
+};
+
 static GType        register_type( void );
 static void         interface_base_init( FMAIContextInterface *klass );
 static void         interface_base_finalize( FMAIContextInterface *klass );
 
 static gboolean     v_is_candidate( FMAIContext *object, guint target, GList *selection );
 
-static gboolean     is_candidate_for_target( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_show_in( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_try_exec( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_show_if_registered( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_show_if_true( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_show_if_running( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_mimetypes( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_all_mimetype( const gchar *mimetype );
-static gboolean     is_file_mimetype( const gchar *mimetype );
+static void        *get_condition( FMADataBoxed **conditions, guint condition );
+
+static gboolean     is_candidate_for_target( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
+static gboolean     is_candidate_for_show_in( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
+static gboolean     is_candidate_for_try_exec( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
+static gboolean     is_candidate_for_show_if_registered( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
+static gboolean     is_candidate_for_show_if_true( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
+static gboolean     is_candidate_for_show_if_running( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
+static gboolean     is_candidate_for_mimetypes( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
 static gboolean     is_mimetype_of( const gchar *file_type, const gchar *ftype, gboolean is_regular );
-static gboolean     is_candidate_for_basenames( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_selection_count( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_schemes( const FMAIContext *object, guint target, GList *files );
+static gboolean     is_candidate_for_basenames( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
+static gboolean     is_candidate_for_selection_count( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
+static gboolean     is_candidate_for_schemes( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
 static gboolean     is_compatible_scheme( const gchar *pattern, const gchar *scheme );
-static gboolean     is_candidate_for_folders( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_capabilities( const FMAIContext *object, guint target, GList *files );
+static gboolean     is_candidate_for_folders( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
+static gboolean     is_candidate_for_capabilities( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files );
 
 static gboolean     is_valid_basenames( const FMAIContext *object );
 static gboolean     is_valid_mimetypes( const FMAIContext *object );
@@ -222,6 +268,7 @@ fma_icontext_is_candidate( const FMAIContext *context, guint target, GList *sele
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate";
 	gboolean is_candidate;
+	FMADataBoxed *conditions[CONDITION_N];
 
 	g_return_val_if_fail( FMA_IS_ICONTEXT( context ), FALSE );
 
@@ -231,19 +278,21 @@ fma_icontext_is_candidate( const FMAIContext *context, guint target, GList *sele
 	is_candidate = v_is_candidate( FMA_ICONTEXT( context ), target, selection );
 
 	if( is_candidate ){
+		fma_ifactory_object_get_data_boxed_v( FMA_IFACTORY_OBJECT( context ), st_condition_names, conditions );
+
 		is_candidate =
-				is_candidate_for_target( context, target, selection ) &&
-				is_candidate_for_show_in( context, target, selection ) &&
-				is_candidate_for_try_exec( context, target, selection ) &&
-				is_candidate_for_show_if_registered( context, target, selection ) &&
-				is_candidate_for_show_if_true( context, target, selection ) &&
-				is_candidate_for_show_if_running( context, target, selection ) &&
-				is_candidate_for_mimetypes( context, target, selection ) &&
-				is_candidate_for_basenames( context, target, selection ) &&
-				is_candidate_for_selection_count( context, target, selection ) &&
-				is_candidate_for_schemes( context, target, selection ) &&
-				is_candidate_for_folders( context, target, selection ) &&
-				is_candidate_for_capabilities( context, target, selection );
+				is_candidate_for_target( context, conditions, target, selection ) &&
+				is_candidate_for_show_in( context, conditions, target, selection ) &&
+				is_candidate_for_try_exec( context, conditions, target, selection ) &&
+				is_candidate_for_show_if_registered( context, conditions, target, selection ) &&
+				is_candidate_for_show_if_true( context, conditions, target, selection ) &&
+				is_candidate_for_show_if_running( context, conditions, target, selection ) &&
+				is_candidate_for_mimetypes( context, conditions, target, selection ) &&
+				is_candidate_for_basenames( context, conditions, target, selection ) &&
+				is_candidate_for_selection_count( context, conditions, target, selection ) &&
+				is_candidate_for_schemes( context, conditions, target, selection ) &&
+				is_candidate_for_folders( context, conditions, target, selection ) &&
+				is_candidate_for_capabilities( context, conditions, target, selection );
 	}
 
 	return( is_candidate );
@@ -309,7 +358,10 @@ fma_icontext_check_mimetypes( const FMAIContext *context )
 			continue;
 		}
 		const gchar *imtype = ( const gchar * ) im->data;
-		if( is_all_mimetype( imtype )){
+		/* this also interns the mimetype condition, and its classification,
+		 * so that this is no more computed when checking for candidates
+		 */
+		if( fma_mime_type_get_class( imtype ) == MIME_TYPE_CLASS_ALL ){
 			continue;
 		}
 		is_all = FALSE;
@@ -466,13 +518,22 @@ v_is_candidate( FMAIContext *context, guint target, GList *selection )
 	return( is_candidate );
 }
 
+/*
+ * returns the value of the condition, as fma_object_get_xxx() would do
+ */
+static void *
+get_condition( FMADataBoxed **conditions, guint condition )
+{
+	return( conditions[condition] ? fma_boxed_get_as_void( FMA_BOXED( conditions[condition] )) : NULL );
+}
+
 /*
  * whether the given FMAIContext object is candidate for this target
  * target is context menu for location, context menu for selection or toolbar for location
  * only actions are concerned by this check
  */
 static gboolean
-is_candidate_for_target( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_target( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_target";
 	gboolean ok = TRUE;
@@ -480,15 +541,15 @@ is_candidate_for_target( const FMAIContext *object, guint target, GList *files )
 	if( FMA_IS_OBJECT_ACTION( object )){
 		switch( target ){
 			case ITEM_TARGET_LOCATION:
-				ok = fma_object_is_target_location( object );
+				ok = ( gboolean ) GPOINTER_TO_UINT( get_condition( conditions, CONDITION_TARGET_LOCATION ));
 				break;
 
 			case ITEM_TARGET_TOOLBAR:
-				ok = fma_object_is_target_toolbar( object );
+				ok = ( gboolean ) GPOINTER_TO_UINT( get_condition( conditions, CONDITION_TARGET_TOOLBAR ));
 				break;
 
 			case ITEM_TARGET_SELECTION:
-				ok = fma_object_is_target_selection( object );
+				ok = ( gboolean ) GPOINTER_TO_UINT( get_condition( conditions, CONDITION_TARGET_SELECTION ));
 				break;
 
 			case ITEM_TARGET_ANY:
@@ -514,12 +575,12 @@ is_candidate_for_target( const FMAIContext *object, guint target, GList *files )
  * only one of these two data may be set
  */
 static gboolean
-is_candidate_for_show_in( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_show_in( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_show_in";
 	gboolean ok = TRUE;
-	GSList *only_in = fma_object_get_only_show_in( object );
-	GSList *not_in = fma_object_get_not_show_in( object );
+	GSList *only_in = ( GSList * ) get_condition( conditions, CONDITION_ONLY_SHOW );
+	GSList *not_in = ( GSList * ) get_condition( conditions, CONDITION_NOT_SHOW );
 	static gchar *environment = NULL;
 
 	/* there is a memory leak here when desktop comes from user preferences
@@ -558,12 +619,12 @@ is_candidate_for_show_in( const FMAIContext *object, guint target, GList *files
  * if the data is set, it should be the path of an executable file
  */
 static gboolean
-is_candidate_for_try_exec( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_try_exec( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_try_exec";
 	gboolean ok = TRUE;
 	GError *error = NULL;
-	gchar *tryexec = fma_object_get_try_exec( object );
+	gchar *tryexec = ( gchar * ) get_condition( conditions, CONDITION_TRY_EXEC );
 
 	if( tryexec && strlen( tryexec )){
 		ok = FALSE;
@@ -594,11 +655,11 @@ is_candidate_for_try_exec( const FMAIContext *object, guint target, GList *files
 }
 
 static gboolean
-is_candidate_for_show_if_registered( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_show_if_registered( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_show_if_registered";
 	gboolean ok = TRUE;
-	gchar *name = fma_object_get_show_if_registered( object );
+	gchar *name = ( gchar * ) get_condition( conditions, CONDITION_SHOW_IF_REGISTERED );
 
 	if( name && strlen( name )){
 		ok = FALSE;
@@ -614,22 +675,14 @@ is_candidate_for_show_if_registered( const FMAIContext *object, guint target, GL
 }
 
 static gboolean
-is_candidate_for_show_if_true( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_show_if_true( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_show_if_true";
 	gboolean ok = TRUE;
-	gchar *command = fma_object_get_show_if_true( object );
+	gchar *command = ( gchar * ) get_condition( conditions, CONDITION_SHOW_IF_TRUE );
 
 	if( command && strlen( command )){
-		ok = FALSE;
-		gchar *stdout = NULL;
-		g_spawn_command_line_sync( command, &stdout, NULL, NULL, NULL );
-
-		if( stdout && !strcmp( stdout, "true" )){
-			ok = TRUE;
-		}
-
-		g_free( stdout );
+		ok = fma_show_if_true( command );
 	}
 
 	if( !ok ){
@@ -642,33 +695,14 @@ is_candidate_for_show_if_true( const FMAIContext *object, guint target, GList *f
 }
 
 static gboolean
-is_candidate_for_show_if_running( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_show_if_running( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_show_if_running";
 	gboolean ok = TRUE;
-	gchar *searched;
-	glibtop_proclist proclist;
-	glibtop_proc_state procstate;
-	pid_t *pid_list;
-	guint i;
-	gchar *running = fma_object_get_show_if_running( object );
+	gchar *running = ( gchar * ) get_condition( conditions, CONDITION_SHOW_IF_RUNNING );
 
 	if( running && strlen( running )){
-		ok = FALSE;
-		searched = g_path_get_basename( running );
-		pid_list = glibtop_get_proclist( &proclist, GLIBTOP_KERN_PROC_ALL, 0 );
-
-		for( i=0 ; i<proclist.number && !ok ; ++i ){
-			glibtop_get_proc_state( &procstate, pid_list[i] );
-			/*g_debug( "%s: i=%d, cmd=%s", thisfn, i, procstate.cmd );*/
-			if( strcmp( procstate.cmd, searched ) == 0 ){
-				g_debug( "%s: i=%d, cmd=%s", thisfn, i, procstate.cmd );
-				ok = TRUE;
-			}
-		}
-
-		g_free( pid_list );
-		g_free( searched );
+		ok = fma_show_if_running( running );
 	}
 
 	if( !ok ){
@@ -702,16 +736,16 @@ is_candidate_for_show_if_running( const FMAIContext *object, guint target, GList
  *  examined mimetype never match these
  */
 static gboolean
-is_candidate_for_mimetypes( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_mimetypes( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_mimetypes";
 	gboolean ok = TRUE;
-	gboolean all = fma_object_get_all_mimetypes( object );
+	gboolean all = ( gboolean ) GPOINTER_TO_UINT( get_condition( conditions, CONDITION_MIMETYPES_IS_ALL ));
 
 	g_debug( "%s: all=%s", thisfn, all ? "True":"False" );
 
 	if( !all ){
-		GSList *mimetypes = fma_object_get_mimetypes( object );
+		GSList *mimetypes = ( GSList * ) get_condition( conditions, CONDITION_MIMETYPES );
 		GSList *im;
 		GList *it;
 
@@ -764,77 +798,44 @@ is_candidate_for_mimetypes( const FMAIContext *object, guint target, GList *file
 	return( ok );
 }
 
-static gboolean
-is_all_mimetype( const gchar *mimetype )
-{
-	return( !strcmp( mimetype, "*" ) ||
-			!strcmp( mimetype, "*/*" ) ||
-			!strcmp( mimetype, "*/all" ) ||	/* should be considered as invalid */
-			!strcmp( mimetype, "all" ) ||
-			!strcmp( mimetype, "all/*" ) ||
-			!strcmp( mimetype, "all/all" ));
-}
-
-static gboolean
-is_file_mimetype( const gchar *mimetype )
-{
-	return( !strcmp( mimetype, "allfiles" ) ||
-			!strcmp( mimetype, "*/allfiles" ) ||	/* should be considered as invalid */
-			!strcmp( mimetype, "allfiles/*" ) ||
-			!strcmp( mimetype, "allfiles/all" ) ||
-			!strcmp( mimetype, "all/allfiles" ));
-}
-
 /*
  * does the file fgroup/fsubgroup have a mimetype which is 'a sort of'
  *  mimetype specified one ?
  * for example, "image/jpeg" is clearly a sort of "image/ *"
  *
- * content type if the same as the mime type in *nix;
- * this is not true on Win32 platforms
+ * both the classification of the mimetype condition and the 'is a'
+ * relation are memoized in the process-wide mimetype cache
  */
 static gboolean
 is_mimetype_of( const gchar *mimetype, const gchar *ftype, gboolean is_regular )
 {
-	static const gchar *thisfn = "fma_icontext_is_mimetype_of";
-	gboolean is_type_of;
-	gchar *file_content_type, *def_content_type;
-
-	if( is_all_mimetype( mimetype )){
-		return( TRUE );
-	}
+	switch( fma_mime_type_get_class( mimetype )){
+		case MIME_TYPE_CLASS_ALL:
+			return( TRUE );
 
-	if( is_file_mimetype( mimetype ) && is_regular ){
-		return( TRUE );
-	}
-
-	is_type_of = FALSE;
-	file_content_type = g_content_type_from_mime_type( ftype );
-	def_content_type = g_content_type_from_mime_type( mimetype );
+		case MIME_TYPE_CLASS_ALLFILES:
+			if( is_regular ){
+				return( TRUE );
+			}
+			break;
 
-	if( file_content_type && def_content_type ){
-		is_type_of = g_content_type_is_a( file_content_type, def_content_type );
-		g_debug( "%s: def_mimetype=%s content_type=%s file_mimetype=%s content_type=%s is_a=%s",
-				thisfn, mimetype, def_content_type, ftype, file_content_type,
-				is_type_of ? "True":"False" );
+		default:
+			break;
 	}
 
-	g_free( file_content_type );
-	g_free( def_content_type );
-
-	return( is_type_of );
+	return( fma_mime_type_is_a( ftype, mimetype ));
 }
 
 static gboolean
-is_candidate_for_basenames( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_basenames( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_basenames";
 	gboolean ok = TRUE;
-	GSList *basenames = fma_object_get_basenames( object );
+	GSList *basenames = ( GSList * ) get_condition( conditions, CONDITION_BASENAMES );
 
 	if( basenames ){
 		if( strcmp( basenames->data, "*" ) != 0 || g_slist_length( basenames ) > 1 ){
-			gboolean matchcase = fma_object_get_matchcase( object );
+			gboolean matchcase = ( gboolean ) GPOINTER_TO_UINT( get_condition( conditions, CONDITION_MATCHCASE ));
 			GSList *ib;
 			GList *it;
 			gchar *tmp;
@@ -895,13 +896,13 @@ is_candidate_for_basenames( const FMAIContext *object, guint target, GList *file
 }
 
 static gboolean
-is_candidate_for_selection_count( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_selection_count( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_selection_count";
 	gboolean ok = TRUE;
 	gint limit;
 	guint count;
-	gchar *selection_count = fma_object_get_selection_count( object );
+	gchar *selection_count = ( gchar * ) get_condition( conditions, CONDITION_SELECTION_COUNT );
 
 	if( selection_count && strlen( selection_count )){
 		limit = atoi( selection_count+1 );
@@ -943,11 +944,11 @@ is_candidate_for_selection_count( const FMAIContext *object, guint target, GList
  * against schemes conditions.
  */
 static gboolean
-is_candidate_for_schemes( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_schemes( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_schemes";
 	gboolean ok = TRUE;
-	GSList *schemes = fma_object_get_schemes( object );
+	GSList *schemes = ( GSList * ) get_condition( conditions, CONDITION_SCHEMES );
 
 	if( schemes ){
 		if( strcmp( schemes->data, "*" ) != 0 || g_slist_length( schemes ) > 1 ){
@@ -1026,11 +1027,11 @@ is_compatible_scheme( const gchar *pattern, const gchar *scheme )
  * conditions
  */
 static gboolean
-is_candidate_for_folders( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_folders( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_folders";
 	gboolean ok = TRUE;
-	GSList *folders = fma_object_get_folders( object );
+	GSList *folders = ( GSList * ) get_condition( conditions, CONDITION_FOLDERS );
 
 	if( folders ){
 		if( strcmp( folders->data, "/" ) != 0 || g_slist_length( folders ) > 1 ){
@@ -1089,11 +1090,11 @@ is_candidate_for_folders( const FMAIContext *object, guint target, GList *files
 }
 
 static gboolean
-is_candidate_for_capabilities( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_capabilities( const FMAIContext *object, FMADataBoxed **conditions, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_capabilities";
 	gboolean ok = TRUE;
-	GSList *capabilities = fma_object_get_capabilities( object );
+	GSList *capabilities = ( GSList * ) get_condition( conditions, CONDITION_CAPABILITIES );
 
 	if( capabilities ){
 		GSList *ic;
@@ -328,6 +328,10 @@ fma_iduplicable_duplicate( const FMAIDuplicable *object, guint mode )
  * fma_object_check_status() so first check status for children, before
  * calling this function.
  *
+ * The #FMAObject implementation remembers the result of the previous
+ * comparison with the origin, so that only the data which have been
+ * set since are compared again.
+ *
  * Since: 2.30
  */
 void
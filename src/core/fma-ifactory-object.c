@@ -31,8 +31,6 @@
 #include <config.h>
 #endif
 
-#include <string.h>
-
 #include <api/fma-ifactory-object.h>
 
 #include "fma-factory-object.h"
@@ -155,23 +153,33 @@ ifactory_object_get_version( const FMAIFactoryObject *instance )
 FMADataBoxed *
 fma_ifactory_object_get_data_boxed( const FMAIFactoryObject *object, const gchar *name )
 {
-	GList *list, *ip;
-
 	g_return_val_if_fail( FMA_IS_IFACTORY_OBJECT( object ), NULL );
 
-	list = g_object_get_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA );
-	/*g_debug( "list=%p (count=%u)", ( void * ) list, g_list_length( list ));*/
-
-	for( ip = list ; ip ; ip = ip->next ){
-		FMADataBoxed *boxed = FMA_DATA_BOXED( ip->data );
-		const FMADataDef *def = fma_data_boxed_get_data_def( boxed );
+	return( fma_factory_object_get_data_boxed( object, name ));
+}
 
-		if( !strcmp( def->name, name )){
-			return( boxed );
-		}
-	}
+/**
+ * fma_ifactory_object_get_data_boxed_v:
+ * @object: a #FMAIFactoryObject object.
+ * @names: a %NULL-terminated array of the names of the elementary data
+ *  we are searching for.
+ * @boxed: an array of at least as many elements as @names, which will
+ *  be filled with the #FMADataBoxed objects which contain the specified
+ *  data, or %NULL.
+ *
+ * Fetches several elementary data in one call.
+ *
+ * The returned #FMADataBoxed are owned by #FMAIFactoryObject @object, and
+ * should not be released by the caller.
+ *
+ * Since: 3.5
+ */
+void
+fma_ifactory_object_get_data_boxed_v( const FMAIFactoryObject *object, const gchar * const *names, FMADataBoxed **boxed )
+{
+	g_return_if_fail( FMA_IS_IFACTORY_OBJECT( object ));
 
-	return( NULL );
+	fma_factory_object_get_data_boxed_v( object, names, boxed );
 }
 
 /**
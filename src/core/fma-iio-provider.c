@@ -126,11 +126,16 @@ interface_base_init( FMAIIOProviderInterface *klass )
 		klass->write_item = NULL;
 		klass->delete_item = NULL;
 		klass->duplicate_data = NULL;
+		klass->read_item = NULL;
+		klass->get_sources = NULL;
+		klass->write_items = NULL;
 
 		/**
 		 * FMAIIOProvider::io-provider-item-changed:
 		 * @provider: the #FMAIIOProvider which has called the
 		 *  fma_iio_provider_item_changed() function.
+		 * @changes: the #GSList of the #FMAIIOProviderChange changes,
+		 *  or %NULL if the changed items are not known.
 		 *
 		 * This signal is registered without any default handler.
 		 *
@@ -138,7 +143,10 @@ interface_base_init( FMAIIOProviderInterface *klass )
 		 * Instead, the plugin should call the fma_iio_provider_item_changed()
 		 * function.
 		 *
-		 * See also fma_iio_provider_item_changed().
+		 * See also fma_iio_provider_item_changed() and
+		 * fma_iio_provider_items_changed().
+		 *
+		 * Since 3.5, the signal carries the list of the changes.
 		 */
 		st_signals[ ITEM_CHANGED ] = g_signal_new(
 					IO_PROVIDER_SIGNAL_ITEM_CHANGED,
@@ -147,9 +155,10 @@ interface_base_init( FMAIIOProviderInterface *klass )
 					0,									/* class offset */
 					NULL,								/* accumulator */
 					NULL,								/* accumulator data */
-					g_cclosure_marshal_VOID__VOID,
+					g_cclosure_marshal_VOID__POINTER,
 					G_TYPE_NONE,
-					0 );
+					1,
+					G_TYPE_POINTER );
 	}
 
 	st_initializations += 1;
@@ -214,5 +223,88 @@ fma_iio_provider_item_changed( const FMAIIOProvider *instance )
 
 	g_debug( "%s: instance=%p", thisfn, ( void * ) instance );
 
-	g_signal_emit_by_name(( gpointer ) instance, IO_PROVIDER_SIGNAL_ITEM_CHANGED );
+	g_signal_emit_by_name(( gpointer ) instance, IO_PROVIDER_SIGNAL_ITEM_CHANGED, NULL );
+}
+
+/**
+ * fma_iio_provider_items_changed:
+ * @instance: the calling #FMAIIOProvider.
+ * @ids: a #GSList of the identifiers of the changed items (menus or
+ *  actions), or %NULL.
+ *
+ * Informs &prodname; that this #FMAIIOProvider @instance has detected
+ * a modification of the @ids items, whether they have been created,
+ * updated or deleted.
+ *
+ * Contrarily to fma_iio_provider_item_changed(), which lets the
+ * consumer reload the whole list of items, this function lets it only
+ * reload the identified items when the I/O provider implements the
+ * #FMAIIOProviderInterface.read_item() method.
+ *
+ * A %NULL @ids list is equivalent to calling
+ * fma_iio_provider_item_changed().
+ *
+ * The @ids list is owned by the caller.
+ *
+ * Since: 3.5
+ */
+void
+fma_iio_provider_items_changed( const FMAIIOProvider *instance, GSList *ids )
+{
+	static const gchar *thisfn = "fma_iio_provider_items_changed";
+	GSList *changes, *it;
+	FMAIIOProviderChange *change;
+
+	g_debug( "%s: instance=%p, ids=%p (count=%u)",
+			thisfn, ( void * ) instance, ( void * ) ids, g_slist_length( ids ));
+
+	changes = NULL;
+	for( it = ids ; it ; it = it->next ){
+		change = g_new0( FMAIIOProviderChange, 1 );
+		change->id = ( gchar * ) it->data;
+		change->type = IIO_PROVIDER_CHANGE_UPDATED;
+		changes = g_slist_prepend( changes, change );
+	}
+	changes = g_slist_reverse( changes );
+
+	g_signal_emit_by_name(( gpointer ) instance, IO_PROVIDER_SIGNAL_ITEM_CHANGED, changes );
+
+	/* identifiers are owned by the caller */
+	g_slist_free_full( changes, ( GDestroyNotify ) g_free );
+}
+
+/**
+ * fma_iio_provider_items_changed_full:
+ * @instance: the calling #FMAIIOProvider.
+ * @changes: a #GSList of #FMAIIOProviderChange structures, or %NULL.
+ *
+ * Informs &prodname; that this #FMAIIOProvider @instance has detected
+ * the @changes on its items.
+ *
+ * Contrarily to fma_iio_provider_items_changed(), the I/O provider
+ * tells here whether each item has been created, updated or deleted,
+ * so that the consumer is able to apply the changes incrementally:
+ * a deleted item is not read again, and a created one may just be
+ * added to the current tree.
+ *
+ * The I/O provider is expected to have summarized a whole burst of
+ * notifications, so that an item only appears once in the list, with
+ * its final state.
+ *
+ * A %NULL @changes list is equivalent to calling
+ * fma_iio_provider_item_changed().
+ *
+ * The @changes list is owned by the caller.
+ *
+ * Since: 3.5
+ */
+void
+fma_iio_provider_items_changed_full( const FMAIIOProvider *instance, GSList *changes )
+{
+	static const gchar *thisfn = "fma_iio_provider_items_changed_full";
+
+	g_debug( "%s: instance=%p, changes=%p (count=%u)",
+			thisfn, ( void * ) instance, ( void * ) changes, g_slist_length( changes ));
+
+	g_signal_emit_by_name(( gpointer ) instance, IO_PROVIDER_SIGNAL_ITEM_CHANGED, changes );
 }
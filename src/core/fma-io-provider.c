@@ -97,9 +97,9 @@ static gboolean       is_finally_writable( const FMAIOProvider *provider, const
 static GList         *load_items_filter_unwanted_items( const FMAPivot *pivot, GList *merged, guint loadable_set );
 static GList         *load_items_filter_unwanted_items_rec( GList *merged, guint loadable_set );
 static GList         *load_items_get_merged_list( const FMAPivot *pivot, guint loadable_set, GSList **messages );
-static GList         *load_items_hierarchy_build( GList **tree, GSList *level_zero, gboolean list_if_empty, FMAObjectItem *parent );
+static GHashTable    *load_items_hierarchy_index( GList *tree );
+static GList         *load_items_hierarchy_build( GList **tree, GHashTable *index, GSList *level_zero, gboolean list_if_empty, FMAObjectItem *parent );
 static GList         *load_items_hierarchy_sort( const FMAPivot *pivot, GList *tree, GCompareFunc fn );
-static gint           peek_item_by_id_compare( const FMAObject *obj, const gchar *id );
 static FMAIOProvider *peek_provider_by_id( const GList *providers, const gchar *id );
 
 GType
@@ -366,6 +366,37 @@ fma_io_provider_find_io_provider_by_id( const FMAPivot *pivot, const gchar *id )
 	return( found );
 }
 
+/*
+ * fma_io_provider_find_io_provider_by_module:
+ * @pivot: the #FMAPivot instance.
+ * @module: the #FMAIIOProvider module.
+ *
+ * Returns: the I/O provider which encapsulates the @module, or NULL.
+ *
+ * The returned provider is owned by FMAIOProvider class, and should not
+ * be released by the caller.
+ */
+FMAIOProvider *
+fma_io_provider_find_io_provider_by_module( const FMAPivot *pivot, const FMAIIOProvider *module )
+{
+	const GList *providers;
+	const GList *ip;
+	FMAIOProvider *provider;
+	FMAIOProvider *found;
+
+	providers = fma_io_provider_get_io_providers_list( pivot );
+	found = NULL;
+
+	for( ip = providers ; ip && !found ; ip = ip->next ){
+		provider = FMA_IO_PROVIDER( ip->data );
+		if( provider->private->provider == ( FMAIIOProvider * ) module ){
+			found = provider;
+		}
+	}
+
+	return( found );
+}
+
 /*
  * fma_io_provider_get_io_providers_list:
  * @pivot: the current #FMAPivot instance.
@@ -852,6 +883,7 @@ fma_io_provider_load_items( const FMAPivot *pivot, guint loadable_set, GSList **
 	static const gchar *thisfn = "fma_io_provider_load_items";
 	GList *flat, *hierarchy, *filtered;
 	GSList *level_zero;
+	GHashTable *index;
 	guint order_mode;
 
 	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), NULL );
@@ -868,7 +900,9 @@ fma_io_provider_load_items( const FMAPivot *pivot, guint loadable_set, GSList **
 	 */
 	level_zero = fma_settings_get_string_list( IPREFS_ITEMS_LEVEL_ZERO_ORDER, NULL, NULL );
 
-	hierarchy = load_items_hierarchy_build( &flat, level_zero, TRUE, NULL );
+	index = load_items_hierarchy_index( flat );
+	hierarchy = load_items_hierarchy_build( &flat, index, level_zero, TRUE, NULL );
+	g_hash_table_destroy( index );
 
 	/* items that stay left in the global flat list are simply appended
 	 * to the built hierarchy, and level zero is updated accordingly
@@ -916,6 +950,108 @@ fma_io_provider_load_items( const FMAPivot *pivot, guint loadable_set, GSList **
 	return( filtered );
 }
 
+/*
+ * fma_io_provider_read_item:
+ * @provider: this #FMAIOProvider.
+ * @pivot: the #FMAPivot object.
+ * @id: the identifier of the item to be read.
+ * @loadable_set: the set of loadable items
+ *  (cf. FMAPivotLoadableSet enumeration defined in core/fma-pivot.h).
+ * @item: [out]: set to the newly allocated item, or %NULL if the item
+ *  does not exist anymore or does not satisfy the @loadable_set.
+ * @messages: error messages.
+ *
+ * Re-reads a single item from this I/O provider.
+ *
+ * Returns: %TRUE if the I/O provider has been able to answer, %FALSE if
+ * it is not readable or does not implement the read_item() method; in
+ * this later case, the caller should fallback to a full reload.
+ */
+gboolean
+fma_io_provider_read_item( const FMAIOProvider *provider, const FMAPivot *pivot,
+		const gchar *id, guint loadable_set, FMAObjectItem **item, GSList **messages )
+{
+	static const gchar *thisfn = "fma_io_provider_read_item";
+	const FMAIIOProvider *module;
+	GList *list, *filtered;
+
+	g_return_val_if_fail( FMA_IS_IO_PROVIDER( provider ), FALSE );
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), FALSE );
+	g_return_val_if_fail( id && strlen( id ), FALSE );
+	g_return_val_if_fail( item, FALSE );
+
+	*item = NULL;
+
+	if( provider->private->dispose_has_run ){
+		return( FALSE );
+	}
+
+	module = provider->private->provider;
+
+	if( !module ||
+		!FMA_IIO_PROVIDER_GET_INTERFACE( module )->read_item ||
+		!fma_io_provider_is_conf_readable( provider, pivot, NULL )){
+
+			g_debug( "%s: provider=%p (%s) is not able to read a single item",
+					thisfn, ( void * ) provider, provider->private->id );
+			return( FALSE );
+	}
+
+	*item = FMA_IIO_PROVIDER_GET_INTERFACE( module )->read_item( module, id, messages );
+
+	g_debug( "%s: provider=%p (%s), id=%s, item=%p",
+			thisfn, ( void * ) provider, provider->private->id, id, ( void * ) *item );
+
+	if( *item ){
+		fma_object_set_provider( *item, provider );
+
+		list = g_list_append( NULL, *item );
+		filtered = load_items_filter_unwanted_items( pivot, list, loadable_set );
+		*item = filtered ? FMA_OBJECT_ITEM( filtered->data ) : NULL;
+		g_list_free( filtered );
+		g_list_free( list );
+	}
+
+	return( TRUE );
+}
+
+/*
+ * fma_io_provider_get_sources:
+ * @provider: this #FMAIOProvider.
+ * @sources: [out]: set to the list of the paths the items of this I/O
+ *  provider are read from.
+ *
+ * Returns: %TRUE if the I/O provider has been able to answer, %FALSE if
+ * it does not implement the get_sources() method.
+ *
+ * The returned @sources list should be fma_core_utils_slist_free() by
+ * the caller.
+ */
+gboolean
+fma_io_provider_get_sources( const FMAIOProvider *provider, GSList **sources )
+{
+	const FMAIIOProvider *module;
+
+	g_return_val_if_fail( FMA_IS_IO_PROVIDER( provider ), FALSE );
+	g_return_val_if_fail( sources, FALSE );
+
+	*sources = NULL;
+
+	if( provider->private->dispose_has_run ){
+		return( FALSE );
+	}
+
+	module = provider->private->provider;
+
+	if( !module || !FMA_IIO_PROVIDER_GET_INTERFACE( module )->get_sources ){
+		return( FALSE );
+	}
+
+	*sources = FMA_IIO_PROVIDER_GET_INTERFACE( module )->get_sources( module );
+
+	return( TRUE );
+}
+
 #if 0
 static void
 dump( const FMAIOProvider *provider )
@@ -1134,44 +1270,78 @@ load_items_get_merged_list( const FMAPivot *pivot, guint loadable_set, GSList **
 	return( merged );
 }
 
+/*
+ * indexes the flat list of items by their identifier
+ *
+ * the returned hash table associates each id to its link in the 'tree'
+ * list; when several items share the same id, the first one is indexed,
+ * as g_list_find_custom() would have found it.
+ */
+static GHashTable *
+load_items_hierarchy_index( GList *tree )
+{
+	GHashTable *index;
+	GList *it;
+	gchar *id;
+
+	index = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+
+	for( it = tree ; it ; it = it->next ){
+		if( FMA_IS_OBJECT_ITEM( it->data )){
+			id = fma_object_get_id( it->data );
+			if( id && !g_hash_table_contains( index, id )){
+				g_hash_table_insert( index, id, it );
+			} else {
+				g_free( id );
+			}
+		}
+	}
+
+	return( index );
+}
+
 /*
  * builds the hierarchy
  *
  * this is a recursive function which _moves_ items from input 'tree' to
- * output list.
+ * output list; 'index' is kept in sync with the 'tree' links.
  */
 static GList *
-load_items_hierarchy_build( GList **tree, GSList *level_zero, gboolean list_if_empty, FMAObjectItem *parent )
+load_items_hierarchy_build( GList **tree, GHashTable *index, GSList *level_zero, gboolean list_if_empty, FMAObjectItem *parent )
 {
 	static const gchar *thisfn = "fma_io_provider_load_items_hierarchy_build";
 	GList *hierarchy, *it;
 	GSList *ilevel;
 	GSList *subitems_ids;
 	GList *subitems;
+	FMAObject *item;
 
 	hierarchy = NULL;
 
-	if( g_slist_length( level_zero )){
+	if( level_zero ){
 		for( ilevel = level_zero ; ilevel ; ilevel = ilevel->next ){
 			/*g_debug( "%s: id=%s", thisfn, ( gchar * ) ilevel->data );*/
-			it = g_list_find_custom( *tree, ilevel->data, ( GCompareFunc ) peek_item_by_id_compare );
+			it = g_hash_table_lookup( index, ilevel->data );
 			if( it ){
-				hierarchy = g_list_append( hierarchy, it->data );
-				fma_object_set_parent( it->data, parent );
+				item = FMA_OBJECT( it->data );
+				hierarchy = g_list_prepend( hierarchy, item );
+				fma_object_set_parent( item, parent );
 
-				g_debug( "%s: id=%s: %s (%p) appended to hierarchy %p",
-						thisfn, ( gchar * ) ilevel->data, G_OBJECT_TYPE_NAME( it->data ), ( void * ) it->data, ( void * ) hierarchy );
+				g_debug( "%s: id=%s: %s (%p) appended to hierarchy",
+						thisfn, ( gchar * ) ilevel->data, G_OBJECT_TYPE_NAME( item ), ( void * ) item );
 
-				*tree = g_list_remove_link( *tree, it );
+				g_hash_table_remove( index, ilevel->data );
+				*tree = g_list_delete_link( *tree, it );
 
-				if( FMA_IS_OBJECT_MENU( it->data )){
-					subitems_ids = fma_object_get_items_slist( it->data );
-					subitems = load_items_hierarchy_build( tree, subitems_ids, FALSE, FMA_OBJECT_ITEM( it->data ));
-					fma_object_set_items( it->data, subitems );
+				if( FMA_IS_OBJECT_MENU( item )){
+					subitems_ids = fma_object_get_items_slist( item );
+					subitems = load_items_hierarchy_build( tree, index, subitems_ids, FALSE, FMA_OBJECT_ITEM( item ));
+					fma_object_set_items( item, subitems );
 					fma_core_utils_slist_free( subitems_ids );
 				}
 			}
 		}
+		hierarchy = g_list_reverse( hierarchy );
 	}
 
 	/* if level-zero list is empty,
@@ -1179,10 +1349,10 @@ load_items_hierarchy_build( GList **tree, GSList *level_zero, gboolean list_if_e
 	 */
 	else if( list_if_empty ){
 		for( it = *tree ; it ; it = it->next ){
-			hierarchy = g_list_append( hierarchy, it->data );
 			fma_object_set_parent( it->data, parent );
 		}
-		g_list_free( *tree );
+		hierarchy = *tree;
+		g_hash_table_remove_all( index );
 		*tree = NULL;
 	}
 
@@ -1210,24 +1380,6 @@ load_items_hierarchy_sort( const FMAPivot *pivot, GList *tree, GCompareFunc fn )
 	return( sorted );
 }
 
-/*
- * returns zero when @obj has the required @id
- */
-static gint
-peek_item_by_id_compare( const FMAObject *obj, const gchar *id )
-{
-	gchar *obj_id;
-	gint ret = 1;
-
-	if( FMA_IS_OBJECT_ITEM( obj )){
-		obj_id = fma_object_get_id( obj );
-		ret = strcmp( obj_id, id );
-		g_free( obj_id );
-	}
-
-	return( ret );
-}
-
 /*
  * fma_io_provider_write_item:
  * @provider: this #FMAIOProvider object.
@@ -1303,6 +1455,81 @@ fma_io_provider_delete_item( const FMAIOProvider *provider, const FMAObjectItem
 	return( ret );
 }
 
+/*
+ * fma_io_provider_write_items:
+ * @provider: this #FMAIOProvider object.
+ * @items: the list of #FMAObjectItem items to be written.
+ * @deleted: the list of #FMAObjectItem items to be deleted.
+ * @failed: a pointer to a #GList where the items which have not been
+ *  written or deleted are appended; the items are not referenced, and
+ *  the list should be g_list_free() by the caller.
+ * @messages: error messages.
+ *
+ * Deletes then writes a batch of items, handing it to the I/O provider
+ * as a whole when it implements the write_items() method, or item by
+ * item else.
+ *
+ * Returns: the FMAIIOProvider return code, i.e. the first error code
+ * if any.
+ */
+guint
+fma_io_provider_write_items( const FMAIOProvider *provider, GList *items, GList *deleted, GList **failed, GSList **messages )
+{
+	static const gchar *thisfn = "fma_io_provider_write_items";
+	FMAIIOProviderInterface *iface;
+	guint ret, code;
+	GList *it;
+
+	g_debug( "%s: provider=%p (%s), items=%p (count=%d), deleted=%p (count=%d), messages=%p", thisfn,
+			( void * ) provider, G_OBJECT_TYPE_NAME( provider ),
+			( void * ) items, g_list_length( items ),
+			( void * ) deleted, g_list_length( deleted ),
+			( void * ) messages );
+
+	ret = IIO_PROVIDER_CODE_PROGRAM_ERROR;
+
+	g_return_val_if_fail( FMA_IS_IO_PROVIDER( provider ), ret );
+	g_return_val_if_fail( failed, ret );
+	g_return_val_if_fail( FMA_IS_IIO_PROVIDER( provider->private->provider ), ret );
+
+	iface = FMA_IIO_PROVIDER_GET_INTERFACE( provider->private->provider );
+
+	if( iface->write_items ){
+		ret = iface->write_items( provider->private->provider, items, deleted, messages );
+
+		if( ret == IIO_PROVIDER_CODE_OK ){
+			for( it = items ; it ; it = it->next ){
+				fma_object_set_provider( it->data, provider );
+			}
+
+		} else {
+			*failed = g_list_concat( *failed, g_list_copy( deleted ));
+			*failed = g_list_concat( *failed, g_list_copy( items ));
+		}
+
+	} else {
+		ret = IIO_PROVIDER_CODE_OK;
+
+		for( it = deleted ; it ; it = it->next ){
+			code = fma_io_provider_delete_item( provider, FMA_OBJECT_ITEM( it->data ), messages );
+			if( code != IIO_PROVIDER_CODE_OK ){
+				*failed = g_list_append( *failed, it->data );
+				ret = ( ret == IIO_PROVIDER_CODE_OK ? code : ret );
+			}
+		}
+
+		for( it = items ; it ; it = it->next ){
+			code = fma_io_provider_write_item( provider, FMA_OBJECT_ITEM( it->data ), messages );
+			if( code != IIO_PROVIDER_CODE_OK ){
+				*failed = g_list_append( *failed, it->data );
+				ret = ( ret == IIO_PROVIDER_CODE_OK ? code : ret );
+			}
+		}
+	}
+
+	return( ret );
+}
+
 /*
  * fma_io_provider_duplicate_data:
  * @provider: this #FMAIOProvider object.
@@ -97,6 +97,7 @@ GType          fma_io_provider_get_type                 ( void );
 
 FMAIOProvider *fma_io_provider_find_writable_io_provider( const FMAPivot *pivot );
 FMAIOProvider *fma_io_provider_find_io_provider_by_id   ( const FMAPivot *pivot, const gchar *id );
+FMAIOProvider *fma_io_provider_find_io_provider_by_module( const FMAPivot *pivot, const FMAIIOProvider *module );
 const GList   *fma_io_provider_get_io_providers_list    ( const FMAPivot *pivot );
 void           fma_io_provider_unref_io_providers_list  ( void );
 
@@ -108,9 +109,12 @@ gboolean       fma_io_provider_is_conf_writable         ( const FMAIOProvider *p
 gboolean       fma_io_provider_is_finally_writable      ( const FMAIOProvider *provider, guint *reason );
 
 GList         *fma_io_provider_load_items               ( const FMAPivot *pivot, guint loadable_set, GSList **messages );
+gboolean       fma_io_provider_read_item                ( const FMAIOProvider *provider, const FMAPivot *pivot, const gchar *id, guint loadable_set, FMAObjectItem **item, GSList **messages );
+gboolean       fma_io_provider_get_sources              ( const FMAIOProvider *provider, GSList **sources );
 
 guint          fma_io_provider_write_item               ( const FMAIOProvider *provider, const FMAObjectItem *item, GSList **messages );
 guint          fma_io_provider_delete_item              ( const FMAIOProvider *provider, const FMAObjectItem *item, GSList **messages );
+guint          fma_io_provider_write_items              ( const FMAIOProvider *provider, GList *items, GList *deleted, GList **failed, GSList **messages );
 guint          fma_io_provider_duplicate_data           ( const FMAIOProvider *provider, FMAObjectItem *dest, const FMAObjectItem *source, GSList **messages );
 
 gchar         *fma_io_provider_get_readonly_tooltip     ( guint reason );
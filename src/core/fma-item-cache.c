@@ -0,0 +1,895 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <api/fma-core-utils.h>
+#include <api/fma-data-types.h>
+#include <api/fma-object-api.h>
+
+#include "fma-factory-object.h"
+#include "fma-io-provider.h"
+#include "fma-iprefs.h"
+#include "fma-item-cache.h"
+
+/* the cache file starts with this header, followed by the validation
+ * key, the stamps of the sources, and then the tree of items
+ * all integers are written in the host byte order, as the cache is
+ * local to this machine
+ */
+#define CACHE_MAGIC						"FMACACHE"
+#define CACHE_BYTE_ORDER				0x01020304
+#define CACHE_VERSION					2
+
+/* the kind of the serialized objects
+ */
+enum {
+	CACHE_OBJECT_MENU = 1,
+	CACHE_OBJECT_ACTION,
+	CACHE_OBJECT_PROFILE
+};
+
+struct _FMAItemCache {
+	const FMAPivot *pivot;
+	gchar          *path;				/* the path of the cache file */
+	gchar          *lock_path;
+	gint            lock_fd;			/* -1 if not locked */
+	gchar          *key;				/* the preferences the tree depends of */
+	GHashTable     *stamps;				/* source path -> CacheStamp, or NULL if disabled */
+};
+
+/* what is recorded for each source path
+ * a non-existing source is recorded with all zeros
+ */
+typedef struct {
+	guint64 size;
+	gint64  mtime;						/* nanoseconds */
+	gint64  ctime;						/* nanoseconds */
+	guint64 inode;
+}
+	CacheStamp;
+
+/* a cursor over the mapped cache file
+ */
+typedef struct {
+	const gchar *data;
+	gsize        length;
+	gsize        offset;
+	gboolean     error;
+}
+	CacheReader;
+
+/* the data passed to the FMADataBoxed iteration when writing an object
+ */
+typedef struct {
+	GByteArray *out;
+	guint32     count;
+}
+	CacheWriter;
+
+static gchar       *get_key( guint loadable_set );
+static GHashTable  *get_stamps( const FMAPivot *pivot, GString *key );
+static void         get_stamp( const gchar *path, CacheStamp *stamp );
+static gboolean     read_header( FMAItemCache *cache, CacheReader *reader );
+static FMAObject   *read_object( FMAItemCache *cache, CacheReader *reader );
+static void         read_data( CacheReader *reader, FMAObject *object );
+static guint32      read_uint32( CacheReader *reader );
+static guint64      read_uint64( CacheReader *reader );
+static const gchar *read_string( CacheReader *reader );
+static void         write_object( GByteArray *out, FMAObject *object );
+static gboolean     write_data( const FMAIFactoryObject *object, FMADataBoxed *boxed, CacheWriter *writer );
+static void         write_uint32( GByteArray *out, guint32 value );
+static void         write_uint64( GByteArray *out, guint64 value );
+static void         write_string( GByteArray *out, const gchar *str );
+
+/*
+ * fma_item_cache_new:
+ * @pivot: the #FMAPivot instance.
+ * @loadable_set: the set of loadable items.
+ *
+ * Computes the validation key and stamps the sources of the readable
+ * I/O providers.
+ *
+ * This must be done before the items are actually read from the I/O
+ * providers, so that a source which would be modified while we are
+ * reading it will invalidate the saved cache.
+ *
+ * Returns: a newly allocated #FMAItemCache, which should be
+ * fma_item_cache_free() by the caller.
+ */
+FMAItemCache *
+fma_item_cache_new( const FMAPivot *pivot, guint loadable_set )
+{
+	static const gchar *thisfn = "fma_item_cache_new";
+	FMAItemCache *cache;
+	GString *key;
+	gchar *prefs, *bname;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), NULL );
+
+	cache = g_new0( FMAItemCache, 1 );
+	cache->pivot = pivot;
+	cache->lock_fd = -1;
+
+	bname = g_strdup_printf( "items-%u.cache", loadable_set );
+	cache->path = g_build_filename( g_get_user_runtime_dir(), PACKAGE, bname, NULL );
+	g_free( bname );
+
+	bname = g_strdup_printf( "items-%u.lock", loadable_set );
+	cache->lock_path = g_build_filename( g_get_user_runtime_dir(), PACKAGE, bname, NULL );
+	g_free( bname );
+
+	prefs = get_key( loadable_set );
+	key = g_string_new( prefs );
+	g_free( prefs );
+
+	cache->stamps = get_stamps( pivot, key );
+	cache->key = g_string_free( key, FALSE );
+
+	g_debug( "%s: path=%s, enabled=%s, sources=%u", thisfn, cache->path,
+			cache->stamps ? "True":"False", cache->stamps ? g_hash_table_size( cache->stamps ) : 0 );
+
+	return( cache );
+}
+
+/*
+ * fma_item_cache_free:
+ * @cache: this #FMAItemCache structure.
+ *
+ * Releases the resources allocated to the @cache.
+ */
+void
+fma_item_cache_free( FMAItemCache *cache )
+{
+	if( cache ){
+		fma_item_cache_unlock( cache );
+		if( cache->stamps ){
+			g_hash_table_destroy( cache->stamps );
+		}
+		g_free( cache->key );
+		g_free( cache->lock_path );
+		g_free( cache->path );
+		g_free( cache );
+	}
+}
+
+/*
+ * fma_item_cache_lock:
+ * @cache: this #FMAItemCache structure.
+ *
+ * Takes the lock which serializes the processes of the user which
+ * rewrite the cache.
+ *
+ * This never waits: if another process already holds the lock, it is
+ * rewriting the cache, and we just do not have to save it too.
+ * The lock is automatically released when the process exits.
+ *
+ * Returns: %TRUE if the lock has been acquired, and the cache may so be
+ * saved.
+ */
+gboolean
+fma_item_cache_lock( FMAItemCache *cache )
+{
+	static const gchar *thisfn = "fma_item_cache_lock";
+	gchar *dir;
+	gint fd;
+
+	g_return_val_if_fail( cache != NULL, FALSE );
+
+	if( !cache->stamps || cache->lock_fd >= 0 ){
+		return( cache->lock_fd >= 0 );
+	}
+
+	dir = g_path_get_dirname( cache->lock_path );
+	g_mkdir_with_parents( dir, 0700 );
+	g_free( dir );
+
+	fd = g_open( cache->lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600 );
+	if( fd < 0 ){
+		g_debug( "%s: %s: %s", thisfn, cache->lock_path, g_strerror( errno ));
+		return( FALSE );
+	}
+
+	if( flock( fd, LOCK_EX | LOCK_NB ) != 0 ){
+		g_debug( "%s: %s: %s", thisfn, cache->lock_path, g_strerror( errno ));
+		close( fd );
+		return( FALSE );
+	}
+
+	cache->lock_fd = fd;
+
+	return( TRUE );
+}
+
+/*
+ * fma_item_cache_unlock:
+ * @cache: this #FMAItemCache structure.
+ *
+ * Releases the lock taken by fma_item_cache_lock(), if any.
+ */
+void
+fma_item_cache_unlock( FMAItemCache *cache )
+{
+	g_return_if_fail( cache != NULL );
+
+	if( cache->lock_fd >= 0 ){
+		flock( cache->lock_fd, LOCK_UN );
+		close( cache->lock_fd );
+		cache->lock_fd = -1;
+	}
+}
+
+/*
+ * the preferences the built tree depends of
+ */
+static gchar *
+get_key( guint loadable_set )
+{
+	GSList *level_zero;
+	gchar *level_zero_str, *key;
+	const gchar * const *languages;
+
+	level_zero = fma_settings_get_string_list( IPREFS_ITEMS_LEVEL_ZERO_ORDER, NULL, NULL );
+	level_zero_str = fma_core_utils_slist_join_at_end( level_zero, ";" );
+	languages = g_get_language_names();
+
+	key = g_strdup_printf( "%s|%u|%u|%s|%s",
+			PACKAGE_VERSION, loadable_set, fma_iprefs_get_order_mode( NULL ),
+			languages[0], level_zero_str );
+
+	g_free( level_zero_str );
+	fma_core_utils_slist_free( level_zero );
+
+	return( key );
+}
+
+/*
+ * returns the stamps of the sources of all readable I/O providers,
+ * appending their identifiers to the @key,
+ * or %NULL if one of these providers is not able to list its sources
+ */
+static GHashTable *
+get_stamps( const FMAPivot *pivot, GString *key )
+{
+	static const gchar *thisfn = "fma_item_cache_get_stamps";
+	GHashTable *stamps;
+	const GList *ip;
+	FMAIOProvider *provider;
+	GSList *sources, *is;
+	CacheStamp *stamp;
+	gchar *id;
+
+	stamps = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_free );
+
+	for( ip = fma_io_provider_get_io_providers_list( pivot ) ; ip && stamps ; ip = ip->next ){
+		provider = FMA_IO_PROVIDER( ip->data );
+
+		if( fma_io_provider_is_available( provider ) &&
+			fma_io_provider_is_conf_readable( provider, pivot, NULL )){
+
+			id = fma_io_provider_get_id( provider );
+			g_string_append_printf( key, "|%s", id );
+
+			if( fma_io_provider_get_sources( provider, &sources )){
+				for( is = sources ; is ; is = is->next ){
+					stamp = g_new0( CacheStamp, 1 );
+					get_stamp(( const gchar * ) is->data, stamp );
+					g_hash_table_insert( stamps, g_strdup(( const gchar * ) is->data ), stamp );
+				}
+				fma_core_utils_slist_free( sources );
+
+			} else {
+				g_debug( "%s: %s: I/O provider doesn't list its sources, cache is disabled", thisfn, id );
+				g_hash_table_destroy( stamps );
+				stamps = NULL;
+			}
+
+			g_free( id );
+		}
+	}
+
+	return( stamps );
+}
+
+/*
+ * the times are kept with their nanoseconds when available, so that a
+ * same-size edit in the same second than the stamp is not missed
+ */
+static void
+get_stamp( const gchar *path, CacheStamp *stamp )
+{
+	GStatBuf st;
+
+	if( g_stat( path, &st ) == 0 ){
+		stamp->size = st.st_size;
+		stamp->mtime = ( gint64 ) st.st_mtime * G_GINT64_CONSTANT( 1000000000 );
+		stamp->ctime = ( gint64 ) st.st_ctime * G_GINT64_CONSTANT( 1000000000 );
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+		stamp->mtime += st.st_mtim.tv_nsec;
+		stamp->ctime += st.st_ctim.tv_nsec;
+#endif
+		stamp->inode = st.st_ino;
+	}
+}
+
+/*
+ * fma_item_cache_load:
+ * @cache: this #FMAItemCache structure.
+ * @tree: [out]: set to the loaded tree of items.
+ *
+ * The cache file is only mapped while the tree is built: the objects
+ * own a copy of their data, and the mapping is released before
+ * returning.
+ *
+ * Returns: %TRUE if the cache is up to date and has been successfully
+ * loaded, %FALSE if the items have to be read from the I/O providers.
+ *
+ * The returned @tree should be fma_object_free_items() by the caller.
+ */
+gboolean
+fma_item_cache_load( FMAItemCache *cache, GList **tree )
+{
+	static const gchar *thisfn = "fma_item_cache_load";
+	GMappedFile *mapped;
+	GError *error;
+	CacheReader reader;
+	guint32 count, i;
+	GList *items, *it;
+	FMAObject *object;
+
+	g_return_val_if_fail( cache != NULL, FALSE );
+	g_return_val_if_fail( tree, FALSE );
+
+	*tree = NULL;
+
+	if( !cache->stamps ){
+		return( FALSE );
+	}
+
+	error = NULL;
+	mapped = g_mapped_file_new( cache->path, FALSE, &error );
+	if( !mapped ){
+		g_debug( "%s: %s", thisfn, error->message );
+		g_error_free( error );
+		return( FALSE );
+	}
+
+	reader.data = g_mapped_file_get_contents( mapped );
+	reader.length = g_mapped_file_get_length( mapped );
+	reader.offset = 0;
+	reader.error = FALSE;
+	items = NULL;
+
+	if( read_header( cache, &reader )){
+		count = read_uint32( &reader );
+
+		for( i = 0 ; i < count && !reader.error ; ++i ){
+			object = read_object( cache, &reader );
+			if( object ){
+				items = g_list_prepend( items, object );
+			}
+		}
+
+		items = g_list_reverse( items );
+
+		if( !reader.error && reader.offset != reader.length ){
+			reader.error = TRUE;
+		}
+
+	} else {
+		reader.error = TRUE;
+	}
+
+	g_mapped_file_unref( mapped );
+
+	if( reader.error ){
+		g_debug( "%s: %s: cache is stale or invalid", thisfn, cache->path );
+		fma_object_free_items( items );
+		return( FALSE );
+	}
+
+	for( it = items ; it ; it = it->next ){
+		fma_object_check_status( it->data );
+	}
+
+	g_debug( "%s: %s: %u items loaded from the cache", thisfn, cache->path, g_list_length( items ));
+	*tree = items;
+
+	return( TRUE );
+}
+
+/*
+ * check the header, the validation key, and the stamps of the sources
+ */
+static gboolean
+read_header( FMAItemCache *cache, CacheReader *reader )
+{
+	const gchar *key, *path;
+	guint32 count, i;
+	CacheStamp stamp;
+	const CacheStamp *current;
+
+	if( reader->length < strlen( CACHE_MAGIC ) || memcmp( reader->data, CACHE_MAGIC, strlen( CACHE_MAGIC ))){
+		return( FALSE );
+	}
+	reader->offset = strlen( CACHE_MAGIC );
+
+	if( read_uint32( reader ) != CACHE_BYTE_ORDER || read_uint32( reader ) != CACHE_VERSION ){
+		return( FALSE );
+	}
+
+	key = read_string( reader );
+	if( !key || strcmp( key, cache->key )){
+		return( FALSE );
+	}
+
+	count = read_uint32( reader );
+	if( reader->error || count != g_hash_table_size( cache->stamps )){
+		return( FALSE );
+	}
+
+	for( i = 0 ; i < count && !reader->error ; ++i ){
+		path = read_string( reader );
+		stamp.size = read_uint64( reader );
+		stamp.mtime = ( gint64 ) read_uint64( reader );
+		stamp.ctime = ( gint64 ) read_uint64( reader );
+		stamp.inode = read_uint64( reader );
+
+		if( reader->error ){
+			return( FALSE );
+		}
+
+		current = g_hash_table_lookup( cache->stamps, path );
+
+		if( !current ||
+				current->size != stamp.size ||
+				current->mtime != stamp.mtime ||
+				current->ctime != stamp.ctime ||
+				current->inode != stamp.inode ){
+			g_debug( "fma_item_cache_read_header: %s: source has changed", path );
+			return( FALSE );
+		}
+	}
+
+	return( !reader->error );
+}
+
+/*
+ * rebuild an object, along with its subitems or its profiles
+ * returns %NULL and sets the error flag if the cache is not readable
+ */
+static FMAObject *
+read_object( FMAItemCache *cache, CacheReader *reader )
+{
+	guint32 kind, count, i;
+	const gchar *provider_id;
+	FMAIOProvider *provider;
+	FMAObject *object, *child;
+	GList *children;
+
+	kind = read_uint32( reader );
+	provider_id = read_string( reader );
+
+	if( reader->error ){
+		return( NULL );
+	}
+
+	switch( kind ){
+		case CACHE_OBJECT_MENU:
+			object = FMA_OBJECT( fma_object_menu_new());
+			break;
+
+		case CACHE_OBJECT_ACTION:
+			object = FMA_OBJECT( fma_object_action_new());
+			break;
+
+		case CACHE_OBJECT_PROFILE:
+			object = FMA_OBJECT( fma_object_profile_new());
+			break;
+
+		default:
+			reader->error = TRUE;
+			return( NULL );
+	}
+
+	if( FMA_IS_OBJECT_ITEM( object )){
+		provider = fma_io_provider_find_io_provider_by_id( cache->pivot, provider_id );
+		if( !provider ){
+			reader->error = TRUE;
+		} else {
+			fma_object_set_provider( object, provider );
+		}
+	}
+
+	read_data( reader, object );
+
+	children = NULL;
+	count = read_uint32( reader );
+
+	for( i = 0 ; i < count && !reader->error ; ++i ){
+		child = read_object( cache, reader );
+		if( child ){
+			fma_object_set_parent( child, object );
+			children = g_list_prepend( children, child );
+		}
+	}
+
+	if( FMA_IS_OBJECT_ITEM( object )){
+		fma_object_set_items( object, g_list_reverse( children ));
+
+	} else if( children ){
+		fma_object_free_items( children );
+		reader->error = TRUE;
+	}
+
+	if( reader->error ){
+		fma_object_unref( object );
+		object = NULL;
+	}
+
+	return( object );
+}
+
+/*
+ * strings are set from the mapped file, the FMADataBoxed taking its
+ * own copy of them
+ */
+static void
+read_data( CacheReader *reader, FMAObject *object )
+{
+	guint32 count, i, type, size, j;
+	const gchar *name, *str;
+	GSList *slist;
+	GList *ulist;
+
+	count = read_uint32( reader );
+
+	for( i = 0 ; i < count && !reader->error ; ++i ){
+		name = read_string( reader );
+		type = read_uint32( reader );
+
+		if( reader->error ){
+			return;
+		}
+
+		switch( type ){
+			case FMA_DATA_TYPE_BOOLEAN:
+			case FMA_DATA_TYPE_UINT:
+				fma_factory_object_set_from_void( FMA_IFACTORY_OBJECT( object ), name, GUINT_TO_POINTER( read_uint32( reader )));
+				break;
+
+			case FMA_DATA_TYPE_STRING:
+			case FMA_DATA_TYPE_LOCALE_STRING:
+				str = read_string( reader );
+				if( str ){
+					fma_factory_object_set_from_void( FMA_IFACTORY_OBJECT( object ), name, str );
+				}
+				break;
+
+			case FMA_DATA_TYPE_STRING_LIST:
+				slist = NULL;
+				size = read_uint32( reader );
+				for( j = 0 ; j < size && !reader->error ; ++j ){
+					str = read_string( reader );
+					if( str ){
+						slist = g_slist_prepend( slist, ( gpointer ) str );
+					}
+				}
+				if( !reader->error ){
+					slist = g_slist_reverse( slist );
+					fma_factory_object_set_from_void( FMA_IFACTORY_OBJECT( object ), name, slist );
+				}
+				g_slist_free( slist );
+				break;
+
+			case FMA_DATA_TYPE_UINT_LIST:
+				ulist = NULL;
+				size = read_uint32( reader );
+				for( j = 0 ; j < size && !reader->error ; ++j ){
+					ulist = g_list_prepend( ulist, GUINT_TO_POINTER( read_uint32( reader )));
+				}
+				if( !reader->error ){
+					ulist = g_list_reverse( ulist );
+					fma_factory_object_set_from_void( FMA_IFACTORY_OBJECT( object ), name, ulist );
+				}
+				g_list_free( ulist );
+				break;
+
+			default:
+				reader->error = TRUE;
+				break;
+		}
+	}
+}
+
+static guint32
+read_uint32( CacheReader *reader )
+{
+	guint32 value;
+
+	value = 0;
+
+	if( reader->error || reader->offset + sizeof( value ) > reader->length ){
+		reader->error = TRUE;
+
+	} else {
+		memcpy( &value, reader->data + reader->offset, sizeof( value ));
+		reader->offset += sizeof( value );
+	}
+
+	return( value );
+}
+
+static guint64
+read_uint64( CacheReader *reader )
+{
+	guint64 value;
+
+	value = 0;
+
+	if( reader->error || reader->offset + sizeof( value ) > reader->length ){
+		reader->error = TRUE;
+
+	} else {
+		memcpy( &value, reader->data + reader->offset, sizeof( value ));
+		reader->offset += sizeof( value );
+	}
+
+	return( value );
+}
+
+/*
+ * strings are written with their trailing null byte, so that they can
+ * be directly used from the mapped file
+ */
+static const gchar *
+read_string( CacheReader *reader )
+{
+	guint32 size;
+	const gchar *str;
+
+	str = NULL;
+	size = read_uint32( reader );
+
+	if( reader->error || size == 0 || size > reader->length - reader->offset ||
+			reader->data[reader->offset+size-1] != '\0' ){
+		reader->error = TRUE;
+
+	} else {
+		str = reader->data + reader->offset;
+		reader->offset += size;
+	}
+
+	return( str );
+}
+
+/*
+ * fma_item_cache_save:
+ * @cache: this #FMAItemCache structure.
+ * @tree: the tree of items, as returned by fma_io_provider_load_items().
+ *
+ * Writes the @tree to the cache file, along with the validation key and
+ * the stamps which have been computed when the @cache has been created.
+ */
+void
+fma_item_cache_save( FMAItemCache *cache, GList *tree )
+{
+	static const gchar *thisfn = "fma_item_cache_save";
+	GByteArray *out;
+	GHashTableIter iter;
+	const gchar *path;
+	const CacheStamp *stamp;
+	GList *it;
+	gchar *dir;
+	GError *error;
+
+	g_return_if_fail( cache != NULL );
+
+	if( !cache->stamps ){
+		return;
+	}
+
+	out = g_byte_array_new();
+
+	g_byte_array_append( out, ( const guint8 * ) CACHE_MAGIC, strlen( CACHE_MAGIC ));
+	write_uint32( out, CACHE_BYTE_ORDER );
+	write_uint32( out, CACHE_VERSION );
+	write_string( out, cache->key );
+
+	write_uint32( out, g_hash_table_size( cache->stamps ));
+	g_hash_table_iter_init( &iter, cache->stamps );
+	while( g_hash_table_iter_next( &iter, ( gpointer * ) &path, ( gpointer * ) &stamp )){
+		write_string( out, path );
+		write_uint64( out, stamp->size );
+		write_uint64( out, ( guint64 ) stamp->mtime );
+		write_uint64( out, ( guint64 ) stamp->ctime );
+		write_uint64( out, stamp->inode );
+	}
+
+	write_uint32( out, g_list_length( tree ));
+	for( it = tree ; it ; it = it->next ){
+		write_object( out, FMA_OBJECT( it->data ));
+	}
+
+	dir = g_path_get_dirname( cache->path );
+	g_mkdir_with_parents( dir, 0700 );
+	g_free( dir );
+
+	error = NULL;
+	if( !g_file_set_contents( cache->path, ( const gchar * ) out->data, out->len, &error )){
+		g_warning( "%s: %s: %s", thisfn, cache->path, error->message );
+		g_error_free( error );
+
+	} else {
+		g_debug( "%s: %s: %u bytes written", thisfn, cache->path, out->len );
+	}
+
+	g_byte_array_free( out, TRUE );
+}
+
+static void
+write_object( GByteArray *out, FMAObject *object )
+{
+	FMAIOProvider *provider;
+	gchar *provider_id;
+	guint count_offset;
+	CacheWriter writer;
+	GList *children, *it;
+
+	if( FMA_IS_OBJECT_MENU( object )){
+		write_uint32( out, CACHE_OBJECT_MENU );
+	} else if( FMA_IS_OBJECT_ACTION( object )){
+		write_uint32( out, CACHE_OBJECT_ACTION );
+	} else {
+		write_uint32( out, CACHE_OBJECT_PROFILE );
+	}
+
+	provider_id = NULL;
+	if( FMA_IS_OBJECT_ITEM( object )){
+		provider = ( FMAIOProvider * ) fma_object_get_provider( object );
+		if( provider ){
+			provider_id = fma_io_provider_get_id( provider );
+		}
+	}
+	write_string( out, provider_id ? provider_id : "" );
+	g_free( provider_id );
+
+	/* the count of data is only known after the iteration
+	 */
+	count_offset = out->len;
+	write_uint32( out, 0 );
+
+	writer.out = out;
+	writer.count = 0;
+	fma_factory_object_iter_on_boxed( FMA_IFACTORY_OBJECT( object ), ( FMAFactoryObjectIterBoxedFn ) write_data, &writer );
+	memcpy( out->data + count_offset, &writer.count, sizeof( writer.count ));
+
+	children = FMA_IS_OBJECT_ITEM( object ) ? fma_object_get_items( object ) : NULL;
+	write_uint32( out, g_list_length( children ));
+	for( it = children ; it ; it = it->next ){
+		write_object( out, FMA_OBJECT( it->data ));
+	}
+}
+
+/*
+ * pointers (parent, subitems, provider and provider data) cannot be
+ * cached: they are rebuilt when reading the tree, the provider data
+ * being left unset
+ */
+static gboolean
+write_data( const FMAIFactoryObject *object, FMADataBoxed *boxed, CacheWriter *writer )
+{
+	const FMADataDef *def;
+	void *value;
+	GSList *is;
+	GList *iu;
+
+	def = fma_data_boxed_get_data_def( boxed );
+
+	switch( def->type ){
+		case FMA_DATA_TYPE_BOOLEAN:
+		case FMA_DATA_TYPE_UINT:
+		case FMA_DATA_TYPE_STRING:
+		case FMA_DATA_TYPE_LOCALE_STRING:
+		case FMA_DATA_TYPE_STRING_LIST:
+		case FMA_DATA_TYPE_UINT_LIST:
+			break;
+
+		default:
+			return( FALSE );
+	}
+
+	write_string( writer->out, def->name );
+	write_uint32( writer->out, def->type );
+	writer->count += 1;
+
+	value = fma_boxed_get_as_void( FMA_BOXED( boxed ));
+
+	switch( def->type ){
+		case FMA_DATA_TYPE_BOOLEAN:
+		case FMA_DATA_TYPE_UINT:
+			write_uint32( writer->out, GPOINTER_TO_UINT( value ));
+			break;
+
+		case FMA_DATA_TYPE_STRING:
+		case FMA_DATA_TYPE_LOCALE_STRING:
+			write_string( writer->out, value ? ( const gchar * ) value : "" );
+			g_free( value );
+			break;
+
+		case FMA_DATA_TYPE_STRING_LIST:
+			write_uint32( writer->out, g_slist_length(( GSList * ) value ));
+			for( is = ( GSList * ) value ; is ; is = is->next ){
+				write_string( writer->out, ( const gchar * ) is->data );
+			}
+			fma_core_utils_slist_free(( GSList * ) value );
+			break;
+
+		case FMA_DATA_TYPE_UINT_LIST:
+			write_uint32( writer->out, g_list_length(( GList * ) value ));
+			for( iu = ( GList * ) value ; iu ; iu = iu->next ){
+				write_uint32( writer->out, GPOINTER_TO_UINT( iu->data ));
+			}
+			g_list_free(( GList * ) value );
+			break;
+	}
+
+	return( FALSE );
+}
+
+static void
+write_uint32( GByteArray *out, guint32 value )
+{
+	g_byte_array_append( out, ( const guint8 * ) &value, sizeof( value ));
+}
+
+static void
+write_uint64( GByteArray *out, guint64 value )
+{
+	g_byte_array_append( out, ( const guint8 * ) &value, sizeof( value ));
+}
+
+static void
+write_string( GByteArray *out, const gchar *str )
+{
+	guint32 size;
+
+	size = strlen( str ) + 1;
+	write_uint32( out, size );
+	g_byte_array_append( out, ( const guint8 * ) str, size );
+}
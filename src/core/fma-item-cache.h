@@ -0,0 +1,87 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_ITEM_CACHE_H__
+#define __CORE_FMA_ITEM_CACHE_H__
+
+/* @title: FMAItemCache
+ * @short_description: The FMAItemCache Structure Definition
+ * @include: core/fma-item-cache.h
+ *
+ * The FMAItemCache is a binary on-disk image of the tree of items, as
+ * it has been loaded, merged, sorted and filtered by
+ * fma_io_provider_load_items().
+ *
+ * The cache file is mapped in memory when loading, so that the items
+ * may be rebuilt without having to parse any of their sources.
+ *
+ * The cache file lives in $XDG_RUNTIME_DIR. Each process of the user
+ * (file manager plugins, fma-run) maps it and builds its own tree of
+ * items: no memory is shared between them. As the file is atomically
+ * replaced when saved, it is read without any lock; only the processes
+ * which rewrite it are serialized by fma_item_cache_lock(), which never
+ * waits. The cache is also rewritten after the items have been
+ * incrementally reloaded on I/O provider changes.
+ *
+ * The cache is validated against:
+ * - the version of the cache format and of the package;
+ * - the preferences which drive the building of the tree (loadable set,
+ *   readable I/O providers, level-zero order, order mode) and the
+ *   current locale;
+ * - the size, modification and change times, and inode of each source
+ *   path reported by the readable I/O providers; a directory is
+ *   modified as soon as a file is added, removed or renamed.
+ *
+ * Items loaded from the cache do not carry any I/O provider specific
+ * data: they can be displayed and executed, but not written back. The
+ * cache is so only used by the consumers which have asked for it (see
+ * fma_pivot_set_cacheable()).
+ *
+ * The cache is disabled as soon as a readable I/O provider doesn't
+ * implement the FMAIIOProvider::get_sources() method.
+ */
+
+#include "fma-pivot.h"
+
+G_BEGIN_DECLS
+
+typedef struct _FMAItemCache FMAItemCache;
+
+FMAItemCache *fma_item_cache_new   ( const FMAPivot *pivot, guint loadable_set );
+void          fma_item_cache_free  ( FMAItemCache *cache );
+
+gboolean      fma_item_cache_lock  ( FMAItemCache *cache );
+void          fma_item_cache_unlock( FMAItemCache *cache );
+
+gboolean      fma_item_cache_load  ( FMAItemCache *cache, GList **tree );
+void          fma_item_cache_save  ( FMAItemCache *cache, GList *tree );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_ITEM_CACHE_H__ */
@@ -0,0 +1,463 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <api/fma-core-utils.h>
+
+#include "fma-job-runner.h"
+#include "fma-settings.h"
+
+/* private class data
+ */
+struct _FMAJobRunnerClassPrivate {
+	void *empty;						/* so that gcc -pedantic is happy */
+};
+
+/* a job is the execution of an action
+ */
+typedef struct {
+	guint               id;
+	gchar              *label;
+	FMAJobRunnerTaskFns fns;
+	GQueue             *pending;		/* the data of the not yet spawned tasks */
+	guint               running;
+}
+	Job;
+
+/* the data passed to the child watch function
+ */
+typedef struct {
+	FMAJobRunner *runner;
+	Job          *job;
+	gpointer      data;
+}
+	RunningTask;
+
+/* private instance data
+ */
+struct _FMAJobRunnerPrivate {
+	gboolean    dispose_has_run;
+	guint       max_parallel;
+	guint       running;				/* count of running tasks, all jobs included */
+	guint       last_id;
+	GQueue     *queue;					/* the jobs which have pending tasks, in FIFO order */
+	GHashTable *jobs;					/* all alive jobs, indexed by their id */
+	GMainLoop  *loop;					/* when waiting for the pending tasks */
+};
+
+static GObjectClass *st_parent_class = NULL;
+static FMAJobRunner *st_runner       = NULL;
+
+static GType    register_type( void );
+static void     class_init( FMAJobRunnerClass *klass );
+static void     instance_init( GTypeInstance *instance, gpointer klass );
+static void     instance_dispose( GObject *object );
+static void     instance_finalize( GObject *object );
+
+static void     job_end_task( FMAJobRunner *runner, Job *job );
+static void     job_free( Job *job );
+static void     on_child_exited( GPid pid, gint status, RunningTask *task );
+static void     on_settings_max_parallel_changed( const gchar *group, const gchar *key, gconstpointer new_value, gboolean mandatory, FMAJobRunner *runner );
+static void     schedule( FMAJobRunner *runner );
+
+GType
+fma_job_runner_get_type( void )
+{
+	static GType object_type = 0;
+
+	if( !object_type ){
+		object_type = register_type();
+	}
+
+	return( object_type );
+}
+
+static GType
+register_type( void )
+{
+	static const gchar *thisfn = "fma_job_runner_register_type";
+	GType type;
+
+	static GTypeInfo info = {
+		sizeof( FMAJobRunnerClass ),
+		( GBaseInitFunc ) NULL,
+		( GBaseFinalizeFunc ) NULL,
+		( GClassInitFunc ) class_init,
+		NULL,
+		NULL,
+		sizeof( FMAJobRunner ),
+		0,
+		( GInstanceInitFunc ) instance_init
+	};
+
+	g_debug( "%s", thisfn );
+
+	type = g_type_register_static( G_TYPE_OBJECT, "FMAJobRunner", &info, 0 );
+
+	return( type );
+}
+
+static void
+class_init( FMAJobRunnerClass *klass )
+{
+	static const gchar *thisfn = "fma_job_runner_class_init";
+	GObjectClass *object_class;
+
+	g_debug( "%s: klass=%p", thisfn, ( void * ) klass );
+
+	st_parent_class = g_type_class_peek_parent( klass );
+
+	object_class = G_OBJECT_CLASS( klass );
+	object_class->dispose = instance_dispose;
+	object_class->finalize = instance_finalize;
+
+	klass->private = g_new0( FMAJobRunnerClassPrivate, 1 );
+}
+
+static void
+instance_init( GTypeInstance *instance, gpointer klass )
+{
+	static const gchar *thisfn = "fma_job_runner_instance_init";
+	FMAJobRunner *self;
+
+	g_return_if_fail( FMA_IS_JOB_RUNNER( instance ));
+
+	g_debug( "%s: instance=%p (%s), klass=%p",
+			thisfn, ( void * ) instance, G_OBJECT_TYPE_NAME( instance ), ( void * ) klass );
+
+	self = FMA_JOB_RUNNER( instance );
+
+	self->private = g_new0( FMAJobRunnerPrivate, 1 );
+
+	self->private->dispose_has_run = FALSE;
+	self->private->max_parallel = 0;
+	self->private->running = 0;
+	self->private->last_id = 0;
+	self->private->queue = g_queue_new();
+	self->private->jobs = g_hash_table_new_full( NULL, NULL, NULL, ( GDestroyNotify ) job_free );
+	self->private->loop = NULL;
+}
+
+static void
+instance_dispose( GObject *object )
+{
+	static const gchar *thisfn = "fma_job_runner_instance_dispose";
+	FMAJobRunner *self;
+
+	g_return_if_fail( FMA_IS_JOB_RUNNER( object ));
+
+	self = FMA_JOB_RUNNER( object );
+
+	if( !self->private->dispose_has_run ){
+
+		g_debug( "%s: object=%p (%s)", thisfn, ( void * ) object, G_OBJECT_TYPE_NAME( object ));
+
+		self->private->dispose_has_run = TRUE;
+
+		if( G_OBJECT_CLASS( st_parent_class )->dispose ){
+			G_OBJECT_CLASS( st_parent_class )->dispose( object );
+		}
+	}
+}
+
+static void
+instance_finalize( GObject *object )
+{
+	static const gchar *thisfn = "fma_job_runner_instance_finalize";
+	FMAJobRunner *self;
+
+	g_return_if_fail( FMA_IS_JOB_RUNNER( object ));
+
+	g_debug( "%s: object=%p (%s)", thisfn, ( void * ) object, G_OBJECT_TYPE_NAME( object ));
+
+	self = FMA_JOB_RUNNER( object );
+
+	g_queue_free( self->private->queue );
+	g_hash_table_destroy( self->private->jobs );
+
+	g_free( self->private );
+
+	/* chain call to parent class */
+	if( G_OBJECT_CLASS( st_parent_class )->finalize ){
+		G_OBJECT_CLASS( st_parent_class )->finalize( object );
+	}
+}
+
+/*
+ * fma_job_runner_get_default:
+ *
+ * Returns: the #FMAJobRunner singleton, allocating it on first call.
+ * The returned object is owned by the class, and should not be released
+ * by the caller.
+ */
+FMAJobRunner *
+fma_job_runner_get_default( void )
+{
+	if( !st_runner ){
+		st_runner = g_object_new( FMA_TYPE_JOB_RUNNER, NULL );
+		st_runner->private->max_parallel = fma_settings_get_uint( IPREFS_EXEC_MAX_PARALLEL, NULL, NULL );
+
+		fma_settings_register_key_callback(
+				IPREFS_EXEC_MAX_PARALLEL, G_CALLBACK( on_settings_max_parallel_changed ), st_runner );
+	}
+
+	return( st_runner );
+}
+
+/*
+ * fma_job_runner_get_max_parallel:
+ * @runner: this #FMAJobRunner instance.
+ *
+ * Returns: the maximum count of tasks which may run at the same time.
+ */
+guint
+fma_job_runner_get_max_parallel( const FMAJobRunner *runner )
+{
+	guint max_parallel;
+
+	g_return_val_if_fail( FMA_IS_JOB_RUNNER( runner ), 1 );
+
+	max_parallel = runner->private->max_parallel;
+
+	if( !max_parallel ){
+		max_parallel = fma_core_utils_get_processors_count();
+	}
+
+	return( max_parallel );
+}
+
+/*
+ * fma_job_runner_set_max_parallel:
+ * @runner: this #FMAJobRunner instance.
+ * @max_parallel: the maximum count of tasks which may run at the same
+ *  time; zero stands for the count of available processors.
+ *
+ * Raising the limit immediately spawns the pending tasks which now fit
+ * in; lowering it does not interrupt the already running tasks.
+ */
+void
+fma_job_runner_set_max_parallel( FMAJobRunner *runner, guint max_parallel )
+{
+	g_return_if_fail( FMA_IS_JOB_RUNNER( runner ));
+
+	if( !runner->private->dispose_has_run ){
+
+		runner->private->max_parallel = max_parallel;
+		schedule( runner );
+	}
+}
+
+/*
+ * fma_job_runner_submit:
+ * @runner: this #FMAJobRunner instance.
+ * @label: a label which identifies the job in the debug messages.
+ * @tasks: a list of task data, which is taken over by the runner.
+ * @fns: the functions which manage these tasks.
+ *
+ * Queues a new job, and spawns as many of its tasks as the maximum count
+ * of parallel tasks allows. The jobs are served in FIFO order: the tasks
+ * of a job are only spawned once those of the previous jobs have all
+ * been spawned.
+ *
+ * Returns: the identifier of the new job, or zero if @tasks is empty.
+ */
+guint
+fma_job_runner_submit( FMAJobRunner *runner, const gchar *label, GList *tasks, const FMAJobRunnerTaskFns *fns )
+{
+	static const gchar *thisfn = "fma_job_runner_submit";
+	Job *job;
+	GList *it;
+
+	g_return_val_if_fail( FMA_IS_JOB_RUNNER( runner ), 0 );
+	g_return_val_if_fail( fns && fns->spawn, 0 );
+
+	if( runner->private->dispose_has_run || !tasks ){
+		return( 0 );
+	}
+
+	job = g_new0( Job, 1 );
+	job->id = ++runner->private->last_id;
+	job->label = g_strdup( label );
+	job->fns = *fns;
+	job->pending = g_queue_new();
+
+	for( it = tasks ; it ; it = it->next ){
+		g_queue_push_tail( job->pending, it->data );
+	}
+	g_list_free( tasks );
+
+	job->running = 0;
+
+	g_debug( "%s: runner=%p, job=%u, label=%s, tasks=%u",
+			thisfn, ( void * ) runner, job->id, job->label, g_queue_get_length( job->pending ));
+
+	g_hash_table_insert( runner->private->jobs, GUINT_TO_POINTER( job->id ), job );
+	g_queue_push_tail( runner->private->queue, job );
+
+	schedule( runner );
+
+	return( job->id );
+}
+
+/*
+ * fma_job_runner_wait_pending:
+ * @runner: this #FMAJobRunner instance.
+ *
+ * Runs a main loop until all queued tasks have been spawned.
+ *
+ * This is needed by a program which is about to exit, as pending tasks
+ * would else be lost. Already spawned processes are not waited for.
+ */
+void
+fma_job_runner_wait_pending( FMAJobRunner *runner )
+{
+	g_return_if_fail( FMA_IS_JOB_RUNNER( runner ));
+
+	if( !runner->private->dispose_has_run && !g_queue_is_empty( runner->private->queue )){
+
+		runner->private->loop = g_main_loop_new( NULL, FALSE );
+		g_main_loop_run( runner->private->loop );
+		g_main_loop_unref( runner->private->loop );
+		runner->private->loop = NULL;
+	}
+}
+
+/*
+ * spawns the pending tasks of the jobs, in FIFO order, while the maximum
+ * count of parallel tasks is not reached
+ *
+ * the head job is looked up again for each task, as a job whose last
+ * task cannot be spawned is freed by job_end_task()
+ */
+static void
+schedule( FMAJobRunner *runner )
+{
+	static const gchar *thisfn = "fma_job_runner_schedule";
+	guint max_parallel;
+	Job *job;
+	RunningTask *task;
+	gpointer data;
+	GPid pid;
+
+	max_parallel = fma_job_runner_get_max_parallel( runner );
+
+	while( runner->private->running < max_parallel && !g_queue_is_empty( runner->private->queue )){
+
+		job = ( Job * ) g_queue_peek_head( runner->private->queue );
+		data = g_queue_pop_head( job->pending );
+		if( g_queue_is_empty( job->pending )){
+			g_queue_pop_head( runner->private->queue );
+		}
+
+		pid = job->fns.spawn( data );
+
+		if( pid == ( GPid ) 0 ){
+			g_debug( "%s: job=%u: unable to spawn the task", thisfn, job->id );
+			if( job->fns.free ){
+				job->fns.free( data );
+			}
+			job_end_task( runner, job );
+
+		} else {
+			task = g_new0( RunningTask, 1 );
+			task->runner = runner;
+			task->job = job;
+			task->data = data;
+
+			job->running += 1;
+			runner->private->running += 1;
+			g_child_watch_add( pid, ( GChildWatchFunc ) on_child_exited, task );
+		}
+	}
+
+	if( runner->private->loop && g_queue_is_empty( runner->private->queue )){
+		g_main_loop_quit( runner->private->loop );
+	}
+}
+
+static void
+on_child_exited( GPid pid, gint status, RunningTask *task )
+{
+	static const gchar *thisfn = "fma_job_runner_on_child_exited";
+	FMAJobRunner *runner;
+	Job *job;
+
+	runner = task->runner;
+	job = task->job;
+
+	g_debug( "%s: job=%u, pid=%u, status=%d", thisfn, job->id, ( guint ) pid, status );
+
+	g_spawn_close_pid( pid );
+
+	if( job->fns.done ){
+		job->fns.done( pid, status, task->data );
+	}
+	if( job->fns.free ){
+		job->fns.free( task->data );
+	}
+	g_free( task );
+
+	job->running -= 1;
+	runner->private->running -= 1;
+	job_end_task( runner, job );
+
+	schedule( runner );
+}
+
+/*
+ * a task of the job has terminated, or has not been able to be spawned:
+ * the job is released with its last task
+ */
+static void
+job_end_task( FMAJobRunner *runner, Job *job )
+{
+	static const gchar *thisfn = "fma_job_runner_job_end_task";
+
+	if( g_queue_is_empty( job->pending ) && !job->running ){
+		g_debug( "%s: job=%u: finished", thisfn, job->id );
+		g_hash_table_remove( runner->private->jobs, GUINT_TO_POINTER( job->id ));
+	}
+}
+
+static void
+job_free( Job *job )
+{
+	g_free( job->label );
+	g_queue_free( job->pending );
+	g_free( job );
+}
+
+static void
+on_settings_max_parallel_changed( const gchar *group, const gchar *key, gconstpointer new_value, gboolean mandatory, FMAJobRunner *runner )
+{
+	fma_job_runner_set_max_parallel( runner, GPOINTER_TO_UINT( new_value ));
+}
@@ -0,0 +1,115 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_JOB_RUNNER_H__
+#define __CORE_FMA_JOB_RUNNER_H__
+
+/* @title: FMAJobRunner
+ * @short_description: The #FMAJobRunner Class Definition
+ * @include: core/fma-job-runner.h
+ *
+ * The #FMAJobRunner class schedules the execution of the actions.
+ *
+ * Executing an action is a job, which is made of one task for each
+ * command to be spawned: a plural form command is a single task, while
+ * a singular form command has as many tasks than the count of selected
+ * items.
+ *
+ * The runner spawns at most 'max-parallel' tasks at the same time, all
+ * jobs included, and queues the others. The jobs are served in FIFO
+ * order.
+ *
+ * The maximum count of parallel tasks is read from the
+ * IPREFS_EXEC_MAX_PARALLEL preference; zero stands for the count of
+ * available processors.
+ *
+ * #FMAJobRunner class defines a singleton object, which allocates itself
+ * when needed.
+ */
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define FMA_TYPE_JOB_RUNNER                ( fma_job_runner_get_type())
+#define FMA_JOB_RUNNER( object )           ( G_TYPE_CHECK_INSTANCE_CAST( object, FMA_TYPE_JOB_RUNNER, FMAJobRunner ))
+#define FMA_JOB_RUNNER_CLASS( klass )      ( G_TYPE_CHECK_CLASS_CAST( klass, FMA_TYPE_JOB_RUNNER, FMAJobRunnerClass ))
+#define FMA_IS_JOB_RUNNER( object )        ( G_TYPE_CHECK_INSTANCE_TYPE( object, FMA_TYPE_JOB_RUNNER ))
+#define FMA_IS_JOB_RUNNER_CLASS( klass )   ( G_TYPE_CHECK_CLASS_TYPE(( klass ), FMA_TYPE_JOB_RUNNER ))
+#define FMA_JOB_RUNNER_GET_CLASS( object ) ( G_TYPE_INSTANCE_GET_CLASS(( object ), FMA_TYPE_JOB_RUNNER, FMAJobRunnerClass ))
+
+typedef struct _FMAJobRunnerPrivate       FMAJobRunnerPrivate;
+
+typedef struct {
+	/*< private >*/
+	GObject              parent;
+	FMAJobRunnerPrivate *private;
+}
+	FMAJobRunner;
+
+typedef struct _FMAJobRunnerClassPrivate  FMAJobRunnerClassPrivate;
+
+typedef struct {
+	/*< private >*/
+	GObjectClass              parent;
+	FMAJobRunnerClassPrivate *private;
+}
+	FMAJobRunnerClass;
+
+/*
+ * FMAJobRunnerTaskFns:
+ * @spawn: spawns the task; returns the pid of the child process, or zero
+ *  if the task has not been able to be spawned.
+ * @done: called when the child process has terminated, with its exit status.
+ * @free: releases the task data.
+ *
+ * The functions which manage the tasks of a job.
+ * All tasks of a job share the same functions, and only differ by their
+ * data.
+ */
+typedef struct {
+	GPid ( *spawn )( gpointer task_data );
+	void ( *done ) ( GPid pid, gint status, gpointer task_data );
+	void ( *free ) ( gpointer task_data );
+}
+	FMAJobRunnerTaskFns;
+
+GType         fma_job_runner_get_type        ( void );
+
+FMAJobRunner *fma_job_runner_get_default     ( void );
+
+guint         fma_job_runner_get_max_parallel( const FMAJobRunner *runner );
+void          fma_job_runner_set_max_parallel( FMAJobRunner *runner, guint max_parallel );
+
+guint         fma_job_runner_submit          ( FMAJobRunner *runner, const gchar *label, GList *tasks, const FMAJobRunnerTaskFns *fns );
+void          fma_job_runner_wait_pending    ( FMAJobRunner *runner );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_JOB_RUNNER_H__ */
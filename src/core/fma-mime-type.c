@@ -0,0 +1,184 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gio/gio.h>
+#include <string.h>
+
+#include "fma-mime-type.h"
+
+/* what we know about an interned mimetype
+ */
+typedef struct {
+	FMAMimeTypeClass class;
+	gchar           *content_type;
+	GHashTable      *is_a;				/* interned file mimetype -> GUINT_TO_POINTER( is_a+1 ) */
+}
+	MimeTypeInfo;
+
+G_LOCK_DEFINE_STATIC( st_mime_types );
+
+static GHashTable *st_mime_types = NULL;	/* interned mimetype -> MimeTypeInfo */
+
+static MimeTypeInfo    *get_info( const gchar *interned );
+static FMAMimeTypeClass get_class( const gchar *mimetype );
+static void             info_free( MimeTypeInfo *info );
+
+/*
+ * fma_mime_type_get_class:
+ * @mimetype: a mimetype condition.
+ *
+ * Returns: whether the @mimetype condition covers all mimetypes, or all
+ * regular files, or something else.
+ */
+FMAMimeTypeClass
+fma_mime_type_get_class( const gchar *mimetype )
+{
+	FMAMimeTypeClass class;
+
+	g_return_val_if_fail( mimetype != NULL, MIME_TYPE_CLASS_OTHER );
+
+	G_LOCK( st_mime_types );
+	class = get_info( g_intern_string( mimetype ))->class;
+	G_UNLOCK( st_mime_types );
+
+	return( class );
+}
+
+/*
+ * fma_mime_type_is_a:
+ * @ftype: the mimetype of a file.
+ * @mimetype: a mimetype condition.
+ *
+ * Content type is the same as the mime type in *nix, though this is not
+ * true on Win32 platforms: so compare the content types.
+ *
+ * Returns: %TRUE if the @ftype is 'a sort of' @mimetype, e.g. "image/jpeg"
+ * is clearly a sort of "image/ *".
+ *
+ * The 'all' and 'allfiles' classes are not taken into account here.
+ */
+gboolean
+fma_mime_type_is_a( const gchar *ftype, const gchar *mimetype )
+{
+	static const gchar *thisfn = "fma_mime_type_is_a";
+	MimeTypeInfo *def_info, *file_info;
+	const gchar *file_interned;
+	gpointer value;
+	gboolean is_type_of;
+
+	g_return_val_if_fail( ftype != NULL, FALSE );
+	g_return_val_if_fail( mimetype != NULL, FALSE );
+
+	G_LOCK( st_mime_types );
+
+	def_info = get_info( g_intern_string( mimetype ));
+	file_interned = g_intern_string( ftype );
+	value = g_hash_table_lookup( def_info->is_a, file_interned );
+
+	if( value ){
+		is_type_of = ( GPOINTER_TO_UINT( value ) > 1 );
+
+	} else {
+		is_type_of = FALSE;
+		file_info = get_info( file_interned );
+
+		if( file_info->content_type && def_info->content_type ){
+			is_type_of = g_content_type_is_a( file_info->content_type, def_info->content_type );
+			g_debug( "%s: def_mimetype=%s content_type=%s file_mimetype=%s content_type=%s is_a=%s",
+					thisfn, mimetype, def_info->content_type, ftype, file_info->content_type,
+					is_type_of ? "True":"False" );
+		}
+
+		g_hash_table_insert( def_info->is_a, ( gpointer ) file_interned, GUINT_TO_POINTER( is_type_of+1 ));
+	}
+
+	G_UNLOCK( st_mime_types );
+
+	return( is_type_of );
+}
+
+/*
+ * must be called with the lock held
+ */
+static MimeTypeInfo *
+get_info( const gchar *interned )
+{
+	MimeTypeInfo *info;
+
+	if( !st_mime_types ){
+		st_mime_types = g_hash_table_new_full( g_direct_hash, g_direct_equal, NULL, ( GDestroyNotify ) info_free );
+	}
+
+	info = ( MimeTypeInfo * ) g_hash_table_lookup( st_mime_types, interned );
+
+	if( !info ){
+		info = g_new0( MimeTypeInfo, 1 );
+		info->class = get_class( interned );
+		info->content_type = g_content_type_from_mime_type( interned );
+		info->is_a = g_hash_table_new( g_direct_hash, g_direct_equal );
+		g_hash_table_insert( st_mime_types, ( gpointer ) interned, info );
+	}
+
+	return( info );
+}
+
+static FMAMimeTypeClass
+get_class( const gchar *mimetype )
+{
+	if( !strcmp( mimetype, "*" ) ||
+		!strcmp( mimetype, "*/*" ) ||
+		!strcmp( mimetype, "*/all" ) ||	/* should be considered as invalid */
+		!strcmp( mimetype, "all" ) ||
+		!strcmp( mimetype, "all/*" ) ||
+		!strcmp( mimetype, "all/all" )){
+			return( MIME_TYPE_CLASS_ALL );
+	}
+
+	if( !strcmp( mimetype, "allfiles" ) ||
+		!strcmp( mimetype, "*/allfiles" ) ||	/* should be considered as invalid */
+		!strcmp( mimetype, "allfiles/*" ) ||
+		!strcmp( mimetype, "allfiles/all" ) ||
+		!strcmp( mimetype, "all/allfiles" )){
+			return( MIME_TYPE_CLASS_ALLFILES );
+	}
+
+	return( MIME_TYPE_CLASS_OTHER );
+}
+
+static void
+info_free( MimeTypeInfo *info )
+{
+	g_free( info->content_type );
+	g_hash_table_destroy( info->is_a );
+	g_free( info );
+}
@@ -0,0 +1,62 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_MIME_TYPE_H__
+#define __CORE_FMA_MIME_TYPE_H__
+
+/* @title: FMAMimeType
+ * @short_description: The process-wide mimetype cache
+ * @include: core/fma-mime-type.h
+ *
+ * Mimetypes conditions are checked against the mimetype of each selected
+ * item each time the file manager builds its menu. Both the conditions
+ * and the mimetypes of the selected items are in practice a rather small
+ * set of strings, which are so interned here, along with:
+ * - the classification of each condition (all, all files, other),
+ * - the content type of each mimetype,
+ * - the memoized 'is a' relation between a file mimetype and a condition.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum {
+	MIME_TYPE_CLASS_OTHER = 0,
+	MIME_TYPE_CLASS_ALL,
+	MIME_TYPE_CLASS_ALLFILES
+}
+	FMAMimeTypeClass;
+
+FMAMimeTypeClass fma_mime_type_get_class( const gchar *mimetype );
+gboolean         fma_mime_type_is_a     ( const gchar *ftype, const gchar *mimetype );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_MIME_TYPE_H__ */
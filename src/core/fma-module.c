@@ -49,6 +49,9 @@ struct _FMAModulePrivate {
 	gboolean  dispose_has_run;
 	gchar    *path;						/* full pathname of the plugin */
 	gchar    *name;						/* basename without the extension */
+	gchar   **interfaces;				/* as declared in the manifest, if any */
+	gboolean  loaded;
+	gboolean  failed;
 	GModule  *library;
 	GList    *objects;
 
@@ -69,6 +72,9 @@ static void       instance_dispose( GObject *object );
 static void       instance_finalize( GObject *object );
 
 static FMAModule *module_new( const gchar *filename );
+static FMAModule *module_new_lazy( const gchar *fname, const gchar *manifest );
+static gboolean   module_load( FMAModule *module );
+static gboolean   module_provides( const FMAModule *module, GType type );
 static gboolean   on_module_load( GTypeModule *gmodule );
 static gboolean   is_a_na_plugin( FMAModule *module );
 static gboolean   plugin_check( FMAModule *module, const gchar *symbol, gpointer *pfn );
@@ -191,6 +197,7 @@ instance_finalize( GObject *object )
 
 	g_free( self->private->path );
 	g_free( self->private->name );
+	g_strfreev( self->private->interfaces );
 
 	g_free( self->private );
 
@@ -214,6 +221,7 @@ fma_module_dump( const FMAModule *module )
 
 	g_debug( "%s:    path=%s", thisfn, module->private->path );
 	g_debug( "%s:    name=%s", thisfn, module->private->name );
+	g_debug( "%s:  loaded=%s", thisfn, module->private->loaded ? "True":"False" );
 	g_debug( "%s: library=%p", thisfn, ( void * ) module->private->library );
 	g_debug( "%s: objects=%p (count=%d)", thisfn, ( void * ) module->private->objects, g_list_length( module->private->objects ));
 	for( iobj = module->private->objects ; iobj ; iobj = iobj->next ){
@@ -226,8 +234,14 @@ fma_module_dump( const FMAModule *module )
  *
  * Load availables dynamically loadable extension libraries (plugins).
  *
+ * A plugin which is installed with a manifest (a 'libname.manifest' key
+ * file next to the 'libname.so' library) is not loaded here: the manifest
+ * declares the interfaces the plugin implements, and the library is only
+ * opened when fma_module_get_extensions_for_type() is first asked for one
+ * of them. Plugins without a manifest are loaded immediately, as before.
+ *
  * Returns: a #GList of #FMAModule, each object representing a dynamically
- * loaded library. The list should be fma_module_release_modules() by the
+ * loadable library. The list should be fma_module_release_modules() by the
  * caller after use.
  */
 GList *
@@ -240,7 +254,7 @@ fma_module_load_modules( void )
 	GDir *api_dir;
 	GError *error;
 	const gchar *entry;
-	gchar *fname;
+	gchar *fname, *name, *manifest;
 	FMAModule *module;
 
 	g_debug( "%s", thisfn );
@@ -258,12 +272,20 @@ fma_module_load_modules( void )
 		while(( entry = g_dir_read_name( api_dir )) != NULL ){
 			if( g_str_has_suffix( entry, suffix )){
 				fname = g_build_filename( dirname, entry, NULL );
-				module = module_new( fname );
+				name = fma_core_utils_str_remove_suffix( entry, suffix );
+				manifest = g_strdup_printf( "%s%c%s%s", dirname, G_DIR_SEPARATOR, name, FMA_MODULE_MANIFEST_SUFFIX );
+				module = module_new_lazy( fname, manifest );
+				if( !module ){
+					module = module_new( fname );
+				}
 				if( module ){
-					module->private->name = fma_core_utils_str_remove_suffix( entry, suffix );
+					module->private->name = name;
 					modules = g_list_prepend( modules, module );
-					g_debug( "%s: module %s successfully loaded", thisfn, entry );
+					g_debug( "%s: module %s successfully %s", thisfn, entry, module->private->loaded ? "loaded" : "registered" );
+				} else {
+					g_free( name );
 				}
+				g_free( manifest );
 				g_free( fname );
 			}
 		}
@@ -284,16 +306,112 @@ module_new( const gchar *fname )
 	module = g_object_new( FMA_TYPE_MODULE, NULL );
 	module->private->path = g_strdup( fname );
 
-	if( !g_type_module_use( G_TYPE_MODULE( module )) || !is_a_na_plugin( module )){
+	if( !module_load( module )){
 		g_object_unref( module );
 		return( NULL );
 	}
 
-	register_module_types( module );
+	return( module );
+}
+
+/*
+ * @fname: full pathname of the dynamic library.
+ * @manifest: full pathname of its manifest.
+ *
+ * Returns: a not-yet loaded #FMAModule if the manifest exists and declares
+ * at least one interface, %NULL else.
+ */
+static FMAModule *
+module_new_lazy( const gchar *fname, const gchar *manifest )
+{
+	static const gchar *thisfn = "fma_module_module_new_lazy";
+	FMAModule *module;
+	GKeyFile *key_file;
+	GError *error;
+	gchar **interfaces;
+
+	if( !g_file_test( manifest, G_FILE_TEST_IS_REGULAR )){
+		return( NULL );
+	}
+
+	module = NULL;
+	error = NULL;
+	key_file = g_key_file_new();
+
+	if( !g_key_file_load_from_file( key_file, manifest, G_KEY_FILE_NONE, &error )){
+		g_warning( "%s: %s: %s", thisfn, manifest, error->message );
+		g_error_free( error );
+
+	} else {
+		interfaces = g_key_file_get_string_list(
+				key_file, FMA_MODULE_MANIFEST_GROUP, FMA_MODULE_MANIFEST_INTERFACES, NULL, NULL );
+
+		if( interfaces && interfaces[0] ){
+			module = g_object_new( FMA_TYPE_MODULE, NULL );
+			module->private->path = g_strdup( fname );
+			module->private->interfaces = interfaces;
+
+		} else {
+			g_debug( "%s: %s: no declared interface", thisfn, manifest );
+			g_strfreev( interfaces );
+		}
+	}
+
+	g_key_file_free( key_file );
 
 	return( module );
 }
 
+/*
+ * Actually opens the library, checks that it is a FileManager-Actions
+ * plugin, and allocates the objects it provides.
+ * A failure is remembered so that the library is not tried again.
+ */
+static gboolean
+module_load( FMAModule *module )
+{
+	static const gchar *thisfn = "fma_module_module_load";
+
+	if( !module->private->loaded && !module->private->failed ){
+
+		g_debug( "%s: path=%s", thisfn, module->private->path );
+
+		if( !g_type_module_use( G_TYPE_MODULE( module ))){
+			module->private->failed = TRUE;
+
+		} else if( !is_a_na_plugin( module )){
+			g_type_module_unuse( G_TYPE_MODULE( module ));
+			module->private->failed = TRUE;
+
+		} else {
+			register_module_types( module );
+			module->private->loaded = TRUE;
+		}
+	}
+
+	return( module->private->loaded );
+}
+
+/*
+ * Returns: %TRUE if the manifest of the (not yet loaded) @module declares
+ * an interface which is, or derives from, @type.
+ */
+static gboolean
+module_provides( const FMAModule *module, GType type )
+{
+	gchar **iface;
+	GType iface_type;
+
+	for( iface = module->private->interfaces ; iface && *iface ; iface++ ){
+		iface_type = g_type_from_name( g_strstrip( *iface ));
+		if( iface_type && g_type_is_a( iface_type, type )){
+			return( TRUE );
+		}
+	}
+
+	return( FALSE );
+}
+
 /*
  * triggered by GTypeModule base class when first loading the library,
  * which is itself triggered by module_new:g_type_module_use()
@@ -456,6 +574,9 @@ on_module_unload( GTypeModule *gmodule )
  *
  * Returns: a list of loaded modules willing to deal with requested @type.
  *
+ * Modules which have not been loaded yet are loaded here if their manifest
+ * declares the requested @type.
+ *
  * The returned list should be fma_module_free_extensions_list() by the caller.
  */
 GList *
@@ -468,6 +589,11 @@ fma_module_get_extensions_for_type( GList *modules, GType type )
 
 	for( im = modules; im ; im = im->next ){
 		a_modul = FMA_MODULE( im->data );
+		if( !a_modul->private->loaded ){
+			if( !module_provides( a_modul, type ) || !module_load( a_modul )){
+				continue;
+			}
+		}
 		for( io = a_modul->private->objects ; io ; io = io->next ){
 			if( G_TYPE_CHECK_INSTANCE_TYPE( G_OBJECT( io->data ), type )){
 				willing_to = g_list_prepend( willing_to, g_object_ref( io->data ));
@@ -532,6 +658,14 @@ fma_module_release_modules( GList *modules )
 	for( imod = modules ; imod ; imod = imod->next ){
 		module = FMA_MODULE( imod->data );
 
+		/* a module which has never been used, or which has failed to be
+		 * loaded, may just be released, as module_new() does
+		 */
+		if( !module->private->loaded ){
+			g_object_unref( module );
+			continue;
+		}
+
 		for( iobj = module->private->objects ; iobj ; iobj = iobj->next ){
 			g_object_unref( iobj->data );
 		}
@@ -61,6 +61,17 @@
  * interfaces, it asks each module for its list of objects which implement
  * this given interface.
  * Interface API is then called against the returned GObject.
+ *
+ * A plugin may be installed along with a manifest, i.e. a small key file
+ * named after the library, which declares the interfaces the plugin
+ * implements:
+ *
+ *   [FMA Module]
+ *   Interfaces=FMAIIOProvider;FMAIFactoryProvider;
+ *
+ * Such a plugin is not loaded at FMAPivot construction time, but only
+ * when one of its declared interfaces is first asked for. Importers and
+ * exporters are so never loaded in the file manager process.
  */
 
 #include <glib-object.h>
@@ -74,6 +85,10 @@ G_BEGIN_DECLS
 #define FMA_IS_MODULE_CLASS( klass )   ( G_TYPE_CHECK_CLASS_TYPE(( klass ), FMA_TYPE_MODULE ))
 #define FMA_MODULE_GET_CLASS( object ) ( G_TYPE_INSTANCE_GET_CLASS(( object ), FMA_TYPE_MODULE, FMAModuleClass ))
 
+#define FMA_MODULE_MANIFEST_SUFFIX     ".manifest"
+#define FMA_MODULE_MANIFEST_GROUP      "FMA Module"
+#define FMA_MODULE_MANIFEST_INTERFACES "Interfaces"
+
 typedef struct _FMAModulePrivate       FMAModulePrivate;
 
 typedef struct {
@@ -36,9 +36,13 @@
 #include <api/fma-core-utils.h>
 #include <api/fma-timeout.h>
 
+#include "fma-candidate-index.h"
 #include "fma-io-provider.h"
+#include "fma-iprefs.h"
+#include "fma-item-cache.h"
 #include "fma-module.h"
 #include "fma-pivot.h"
+#include "fma-selected-info.h"
 
 /* private class data
  */
@@ -49,23 +53,42 @@ struct _FMAPivotClassPrivate {
 /* private instance data
  */
 struct _FMAPivotPrivate {
-	gboolean    dispose_has_run;
+	gboolean           dispose_has_run;
 
-	guint       loadable_set;
+	guint              loadable_set;
+	gboolean           cacheable;
 
 	/* dynamically loaded modules (extension plugins)
 	 */
-	GList      *modules;
+	GList             *modules;
 
 	/* configuration tree of actions and menus
 	 */
-	GList      *tree;
+	GList             *tree;
+
+	/* candidate index of the tree, built on demand
+	 */
+	FMACandidateIndex *candidates;
 
 	/* timeout to manage i/o providers 'item-changed' burst
 	 */
-	FMATimeout  change_timeout;
+	FMATimeout         change_timeout;
+
+	/* the items reported as changed by the i/o providers since the last
+	 * reload, as a hash of identifier -> sItemChange
+	 */
+	GHashTable        *changed;
+	gboolean           reload_all;
 };
 
+/* a change reported by an i/o provider, summarized since the last reload
+ */
+typedef struct {
+	FMAIOProvider *provider;
+	guint          type;				/* FMAIIOProviderChangeType */
+}
+	sItemChange;
+
 /* FMAPivot properties
  */
 enum {
@@ -99,6 +122,14 @@ static void           instance_dispose( GObject *object );
 static void           instance_finalize( GObject *object );
 
 static FMAObjectItem *get_item_from_tree( const FMAPivot *pivot, GList *tree, const gchar *id );
+static FMACandidateIndex *get_candidate_index( FMAPivot *pivot );
+static void           reset_candidates( FMAPivot *pivot );
+static void           reset_changed( FMAPivot *pivot );
+static gboolean       reload_item( FMAPivot *pivot, const gchar *id, sItemChange *change );
+static gboolean       add_new_item( FMAPivot *pivot, const gchar *id, FMAObjectItem *item );
+static GList         *find_item_link( GList *tree, const gchar *id, FMAObjectItem **parent );
+static gboolean       is_referenced_by_menu( GList *tree, const gchar *id );
+static guint          merge_change_types( guint previous, guint type );
 
 /* FMAIIOProvider management */
 static void           on_items_changed_timeout( FMAPivot *pivot );
@@ -211,8 +242,10 @@ instance_init( GTypeInstance *instance, gpointer klass )
 
 	self->private->dispose_has_run = FALSE;
 	self->private->loadable_set = PIVOT_LOAD_NONE;
+	self->private->cacheable = FALSE;
 	self->private->modules = NULL;
 	self->private->tree = NULL;
+	self->private->candidates = NULL;
 
 	/* initialize timeout parameters for 'item-changed' handler
 	 */
@@ -220,6 +253,9 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private->change_timeout.handler = ( FMATimeoutFunc ) on_items_changed_timeout;
 	self->private->change_timeout.user_data = self;
 	self->private->change_timeout.source_id = 0;
+
+	self->private->changed = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_free );
+	self->private->reload_all = FALSE;
 }
 
 static void
@@ -292,6 +328,7 @@ instance_set_property( GObject *object, guint property_id, const GValue *value,
 				break;
 
 			case PIVOT_PROP_TREE_ID:
+				reset_candidates( self );
 				self->private->tree = g_value_get_pointer( value );
 				break;
 
@@ -318,6 +355,12 @@ instance_dispose( GObject *object )
 
 		self->private->dispose_has_run = TRUE;
 
+		if( self->private->change_timeout.source_id ){
+			g_source_remove( self->private->change_timeout.source_id );
+			self->private->change_timeout.source_id = 0;
+		}
+		g_hash_table_destroy( self->private->changed );
+
 		/* release modules */
 		fma_module_release_modules( self->private->modules );
 		self->private->modules = NULL;
@@ -326,6 +369,7 @@ instance_dispose( GObject *object )
 		g_debug( "%s: tree=%p (count=%u)", thisfn,
 				( void * ) self->private->tree, g_list_length( self->private->tree ));
 		fma_object_dump_tree( self->private->tree );
+		reset_candidates( self );
 		self->private->tree = fma_object_free_items( self->private->tree );
 
 		/* release the settings */
@@ -550,17 +594,109 @@ fma_pivot_get_items( const FMAPivot *pivot )
 	return( tree );
 }
 
+/*
+ * fma_pivot_get_candidates:
+ * @pivot: this #FMAPivot instance.
+ * @target: the current target.
+ * @selection: the current selection, as a list of #FMASelectedInfo objects.
+ *
+ * The candidate index of the current tree is built on the first call,
+ * and then kept until the tree is replaced or reloaded.
+ *
+ * Returns: the set of #FMAIContext objects of the current tree which
+ * may be candidate for the @target and the @selection.
+ * Objects which are not in this set would be rejected by
+ * fma_icontext_is_candidate() anyway, and may so be safely ignored.
+ *
+ * The returned #GHashTable should be g_hash_table_destroy() by the caller.
+ */
+GHashTable *
+fma_pivot_get_candidates( FMAPivot *pivot, guint target, GList *selection )
+{
+	GHashTable *candidates;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), NULL );
+
+	candidates = NULL;
+
+	if( !pivot->private->dispose_has_run ){
+
+		candidates = fma_candidate_index_get_candidates( get_candidate_index( pivot ), target, selection );
+	}
+
+	return( candidates );
+}
+
+/*
+ * fma_pivot_get_selection_attributes:
+ * @pivot: this #FMAPivot instance.
+ *
+ * Returns: the SELECTED_INFO_ATTR_xxx file attributes which are needed
+ * to evaluate the conditions of the current tree, and which are so
+ * worth to be queried as soon as the #FMASelectedInfo objects are
+ * created.
+ */
+guint
+fma_pivot_get_selection_attributes( FMAPivot *pivot )
+{
+	guint attributes;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), SELECTED_INFO_ATTR_ALL );
+
+	attributes = SELECTED_INFO_ATTR_ALL;
+
+	if( !pivot->private->dispose_has_run ){
+
+		attributes = fma_candidate_index_get_attributes( get_candidate_index( pivot ));
+	}
+
+	return( attributes );
+}
+
+/*
+ * the candidate index of the current tree is built on first use
+ */
+static FMACandidateIndex *
+get_candidate_index( FMAPivot *pivot )
+{
+	static const gchar *thisfn = "fma_pivot_get_candidate_index";
+
+	if( !pivot->private->candidates ){
+		g_debug( "%s: pivot=%p, building the candidate index", thisfn, ( void * ) pivot );
+		pivot->private->candidates = fma_candidate_index_new();
+		fma_candidate_index_add_items( pivot->private->candidates, pivot->private->tree );
+	}
+
+	return( pivot->private->candidates );
+}
+
+/*
+ * the candidate index must be released before the indexed tree
+ */
+static void
+reset_candidates( FMAPivot *pivot )
+{
+	fma_candidate_index_free( pivot->private->candidates );
+	pivot->private->candidates = NULL;
+}
+
 /*
  * fma_pivot_load_items:
  * @pivot: this #FMAPivot instance.
  *
  * Loads the hierarchical list of items from I/O providers.
+ *
+ * If the @pivot has been set cacheable, the items are loaded from the
+ * on-disk cache as long as it is up to date, and the cache is rewritten
+ * after the items have been actually read from the I/O providers,
+ * unless another process is already rewriting it.
  */
 void
 fma_pivot_load_items( FMAPivot *pivot )
 {
 	static const gchar *thisfn = "fma_pivot_load_items";
 	GSList *messages, *im;
+	FMAItemCache *cache;
 
 	g_return_if_fail( FMA_IS_PIVOT( pivot ));
 
@@ -569,8 +705,21 @@ fma_pivot_load_items( FMAPivot *pivot )
 		g_debug( "%s: pivot=%p", thisfn, ( void * ) pivot );
 
 		messages = NULL;
+		reset_changed( pivot );
+		reset_candidates( pivot );
 		fma_object_free_items( pivot->private->tree );
-		pivot->private->tree = fma_io_provider_load_items( pivot, pivot->private->loadable_set, &messages );
+		pivot->private->tree = NULL;
+
+		cache = pivot->private->cacheable ? fma_item_cache_new( pivot, pivot->private->loadable_set ) : NULL;
+
+		if( !cache || !fma_item_cache_load( cache, &pivot->private->tree )){
+			pivot->private->tree = fma_io_provider_load_items( pivot, pivot->private->loadable_set, &messages );
+			if( cache && fma_item_cache_lock( cache )){
+				fma_item_cache_save( cache, pivot->private->tree );
+			}
+		}
+
+		fma_item_cache_free( cache );
 
 		for( im = messages ; im ; im = im->next ){
 			g_warning( "%s: %s", thisfn, ( const gchar * ) im->data );
@@ -580,6 +729,315 @@ fma_pivot_load_items( FMAPivot *pivot )
 	}
 }
 
+/*
+ * fma_pivot_reload_items:
+ * @pivot: this #FMAPivot instance.
+ *
+ * Updates the hierarchical list of items after the I/O providers have
+ * reported some changes.
+ *
+ * When the I/O providers have been able to identify the changed items,
+ * and are able to read them one by one, only these items are re-read
+ * and spliced into the current tree. Deleted actions are just removed,
+ * without being read again. This is only possible for actions: menus,
+ * new actions which are referenced by a menu or by the level zero, or
+ * items whose I/O provider cannot read a single item, all fallback to
+ * a full fma_pivot_load_items().
+ *
+ * If the @pivot has been set cacheable, the on-disk cache is rewritten
+ * after an incremental update.
+ */
+void
+fma_pivot_reload_items( FMAPivot *pivot )
+{
+	static const gchar *thisfn = "fma_pivot_reload_items";
+	GHashTableIter iter;
+	const gchar *id;
+	sItemChange *change;
+	gboolean reload_all;
+	FMAItemCache *cache;
+
+	g_return_if_fail( FMA_IS_PIVOT( pivot ));
+
+	if( !pivot->private->dispose_has_run ){
+
+		reload_all = pivot->private->reload_all || !pivot->private->tree;
+
+		g_debug( "%s: pivot=%p, changed=%u, reload_all=%s",
+				thisfn, ( void * ) pivot, g_hash_table_size( pivot->private->changed ),
+				reload_all ? "True":"False" );
+
+		/* the stamps of the sources are computed before reading them */
+		cache = NULL;
+
+		if( !reload_all ){
+			if( pivot->private->cacheable ){
+				cache = fma_item_cache_new( pivot, pivot->private->loadable_set );
+			}
+			g_hash_table_iter_init( &iter, pivot->private->changed );
+			while( !reload_all && g_hash_table_iter_next( &iter, ( gpointer * ) &id, ( gpointer * ) &change )){
+				reload_all = !reload_item( pivot, id, change );
+			}
+		}
+
+		if( reload_all ){
+			fma_pivot_load_items( pivot );
+
+		} else {
+			reset_changed( pivot );
+			if( cache && fma_item_cache_lock( cache )){
+				fma_item_cache_save( cache, pivot->private->tree );
+			}
+		}
+
+		fma_item_cache_free( cache );
+	}
+}
+
+static void
+reset_changed( FMAPivot *pivot )
+{
+	g_hash_table_remove_all( pivot->private->changed );
+	pivot->private->reload_all = FALSE;
+}
+
+/*
+ * re-read the @id action from its I/O provider, and replace it in the
+ * tree (or just remove it if it does not exist anymore)
+ *
+ * an action which was not in the tree is added at level zero
+ *
+ * returns %FALSE if the tree cannot be incrementally updated
+ */
+static gboolean
+reload_item( FMAPivot *pivot, const gchar *id, sItemChange *change )
+{
+	static const gchar *thisfn = "fma_pivot_reload_item";
+	GList *link, *level, *list;
+	FMAObjectItem *parent, *old, *item;
+	GSList *messages, *im;
+	gboolean ok;
+	guint order_mode;
+
+	link = find_item_link( pivot->private->tree, id, &parent );
+	old = link ? FMA_OBJECT_ITEM( link->data ) : NULL;
+
+	if( old && ( !FMA_IS_OBJECT_ACTION( old ) || fma_object_get_provider( old ) != change->provider )){
+		g_debug( "%s: id=%s: not an action of this provider", thisfn, id );
+		return( FALSE );
+	}
+
+	if( !old && change->type == IIO_PROVIDER_CHANGE_DELETED ){
+		g_debug( "%s: id=%s: deleted, and not found in the current tree", thisfn, id );
+		return( TRUE );
+	}
+
+	item = NULL;
+
+	if( change->type != IIO_PROVIDER_CHANGE_DELETED ){
+		messages = NULL;
+		ok = fma_io_provider_read_item( change->provider, pivot, id, pivot->private->loadable_set, &item, &messages );
+
+		for( im = messages ; im ; im = im->next ){
+			g_warning( "%s: %s", thisfn, ( const gchar * ) im->data );
+		}
+		fma_core_utils_slist_free( messages );
+
+		if( !ok ){
+			return( FALSE );
+		}
+		if( item && !FMA_IS_OBJECT_ACTION( item )){
+			fma_object_unref( item );
+			return( FALSE );
+		}
+	}
+
+	if( !old ){
+		return( item ? add_new_item( pivot, id, item ) : TRUE );
+	}
+
+	g_debug( "%s: id=%s: old=%p, new=%p", thisfn, id, ( void * ) old, ( void * ) item );
+
+	level = parent ? fma_object_get_items( parent ) : pivot->private->tree;
+
+	if( pivot->private->candidates ){
+		list = g_list_append( NULL, old );
+		fma_candidate_index_remove_items( pivot->private->candidates, list );
+		g_list_free( list );
+	}
+
+	if( item ){
+		link->data = item;
+		fma_object_set_parent( item, parent );
+
+		if( pivot->private->candidates ){
+			list = g_list_append( NULL, item );
+			fma_candidate_index_add_items( pivot->private->candidates, list );
+			g_list_free( list );
+		}
+
+		order_mode = fma_iprefs_get_order_mode( NULL );
+		switch( order_mode ){
+			case IPREFS_ORDER_ALPHA_ASCENDING:
+				level = g_list_sort( level, ( GCompareFunc ) fma_object_id_sort_alpha_asc );
+				break;
+
+			case IPREFS_ORDER_ALPHA_DESCENDING:
+				level = g_list_sort( level, ( GCompareFunc ) fma_object_id_sort_alpha_desc );
+				break;
+
+			case IPREFS_ORDER_MANUAL:
+			default:
+				break;
+		}
+
+	} else {
+		level = g_list_delete_link( level, link );
+	}
+
+	if( parent ){
+		fma_object_set_items( parent, level );
+	} else {
+		pivot->private->tree = level;
+	}
+
+	fma_object_unref( old );
+
+	return( TRUE );
+}
+
+/*
+ * appends a newly found @item action to the level zero of the tree
+ *
+ * if the action is referenced by a menu, or by the level zero order,
+ * it must be positioned by a full load of the items
+ */
+static gboolean
+add_new_item( FMAPivot *pivot, const gchar *id, FMAObjectItem *item )
+{
+	static const gchar *thisfn = "fma_pivot_add_new_item";
+	GSList *level_zero;
+	GList *list;
+	gboolean referenced;
+
+	level_zero = fma_settings_get_string_list( IPREFS_ITEMS_LEVEL_ZERO_ORDER, NULL, NULL );
+	referenced = fma_core_utils_slist_count( level_zero, id ) > 0 ||
+			is_referenced_by_menu( pivot->private->tree, id );
+	fma_core_utils_slist_free( level_zero );
+
+	if( referenced ){
+		g_debug( "%s: id=%s: referenced by the hierarchy", thisfn, id );
+		fma_object_unref( item );
+		return( FALSE );
+	}
+
+	g_debug( "%s: id=%s: new=%p", thisfn, id, ( void * ) item );
+
+	fma_object_set_parent( item, NULL );
+	pivot->private->tree = g_list_append( pivot->private->tree, item );
+
+	if( pivot->private->candidates ){
+		list = g_list_append( NULL, item );
+		fma_candidate_index_add_items( pivot->private->candidates, list );
+		g_list_free( list );
+	}
+
+	switch( fma_iprefs_get_order_mode( NULL )){
+		case IPREFS_ORDER_ALPHA_ASCENDING:
+			pivot->private->tree = g_list_sort( pivot->private->tree, ( GCompareFunc ) fma_object_id_sort_alpha_asc );
+			break;
+
+		case IPREFS_ORDER_ALPHA_DESCENDING:
+			pivot->private->tree = g_list_sort( pivot->private->tree, ( GCompareFunc ) fma_object_id_sort_alpha_desc );
+			break;
+
+		case IPREFS_ORDER_MANUAL:
+		default:
+			break;
+	}
+
+	return( TRUE );
+}
+
+/*
+ * search for the menu or action @id in the @tree, returning the link
+ * which holds it, and setting @parent to the menu which contains it
+ * (or %NULL at level zero)
+ *
+ * contrarily to get_item_from_tree(), the search is case-sensitive and
+ * does not consider profiles, as we are comparing with the identifiers
+ * provided by the I/O providers
+ */
+static GList *
+find_item_link( GList *tree, const gchar *id, FMAObjectItem **parent )
+{
+	GList *it, *found;
+	gchar *it_id;
+
+	*parent = NULL;
+	found = NULL;
+
+	for( it = tree ; it && !found ; it = it->next ){
+
+		it_id = fma_object_get_id( it->data );
+		if( !strcmp( id, it_id )){
+			found = it;
+		}
+		g_free( it_id );
+
+		if( !found && FMA_IS_OBJECT_MENU( it->data )){
+			found = find_item_link( fma_object_get_items( it->data ), id, parent );
+			if( found && !*parent ){
+				*parent = FMA_OBJECT_ITEM( it->data );
+			}
+		}
+	}
+
+	return( found );
+}
+
+/*
+ * whether one of the menus of the @tree lists @id among its subitems
+ */
+static gboolean
+is_referenced_by_menu( GList *tree, const gchar *id )
+{
+	GList *it;
+	GSList *subitems;
+	gboolean found;
+
+	found = FALSE;
+
+	for( it = tree ; it && !found ; it = it->next ){
+		if( FMA_IS_OBJECT_MENU( it->data )){
+			subitems = fma_object_get_items_slist( it->data );
+			found = fma_core_utils_slist_count( subitems, id ) > 0 ||
+					is_referenced_by_menu( fma_object_get_items( it->data ), id );
+			fma_core_utils_slist_free( subitems );
+		}
+	}
+
+	return( found );
+}
+
+/*
+ * an item may have been reported several times before being reloaded:
+ * a created then updated item is still a new one, while a deleted then
+ * recreated item is just an updated one
+ */
+static guint
+merge_change_types( guint previous, guint type )
+{
+	if( previous == IIO_PROVIDER_CHANGE_CREATED && type == IIO_PROVIDER_CHANGE_UPDATED ){
+		return( IIO_PROVIDER_CHANGE_CREATED );
+	}
+	if( previous == IIO_PROVIDER_CHANGE_DELETED && type == IIO_PROVIDER_CHANGE_CREATED ){
+		return( IIO_PROVIDER_CHANGE_UPDATED );
+	}
+
+	return( type );
+}
+
 /*
  * fma_pivot_set_new_items:
  * @pivot: this #FMAPivot instance.
@@ -600,6 +1058,8 @@ fma_pivot_set_new_items( FMAPivot *pivot, GList *items )
 		g_debug( "%s: pivot=%p, items=%p (count=%d)",
 				thisfn, ( void * ) pivot, ( void * ) items, items ? g_list_length( items ) : 0 );
 
+		reset_changed( pivot );
+		reset_candidates( pivot );
 		fma_object_free_items( pivot->private->tree );
 		pivot->private->tree = items;
 	}
@@ -608,6 +1068,7 @@ fma_pivot_set_new_items( FMAPivot *pivot, GList *items )
 /*
  * fma_pivot_on_item_changed_handler:
  * @provider: the #FMAIIOProvider which has emitted the signal.
+ * @changes: the list of #FMAIIOProviderChange changes, or %NULL.
  * @pivot: this #FMAPivot instance.
  *
  * This handler is trigerred by #FMAIIOProvider providers when an action
@@ -619,17 +1080,47 @@ fma_pivot_set_new_items( FMAPivot *pivot, GList *items )
  * We don't care of updating our internal list with each and every
  * atomic modification; instead we wait for the end of notifications
  * serie, and then signal our consumers.
+ *
+ * The changed items are accumulated until the consumer calls
+ * fma_pivot_reload_items().
  */
 void
-fma_pivot_on_item_changed_handler( FMAIIOProvider *provider, FMAPivot *pivot  )
+fma_pivot_on_item_changed_handler( FMAIIOProvider *provider, GSList *changes, FMAPivot *pivot  )
 {
 	static const gchar *thisfn = "fma_pivot_on_item_changed_handler";
+	FMAIOProvider *io_provider;
+	GSList *it;
+	FMAIIOProviderChange *change;
+	sItemChange *item_change;
 
 	g_return_if_fail( FMA_IS_IIO_PROVIDER( provider ));
 	g_return_if_fail( FMA_IS_PIVOT( pivot ));
 
 	if( !pivot->private->dispose_has_run ){
-		g_debug( "%s: provider=%p, pivot=%p", thisfn, ( void * ) provider, ( void * ) pivot );
+		g_debug( "%s: provider=%p, changes=%p (count=%u), pivot=%p",
+				thisfn, ( void * ) provider, ( void * ) changes, g_slist_length( changes ), ( void * ) pivot );
+
+		io_provider = fma_io_provider_find_io_provider_by_module( pivot, provider );
+
+		if( !changes || !io_provider ){
+			pivot->private->reload_all = TRUE;
+
+		} else {
+			for( it = changes ; it ; it = it->next ){
+				change = ( FMAIIOProviderChange * ) it->data;
+				item_change = g_hash_table_lookup( pivot->private->changed, change->id );
+
+				if( item_change && item_change->provider == io_provider ){
+					item_change->type = merge_change_types( item_change->type, change->type );
+
+				} else {
+					item_change = g_new0( sItemChange, 1 );
+					item_change->provider = io_provider;
+					item_change->type = change->type;
+					g_hash_table_insert( pivot->private->changed, g_strdup( change->id ), item_change );
+				}
+			}
+		}
 
 		fma_timeout_event( &pivot->private->change_timeout );
 	}
@@ -652,6 +1143,28 @@ on_items_changed_timeout( FMAPivot *pivot )
 	g_signal_emit_by_name(( gpointer ) pivot, PIVOT_SIGNAL_ITEMS_CHANGED );
 }
 
+/*
+ * fma_pivot_set_cacheable:
+ * @pivot: this #FMAPivot instance.
+ * @cacheable: whether the items may be loaded from the on-disk cache.
+ *
+ * The items loaded from the cache cannot be written back to their I/O
+ * provider: only consumers which do not edit the items should set this
+ * flag.
+ *
+ * Defaults to %FALSE.
+ */
+void
+fma_pivot_set_cacheable( FMAPivot *pivot, gboolean cacheable )
+{
+	g_return_if_fail( FMA_IS_PIVOT( pivot ));
+
+	if( !pivot->private->dispose_has_run ){
+
+		pivot->private->cacheable = cacheable;
+	}
+}
+
 /*
  * fma_pivot_set_loadable:
  * @pivot: this #FMAPivot instance.
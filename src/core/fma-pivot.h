@@ -147,13 +147,17 @@ void           fma_pivot_free_providers         ( GList *providers );
  */
 FMAObjectItem *fma_pivot_get_item               ( const FMAPivot *pivot, const gchar *id );
 GList         *fma_pivot_get_items              ( const FMAPivot *pivot );
+GHashTable    *fma_pivot_get_candidates         ( FMAPivot *pivot, guint target, GList *selection );
+guint          fma_pivot_get_selection_attributes( FMAPivot *pivot );
 void           fma_pivot_load_items             ( FMAPivot *pivot );
+void           fma_pivot_reload_items           ( FMAPivot *pivot );
 void           fma_pivot_set_new_items          ( FMAPivot *pivot, GList *tree );
 
-void           fma_pivot_on_item_changed_handler( FMAIIOProvider *provider, FMAPivot *pivot  );
+void           fma_pivot_on_item_changed_handler( FMAIIOProvider *provider, GSList *changes, FMAPivot *pivot  );
 
 /* FMAPivot properties and configuration
  */
+void           fma_pivot_set_cacheable          ( FMAPivot *pivot, gboolean cacheable );
 void           fma_pivot_set_loadable           ( FMAPivot *pivot, guint loadable );
 
 G_END_DECLS
@@ -63,8 +63,55 @@ struct _FMASelectedInfoPrivate {
 	gboolean       can_execute;
 	gchar         *owner;
 	gboolean       attributes_are_set;
+	GFile         *location;
+	guint          queried;				/* the attributes already queried */
 };
 
+/* when creating the objects by batch:
+ * - the files are grouped by directory, so that the URI components are
+ *   only parsed once per directory;
+ * - the attributes are queried by a bounded pool of worker threads,
+ *   each job being either a single file or a whole directory when it
+ *   holds a large part of the selection;
+ * - a directory is only enumerated while the selection is a meaningful
+ *   fraction of its entries: the enumeration is given up after
+ *   BATCH_ENUMERATE_MAX_RATIO entries per selected file, the remaining
+ *   files being then queried one by one.
+ */
+#define BATCH_MAX_THREADS				8
+#define BATCH_ENUMERATE_MIN_FILES		64
+#define BATCH_ENUMERATE_MAX_RATIO		4
+
+typedef struct {
+	gchar    *key;						/* the parent URI */
+	gboolean  is_parsed;
+	gchar    *hostname;
+	gchar    *username;
+	gchar    *scheme;
+	guint     port;
+	GList    *files;					/* list of BatchFile's */
+}
+	BatchDir;
+
+typedef struct {
+	FMASelectedInfo *info;
+	GFile           *location;
+	gboolean         done;
+}
+	BatchFile;
+
+typedef struct {
+	BatchDir  *dir;						/* either a whole directory */
+	BatchFile *file;					/* or a single file */
+}
+	BatchJob;
+
+typedef struct {
+	guint      attributes;
+	GMutex     mutex;
+	GString   *errors;					/* NULL if the caller doesn't want them */
+}
+	Batch;
 
 static GObjectClass *st_parent_class = NULL;
 
@@ -77,7 +124,16 @@ static void             instance_finalize( GObject *object );
 static void             dump( const FMASelectedInfo *nsi );
 static const char      *dump_file_type( GFileType type );
 static FMASelectedInfo *new_from_uri( const gchar *uri, const gchar *mimetype, gchar **errmsg );
-static void             query_file_attributes( FMASelectedInfo *info, GFile *location, gchar **errmsg );
+static FMASelectedInfo *new_from_location( const gchar *uri, const gchar *mimetype, GFile *location, BatchDir *dir );
+static void             ensure_attributes( const FMASelectedInfo *nsi, guint attributes );
+static gchar           *get_query_attributes( const FMASelectedInfo *nsi, guint attributes );
+static void             query_file_attributes( FMASelectedInfo *nsi, GFile *location, guint attributes, gchar **errmsg );
+static void             set_file_attributes( FMASelectedInfo *nsi, GFileInfo *info, guint attributes );
+static BatchDir        *get_batch_dir( GHashTable *dirs, GList **ordered, const gchar *uri );
+static void             batch_dir_free( BatchDir *dir );
+static void             batch_query_file( BatchFile *file, Batch *batch );
+static void             batch_query_dir( BatchDir *dir, Batch *batch );
+static void             batch_run_job( BatchJob *job, Batch *batch );
 
 GType
 fma_selected_info_get_type( void )
@@ -166,6 +222,11 @@ instance_dispose( GObject *object )
 
 		self->private->dispose_has_run = TRUE;
 
+		if( self->private->location ){
+			g_object_unref( self->private->location );
+			self->private->location = NULL;
+		}
+
 		/* chain up to the parent class */
 		if( G_OBJECT_CLASS( st_parent_class )->dispose ){
 			G_OBJECT_CLASS( st_parent_class )->dispose( object );
@@ -305,6 +366,7 @@ fma_selected_info_get_mime_type( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		ensure_attributes( nsi, SELECTED_INFO_ATTR_MIMETYPE );
 		if( nsi->private->mimetype ){
 			mimetype = g_strdup( nsi->private->mimetype );
 		}
@@ -473,6 +535,7 @@ fma_selected_info_is_directory( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		ensure_attributes( nsi, SELECTED_INFO_ATTR_TYPE );
 		is_dir = ( nsi->private->file_type == G_FILE_TYPE_DIRECTORY );
 	}
 
@@ -496,6 +559,7 @@ fma_selected_info_is_regular( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		ensure_attributes( nsi, SELECTED_INFO_ATTR_TYPE );
 		is_regular = ( nsi->private->file_type == G_FILE_TYPE_REGULAR );
 	}
 
@@ -519,6 +583,7 @@ fma_selected_info_is_executable( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		ensure_attributes( nsi, SELECTED_INFO_ATTR_ACCESS );
 		is_exe = nsi->private->can_execute;
 	}
 
@@ -569,7 +634,8 @@ fma_selected_info_is_owner( const FMASelectedInfo *nsi, const gchar *user )
 
 	if( !nsi->private->dispose_has_run ){
 
-		is_owner = ( strcmp( nsi->private->owner, user ) == 0 );
+		ensure_attributes( nsi, SELECTED_INFO_ATTR_OWNER );
+		is_owner = ( nsi->private->owner && strcmp( nsi->private->owner, user ) == 0 );
 	}
 
 	return( is_owner );
@@ -592,6 +658,7 @@ fma_selected_info_is_readable( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		ensure_attributes( nsi, SELECTED_INFO_ATTR_ACCESS );
 		is_readable = nsi->private->can_read;
 	}
 
@@ -615,6 +682,7 @@ fma_selected_info_is_writable( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		ensure_attributes( nsi, SELECTED_INFO_ATTR_ACCESS );
 		is_writable = nsi->private->can_write;
 	}
 
@@ -642,6 +710,114 @@ fma_selected_info_create_for_uri( const gchar *uri, const gchar *mimetype, gchar
 	return( obj );
 }
 
+/*
+ * fma_selected_info_create_for_uris:
+ * @uris: a #GList of URIs.
+ * @mimetypes: a #GList of the corresponding mime types, or %NULL; when
+ *  set, it must have the same count of elements than @uris, though some
+ *  of these elements may be %NULL.
+ * @attributes: the SELECTED_INFO_ATTR_xxx file attributes to be queried
+ *  now; the other ones will only be queried on first access.
+ * @errmsg: a pointer to a string which will contain the error messages
+ *  on return, one per line.
+ *
+ * Returns: a #GList of newly allocated #FMASelectedInfo objects, in the
+ * same order than @uris, which should be fma_selected_info_free_list()
+ * by the caller.
+ */
+GList *
+fma_selected_info_create_for_uris( GList *uris, GList *mimetypes, guint attributes, gchar **errmsg )
+{
+	static const gchar *thisfn = "fma_selected_info_create_for_uris";
+	GList *list, *it, *im;
+	GList *ordered, *jobs;
+	GHashTable *dirs;
+	BatchDir *dir;
+	BatchFile *file;
+	BatchJob *job;
+	Batch batch;
+	GThreadPool *pool;
+
+	g_debug( "%s: uris=%p (count=%u), mimetypes=%p, attributes=%u",
+			thisfn, ( void * ) uris, g_list_length( uris ), ( void * ) mimetypes, attributes );
+
+	list = NULL;
+	ordered = NULL;
+	dirs = g_hash_table_new( g_str_hash, g_str_equal );
+
+	for( it = uris, im = mimetypes ; it ; it = it->next, im = im ? im->next : NULL ){
+		const gchar *uri = ( const gchar * ) it->data;
+		dir = get_batch_dir( dirs, &ordered, uri );
+		file = g_new0( BatchFile, 1 );
+		file->location = g_file_new_for_uri( uri );
+		file->info = new_from_location( uri, im ? ( const gchar * ) im->data : NULL, file->location, dir );
+		dir->files = g_list_prepend( dir->files, file );
+		list = g_list_prepend( list, file->info );
+	}
+
+	ordered = g_list_reverse( ordered );
+	g_hash_table_destroy( dirs );
+
+	batch.attributes = attributes;
+	batch.errors = errmsg ? g_string_new( "" ) : NULL;
+	g_mutex_init( &batch.mutex );
+
+	jobs = NULL;
+	if( attributes ){
+		for( it = ordered ; it ; it = it->next ){
+			dir = ( BatchDir * ) it->data;
+			dir->files = g_list_reverse( dir->files );
+
+			if( g_list_length( dir->files ) >= BATCH_ENUMERATE_MIN_FILES ){
+				job = g_new0( BatchJob, 1 );
+				job->dir = dir;
+				jobs = g_list_prepend( jobs, job );
+
+			} else {
+				for( im = dir->files ; im ; im = im->next ){
+					job = g_new0( BatchJob, 1 );
+					job->file = ( BatchFile * ) im->data;
+					jobs = g_list_prepend( jobs, job );
+				}
+			}
+		}
+		jobs = g_list_reverse( jobs );
+	}
+
+	/* a single job is run in the current thread */
+	pool = NULL;
+	if( jobs && jobs->next ){
+		pool = g_thread_pool_new(( GFunc ) batch_run_job, &batch, BATCH_MAX_THREADS, FALSE, NULL );
+	}
+
+	for( it = jobs ; it ; it = it->next ){
+		if( pool ){
+			g_thread_pool_push( pool, it->data, NULL );
+		} else {
+			batch_run_job(( BatchJob * ) it->data, &batch );
+		}
+	}
+
+	/* wait for all the jobs be done */
+	if( pool ){
+		g_thread_pool_free( pool, FALSE, TRUE );
+	}
+
+	g_list_free( jobs );
+	g_list_free_full( ordered, ( GDestroyNotify ) batch_dir_free );
+	g_mutex_clear( &batch.mutex );
+
+	if( batch.errors ){
+		if( batch.errors->len ){
+			*errmsg = g_string_free( batch.errors, FALSE );
+		} else {
+			g_string_free( batch.errors, TRUE );
+		}
+	}
+
+	return( g_list_reverse( list ));
+}
+
 static void
 dump( const FMASelectedInfo *nsi )
 {
@@ -747,6 +923,25 @@ static FMASelectedInfo *
 new_from_uri( const gchar *uri, const gchar *mimetype, gchar **errmsg )
 {
 	GFile *location;
+
+	location = g_file_new_for_uri( uri );
+	FMASelectedInfo *info = new_from_location( uri, mimetype, location, NULL );
+
+	query_file_attributes( info, location, SELECTED_INFO_ATTR_ALL, errmsg );
+	g_object_unref( location );
+
+	dump( info );
+
+	return( info );
+}
+
+/*
+ * @dir: if not %NULL, the already parsed URI components of the directory
+ *  which holds this file; they are set on first use.
+ */
+static FMASelectedInfo *
+new_from_location( const gchar *uri, const gchar *mimetype, GFile *location, BatchDir *dir )
+{
 	FMAGnomeVFSURI *vfs;
 
 	FMASelectedInfo *info = g_object_new( FMA_TYPE_SELECTED_INFO, NULL );
@@ -762,47 +957,126 @@ new_from_uri( const gchar *uri, const gchar *mimetype, gchar **errmsg )
 	 * Taking filename and dirname from URI just gives '/etc'
 	 * see #650523
 	 */
-	location = g_file_new_for_uri( uri );
+	info->private->location = g_object_ref( location );
 	info->private->filename = g_file_get_path( location );
 
-	vfs = g_new0( FMAGnomeVFSURI, 1 );
-	fma_gnome_vfs_uri_parse( vfs, uri );
+	/* the URI has to be fully parsed when it cannot be mapped to a local
+	 * path; else the scheme, host, user and port are those of the directory
+	 */
+	vfs = NULL;
+	if( !dir || !dir->is_parsed || !info->private->filename ){
+		vfs = g_new0( FMAGnomeVFSURI, 1 );
+		fma_gnome_vfs_uri_parse( vfs, uri );
+	}
+
 	if( !info->private->filename ){
 		g_debug( "fma_selected_info_new_from_uri: uri='%s', filename=NULL, setting it to '%s'", uri, vfs->path );
 		info->private->filename = g_strdup( vfs->path );
 	}
 
+	if( dir && !dir->is_parsed ){
+		dir->hostname = g_strdup( vfs->host_name );
+		dir->username = g_strdup( vfs->user_name );
+		dir->scheme = g_strdup( vfs->scheme );
+		dir->port = vfs->host_port;
+		dir->is_parsed = TRUE;
+	}
+
 	info->private->basename = g_path_get_basename( info->private->filename );
 	info->private->dirname = g_path_get_dirname( info->private->filename );
-	info->private->hostname = g_strdup( vfs->host_name );
-	info->private->username = g_strdup( vfs->user_name );
-	info->private->scheme = g_strdup( vfs->scheme );
-	info->private->port = vfs->host_port;
-	fma_gnome_vfs_uri_free( vfs );
 
-	query_file_attributes( info, location, errmsg );
-	g_object_unref( location );
+	if( dir ){
+		info->private->hostname = g_strdup( dir->hostname );
+		info->private->username = g_strdup( dir->username );
+		info->private->scheme = g_strdup( dir->scheme );
+		info->private->port = dir->port;
+
+	} else {
+		info->private->hostname = g_strdup( vfs->host_name );
+		info->private->username = g_strdup( vfs->user_name );
+		info->private->scheme = g_strdup( vfs->scheme );
+		info->private->port = vfs->host_port;
+	}
 
-	dump( info );
+	if( vfs ){
+		fma_gnome_vfs_uri_free( vfs );
+	}
 
 	return( info );
 }
 
+/*
+ * the attributes which have not been queried when creating the object
+ * are queried on first access
+ */
 static void
-query_file_attributes( FMASelectedInfo *nsi, GFile *location, gchar **errmsg )
+ensure_attributes( const FMASelectedInfo *nsi, guint attributes )
+{
+	guint missing;
+
+	missing = attributes & ~nsi->private->queried;
+
+	if( missing && nsi->private->location ){
+		query_file_attributes(( FMASelectedInfo * ) nsi, nsi->private->location, missing, NULL );
+	}
+}
+
+/*
+ * returns the list of the GIO attributes to be queried, as a newly
+ * allocated string which should be g_free() by the caller, or %NULL
+ */
+static gchar *
+get_query_attributes( const FMASelectedInfo *nsi, guint attributes )
+{
+	GString *str;
+
+	str = g_string_new( "" );
+
+	if( attributes & SELECTED_INFO_ATTR_TYPE ){
+		g_string_append( str, "," G_FILE_ATTRIBUTE_STANDARD_TYPE );
+	}
+	if(( attributes & SELECTED_INFO_ATTR_MIMETYPE ) && ( !nsi || !nsi->private->mimetype )){
+		g_string_append( str, "," G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE );
+	}
+	if( attributes & SELECTED_INFO_ATTR_ACCESS ){
+		g_string_append( str,
+				"," G_FILE_ATTRIBUTE_ACCESS_CAN_READ
+				"," G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE
+				"," G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE );
+	}
+	if( attributes & SELECTED_INFO_ATTR_OWNER ){
+		g_string_append( str, "," G_FILE_ATTRIBUTE_OWNER_USER );
+	}
+
+	if( !str->len ){
+		g_string_free( str, TRUE );
+		return( NULL );
+	}
+
+	/* skip the leading comma */
+	g_string_erase( str, 0, 1 );
+
+	return( g_string_free( str, FALSE ));
+}
+
+static void
+query_file_attributes( FMASelectedInfo *nsi, GFile *location, guint attributes, gchar **errmsg )
 {
 	static const gchar *thisfn = "fma_selected_info_query_file_attributes";
 	GError *error;
+	gchar *query;
+
+	/* do not retry on error */
+	nsi->private->queried |= attributes;
+
+	query = get_query_attributes( nsi, attributes );
+	if( !query ){
+		return;
+	}
 
 	error = NULL;
-	GFileInfo *info = g_file_query_info( location,
-			G_FILE_ATTRIBUTE_STANDARD_TYPE
-				"," G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE
-				"," G_FILE_ATTRIBUTE_ACCESS_CAN_READ
-				"," G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE
-				"," G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE
-				"," G_FILE_ATTRIBUTE_OWNER_USER,
-			G_FILE_QUERY_INFO_NONE, NULL, &error );
+	GFileInfo *info = g_file_query_info( location, query, G_FILE_QUERY_INFO_NONE, NULL, &error );
+	g_free( query );
 
 	if( error ){
 		if( errmsg ){
@@ -814,19 +1088,210 @@ query_file_attributes( FMASelectedInfo *nsi, GFile *location, gchar **errmsg )
 		return;
 	}
 
-	if( !nsi->private->mimetype ){
+	set_file_attributes( nsi, info, attributes );
+
+	g_object_unref( info );
+}
+
+static void
+set_file_attributes( FMASelectedInfo *nsi, GFileInfo *info, guint attributes )
+{
+	if(( attributes & SELECTED_INFO_ATTR_MIMETYPE ) && !nsi->private->mimetype ){
 		nsi->private->mimetype = g_strdup( g_file_info_get_attribute_as_string( info, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE ));
 	}
 
-	nsi->private->file_type = ( GFileType ) g_file_info_get_attribute_uint32( info, G_FILE_ATTRIBUTE_STANDARD_TYPE );
+	if( attributes & SELECTED_INFO_ATTR_TYPE ){
+		nsi->private->file_type = ( GFileType ) g_file_info_get_attribute_uint32( info, G_FILE_ATTRIBUTE_STANDARD_TYPE );
+	}
 
-	nsi->private->can_read = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_READ );
-	nsi->private->can_write = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE );
-	nsi->private->can_execute = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE );
+	if( attributes & SELECTED_INFO_ATTR_ACCESS ){
+		nsi->private->can_read = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_READ );
+		nsi->private->can_write = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE );
+		nsi->private->can_execute = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE );
+	}
 
-	nsi->private->owner = g_strdup( g_file_info_get_attribute_as_string( info, G_FILE_ATTRIBUTE_OWNER_USER ));
+	if( attributes & SELECTED_INFO_ATTR_OWNER ){
+		nsi->private->owner = g_strdup( g_file_info_get_attribute_as_string( info, G_FILE_ATTRIBUTE_OWNER_USER ));
+	}
 
+	nsi->private->queried |= attributes;
 	nsi->private->attributes_are_set = TRUE;
+}
 
-	g_object_unref( info );
+/*
+ * the files are grouped by parent URI, so that the URI components are
+ * only parsed once per directory
+ */
+static BatchDir *
+get_batch_dir( GHashTable *dirs, GList **ordered, const gchar *uri )
+{
+	BatchDir *dir;
+	const gchar *slash;
+	gsize len;
+	gchar *key;
+
+	len = strlen( uri );
+	while( len > 1 && uri[len-1] == '/' ){
+		len -= 1;
+	}
+	slash = g_strrstr_len( uri, len, "/" );
+	key = slash ? g_strndup( uri, slash-uri ) : g_strdup( uri );
+
+	dir = ( BatchDir * ) g_hash_table_lookup( dirs, key );
+
+	if( dir ){
+		g_free( key );
+
+	} else {
+		dir = g_new0( BatchDir, 1 );
+		dir->key = key;
+		g_hash_table_insert( dirs, key, dir );
+		*ordered = g_list_prepend( *ordered, dir );
+	}
+
+	return( dir );
+}
+
+static void
+batch_dir_free( BatchDir *dir )
+{
+	GList *it;
+
+	for( it = dir->files ; it ; it = it->next ){
+		BatchFile *file = ( BatchFile * ) it->data;
+		g_object_unref( file->location );
+		g_free( file );
+	}
+
+	g_list_free( dir->files );
+	g_free( dir->hostname );
+	g_free( dir->username );
+	g_free( dir->scheme );
+	g_free( dir->key );
+	g_free( dir );
+}
+
+static void
+batch_query_file( BatchFile *file, Batch *batch )
+{
+	gchar *errmsg;
+
+	errmsg = NULL;
+	query_file_attributes( file->info, file->location, batch->attributes, batch->errors ? &errmsg : NULL );
+
+	if( errmsg ){
+		g_mutex_lock( &batch->mutex );
+		g_string_append_printf( batch->errors, "%s%s", batch->errors->len ? "\n" : "", errmsg );
+		g_mutex_unlock( &batch->mutex );
+		g_free( errmsg );
+	}
+}
+
+/*
+ * enumerate the directory once instead of querying each of its
+ * selected files; the files which have not been found by the
+ * enumeration (e.g. a same file selected twice, or the enumeration
+ * having been given up) are queried one by one
+ *
+ * the content type is not sniffed when the mimetypes of all the
+ * selected files have been provided by the file manager
+ */
+static void
+batch_query_dir( BatchDir *dir, Batch *batch )
+{
+	static const gchar *thisfn = "fma_selected_info_batch_query_dir";
+	GHashTable *names;
+	GFile *parent;
+	GFileEnumerator *enumerator;
+	GFileInfo *info;
+	GError *error;
+	gchar *query, *attributes;
+	GList *it;
+	guint wanted, found, seen, max_seen;
+
+	names = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+	for( it = dir->files ; it ; it = it->next ){
+		BatchFile *file = ( BatchFile * ) it->data;
+		gchar *name = g_file_get_basename( file->location );
+		if( name && !g_hash_table_contains( names, name )){
+			g_hash_table_insert( names, name, file );
+		} else {
+			g_free( name );
+		}
+	}
+
+	/* only ask for the content type if at least one mimetype is missing */
+	wanted = batch->attributes & ~SELECTED_INFO_ATTR_MIMETYPE;
+	for( it = dir->files ; it ; it = it->next ){
+		if( !(( BatchFile * ) it->data )->info->private->mimetype ){
+			wanted = batch->attributes;
+			break;
+		}
+	}
+
+	attributes = get_query_attributes( NULL, wanted );
+	query = attributes
+			? g_strdup_printf( "%s,%s", G_FILE_ATTRIBUTE_STANDARD_NAME, attributes )
+			: g_strdup( G_FILE_ATTRIBUTE_STANDARD_NAME );
+	g_free( attributes );
+
+	error = NULL;
+	parent = g_file_get_parent((( BatchFile * ) dir->files->data )->location );
+	enumerator = parent ? g_file_enumerate_children( parent, query, G_FILE_QUERY_INFO_NONE, NULL, &error ) : NULL;
+
+	if( error ){
+		g_debug( "%s: dir=%s: %s", thisfn, dir->key, error->message );
+		g_error_free( error );
+	}
+
+	if( enumerator ){
+		found = 0;
+		seen = 0;
+		max_seen = BATCH_ENUMERATE_MAX_RATIO * g_hash_table_size( names );
+
+		while( found < g_hash_table_size( names ) && seen < max_seen &&
+				( info = g_file_enumerator_next_file( enumerator, NULL, NULL )) != NULL ){
+
+			BatchFile *file = ( BatchFile * ) g_hash_table_lookup( names, g_file_info_get_name( info ));
+			if( file && !file->done ){
+				set_file_attributes( file->info, info, batch->attributes );
+				file->done = TRUE;
+				found += 1;
+			}
+			seen += 1;
+			g_object_unref( info );
+		}
+
+		if( found < g_hash_table_size( names )){
+			g_debug( "%s: dir=%s: %u/%u files found after %u entries",
+					thisfn, dir->key, found, g_hash_table_size( names ), seen );
+		}
+		g_file_enumerator_close( enumerator, NULL, NULL );
+		g_object_unref( enumerator );
+	}
+
+	for( it = dir->files ; it ; it = it->next ){
+		BatchFile *file = ( BatchFile * ) it->data;
+		if( !file->done ){
+			batch_query_file( file, batch );
+		}
+	}
+
+	if( parent ){
+		g_object_unref( parent );
+	}
+	g_free( query );
+	g_hash_table_destroy( names );
+}
+
+static void
+batch_run_job( BatchJob *job, Batch *batch )
+{
+	if( job->dir ){
+		batch_query_dir( job->dir, batch );
+	} else {
+		batch_query_file( job->file, batch );
+	}
+
+	g_free( job );
 }
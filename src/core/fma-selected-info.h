@@ -41,6 +41,11 @@
  * This class should be replaced by FileManagerFileInfo class, as soon
  * as the required file manager version will have the
  * file_manager_file_info_create_for_uri() API (2.28 for Nautilus)
+ *
+ * When a whole selection has to be examined, the objects should rather
+ * be created by batch with fma_selected_info_create_for_uris(): the URI
+ * components are then only parsed once per directory, and the file
+ * attributes are queried in parallel.
  */
 
 #include <glib-object.h>
@@ -72,6 +77,18 @@ typedef struct {
 }
 	FMASelectedInfoClass;
 
+/* the file attributes which may be queried when creating the objects
+ * an attribute which has not been queried at creation time is queried
+ * on first access
+ */
+enum {
+	SELECTED_INFO_ATTR_TYPE     = 1 << 0,		/* file type (directory, regular file, ...) */
+	SELECTED_INFO_ATTR_MIMETYPE = 1 << 1,		/* content type, when not provided by the caller */
+	SELECTED_INFO_ATTR_ACCESS   = 1 << 2,		/* read, write and execute permissions */
+	SELECTED_INFO_ATTR_OWNER    = 1 << 3,		/* owner of the file */
+	SELECTED_INFO_ATTR_ALL      = 0x0f
+};
+
 GType            fma_selected_info_get_type          ( void );
 
 GList           *fma_selected_info_copy_list         ( GList *files );
@@ -95,6 +112,7 @@ gboolean         fma_selected_info_is_readable       ( const FMASelectedInfo *ns
 gboolean         fma_selected_info_is_writable       ( const FMASelectedInfo *nsi );
 
 FMASelectedInfo *fma_selected_info_create_for_uri    ( const gchar *uri, const gchar *mimetype, gchar **errmsg );
+GList           *fma_selected_info_create_for_uris   ( GList *uris, GList *mimetypes, guint attributes, gchar **errmsg );
 
 G_END_DECLS
 
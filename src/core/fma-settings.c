@@ -145,6 +145,7 @@ static const KeyDef st_def_keys[] = {
 	{ IPREFS_SHOW_IF_RUNNING_URI,              GROUP_FMA,    FMA_DATA_TYPE_STRING,      "file:///bin" },
 	{ IPREFS_TRY_EXEC_WSP,                     GROUP_FMA,    FMA_DATA_TYPE_UINT_LIST,   "" },
 	{ IPREFS_TRY_EXEC_URI,                     GROUP_FMA,    FMA_DATA_TYPE_STRING,      "file:///bin" },
+	{ IPREFS_EXEC_MAX_PARALLEL,                GROUP_RUNTIME, FMA_DATA_TYPE_UINT,        "0" },
 	{ IPREFS_EXPORT_ASK_USER_WSP,              GROUP_FMA,    FMA_DATA_TYPE_UINT_LIST,   "" },
 	{ IPREFS_EXPORT_ASK_USER_LAST_FORMAT,      GROUP_FMA,    FMA_DATA_TYPE_STRING,      "Desktop1" },
 	{ IPREFS_EXPORT_ASK_USER_KEEP_LAST_CHOICE, GROUP_FMA,    FMA_DATA_TYPE_BOOLEAN,     "false" },
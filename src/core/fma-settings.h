@@ -86,6 +86,7 @@ G_BEGIN_DECLS
 #define IPREFS_SHOW_IF_RUNNING_URI				"environment-show-if-running-lfu"
 #define IPREFS_TRY_EXEC_WSP						"environment-try-exec-wsp"
 #define IPREFS_TRY_EXEC_URI						"environment-try-exec-lfu"
+#define IPREFS_EXEC_MAX_PARALLEL				"exec-max-parallel"
 #define IPREFS_EXPORT_ASK_USER_WSP				"export-ask-user-wsp"
 #define IPREFS_EXPORT_ASK_USER_LAST_FORMAT		"export-ask-user-last-format"
 #define IPREFS_EXPORT_ASK_USER_KEEP_LAST_CHOICE	"export-ask-user-keep-last-choice"
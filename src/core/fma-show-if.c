@@ -0,0 +1,498 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <signal.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <glibtop/proclist.h>
+#include <glibtop/procstate.h>
+
+#include "fma-show-if.h"
+
+#define SHOW_IF_TRUE_TTL				5		/* time-to-live of a ShowIfTrue result (s) */
+#define SHOW_IF_TRUE_TIMEOUT			2000	/* hard timeout of a ShowIfTrue command (ms) */
+#define SHOW_IF_TRUE_MAX_ENTRIES		128		/* least recently used entries are evicted above this count */
+#define SHOW_IF_RUNNING_TTL				1		/* time-to-live of the processes snapshot (s) */
+
+typedef struct _ShowIfChild ShowIfChild;
+
+/* the cached result of a ShowIfTrue command
+ */
+typedef struct {
+	gchar       *command;
+	gboolean     has_result;
+	gboolean     result;
+	gint64       timestamp;
+	gint64       last_used;
+	ShowIfChild *child;					/* the running evaluation, if any */
+}
+	ShowIfEntry;
+
+/* a running ShowIfTrue command
+ * the entry is reset to NULL when the evaluation is cancelled
+ */
+struct _ShowIfChild {
+	ShowIfEntry *entry;
+	GPid         pid;
+	GString     *output;
+	GIOChannel  *channel;
+	GSource     *io_source;
+	GSource     *child_source;
+	GSource     *timeout_source;
+	gboolean     exited;
+	gboolean     eof;
+	gboolean     timed_out;
+	GMainLoop   *loop;					/* only set when run synchronously */
+};
+
+static FMAShowIfNotifyFunc st_notify         = NULL;
+static void               *st_notify_data    = NULL;
+static GHashTable         *st_commands       = NULL;	/* command -> ShowIfEntry */
+static GHashTable         *st_processes      = NULL;	/* set of running process names */
+static gint64              st_processes_time = 0;
+
+static ShowIfEntry *get_entry( const gchar *command );
+static gboolean     is_stale_entry( const gchar *command, ShowIfEntry *entry, gint64 *now );
+static void         evict_oldest_entry( void );
+static void         run_sync( ShowIfEntry *entry );
+static ShowIfChild *start_child( ShowIfEntry *entry, GMainContext *context );
+static gboolean     on_child_output( GIOChannel *channel, GIOCondition condition, ShowIfChild *child );
+static void         on_child_exited( GPid pid, gint status, ShowIfChild *child );
+static gboolean     on_child_timeout( ShowIfChild *child );
+static void         maybe_finish( ShowIfChild *child );
+static void         set_result( ShowIfEntry *entry, gboolean result, gboolean notify );
+static void         cancel_entry( const gchar *command, ShowIfEntry *entry, void *empty );
+static void         child_free( ShowIfChild *child );
+static void         entry_free( ShowIfEntry *entry );
+static void         refresh_processes( void );
+
+/*
+ * fma_show_if_set_async:
+ * @notify: the function to be called when a late result is available,
+ *  or %NULL to come back to synchronous evaluations.
+ * @user_data: user data to be passed to @notify.
+ *
+ * Asynchronous evaluations require a running main loop.
+ */
+void
+fma_show_if_set_async( FMAShowIfNotifyFunc notify, void *user_data )
+{
+	st_notify = notify;
+	st_notify_data = user_data;
+}
+
+/*
+ * fma_show_if_cancel:
+ *
+ * Kills all running commands, and releases the cached results.
+ */
+void
+fma_show_if_cancel( void )
+{
+	static const gchar *thisfn = "fma_show_if_cancel";
+
+	g_debug( "%s: commands=%u", thisfn, st_commands ? g_hash_table_size( st_commands ) : 0 );
+
+	if( st_commands ){
+		g_hash_table_foreach( st_commands, ( GHFunc ) cancel_entry, NULL );
+		g_hash_table_destroy( st_commands );
+		st_commands = NULL;
+	}
+
+	if( st_processes ){
+		g_hash_table_destroy( st_processes );
+		st_processes = NULL;
+	}
+}
+
+/*
+ * fma_show_if_true:
+ * @command: the ShowIfTrue command, with parameters already expanded.
+ *
+ * Returns: %TRUE if the @command outputs 'true', %FALSE else.
+ */
+gboolean
+fma_show_if_true( const gchar *command )
+{
+	static const gchar *thisfn = "fma_show_if_true";
+	ShowIfEntry *entry;
+	gint64 now;
+
+	g_return_val_if_fail( command != NULL, FALSE );
+
+	entry = get_entry( command );
+	now = g_get_monotonic_time();
+
+	if( !entry->child &&
+		( !entry->has_result || now - entry->timestamp >= SHOW_IF_TRUE_TTL * G_USEC_PER_SEC )){
+
+		if( st_notify ){
+			g_debug( "%s: command=%s, starting an asynchronous evaluation", thisfn, command );
+			start_child( entry, NULL );
+
+		} else {
+			run_sync( entry );
+		}
+	}
+
+	return( entry->has_result ? entry->result : FALSE );
+}
+
+static ShowIfEntry *
+get_entry( const gchar *command )
+{
+	ShowIfEntry *entry;
+	gint64 now;
+
+	if( !st_commands ){
+		st_commands = g_hash_table_new_full( g_str_hash, g_str_equal, NULL, ( GDestroyNotify ) entry_free );
+	}
+
+	now = g_get_monotonic_time();
+	entry = ( ShowIfEntry * ) g_hash_table_lookup( st_commands, command );
+
+	if( !entry ){
+		if( g_hash_table_size( st_commands ) >= SHOW_IF_TRUE_MAX_ENTRIES ){
+			g_hash_table_foreach_remove( st_commands, ( GHRFunc ) is_stale_entry, &now );
+		}
+		while( g_hash_table_size( st_commands ) >= SHOW_IF_TRUE_MAX_ENTRIES ){
+			evict_oldest_entry();
+		}
+
+		entry = g_new0( ShowIfEntry, 1 );
+		entry->command = g_strdup( command );
+		g_hash_table_insert( st_commands, entry->command, entry );
+	}
+
+	entry->last_used = now;
+
+	return( entry );
+}
+
+static gboolean
+is_stale_entry( const gchar *command, ShowIfEntry *entry, gint64 *now )
+{
+	return( !entry->child && *now - entry->timestamp >= SHOW_IF_TRUE_TTL * G_USEC_PER_SEC );
+}
+
+/*
+ * evict the least recently used entry, killing its command if it is
+ * still running
+ */
+static void
+evict_oldest_entry( void )
+{
+	GHashTableIter iter;
+	ShowIfEntry *entry, *oldest;
+
+	oldest = NULL;
+	g_hash_table_iter_init( &iter, st_commands );
+
+	while( g_hash_table_iter_next( &iter, NULL, ( gpointer * ) &entry )){
+		if( !oldest || entry->last_used < oldest->last_used ){
+			oldest = entry;
+		}
+	}
+
+	if( oldest ){
+		cancel_entry( oldest->command, oldest, NULL );
+		g_hash_table_remove( st_commands, oldest->command );
+	}
+}
+
+/*
+ * run the command in a private main context, so that the hard timeout
+ * still applies
+ */
+static void
+run_sync( ShowIfEntry *entry )
+{
+	GMainContext *context;
+	GMainLoop *loop;
+	ShowIfChild *child;
+
+	context = g_main_context_new();
+	child = start_child( entry, context );
+
+	if( child ){
+		loop = g_main_loop_new( context, FALSE );
+		child->loop = loop;
+		g_main_loop_run( loop );
+		g_main_loop_unref( loop );
+	}
+
+	g_main_context_unref( context );
+}
+
+static ShowIfChild *
+start_child( ShowIfEntry *entry, GMainContext *context )
+{
+	static const gchar *thisfn = "fma_show_if_start_child";
+	ShowIfChild *child;
+	GError *error;
+	gchar **argv;
+	GPid pid;
+	gint out_fd;
+
+	error = NULL;
+	argv = NULL;
+
+	if( !g_shell_parse_argv( entry->command, NULL, &argv, &error ) ||
+		!g_spawn_async_with_pipes( NULL, argv, NULL,
+				G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
+				NULL, NULL, &pid, NULL, &out_fd, NULL, &error )){
+
+		g_debug( "%s: command=%s: %s", thisfn, entry->command, error->message );
+		g_error_free( error );
+		g_strfreev( argv );
+		set_result( entry, FALSE, FALSE );
+		return( NULL );
+	}
+
+	g_strfreev( argv );
+
+	child = g_new0( ShowIfChild, 1 );
+	child->entry = entry;
+	child->pid = pid;
+	child->output = g_string_new( "" );
+	entry->child = child;
+
+	child->channel = g_io_channel_unix_new( out_fd );
+	g_io_channel_set_encoding( child->channel, NULL, NULL );
+	g_io_channel_set_flags( child->channel, G_IO_FLAG_NONBLOCK, NULL );
+	g_io_channel_set_close_on_unref( child->channel, TRUE );
+
+	child->io_source = g_io_create_watch( child->channel, G_IO_IN | G_IO_HUP | G_IO_ERR );
+	g_source_set_callback( child->io_source, ( GSourceFunc ) on_child_output, child, NULL );
+	g_source_attach( child->io_source, context );
+
+	child->child_source = g_child_watch_source_new( pid );
+	g_source_set_callback( child->child_source, ( GSourceFunc ) on_child_exited, child, NULL );
+	g_source_attach( child->child_source, context );
+
+	child->timeout_source = g_timeout_source_new( SHOW_IF_TRUE_TIMEOUT );
+	g_source_set_callback( child->timeout_source, ( GSourceFunc ) on_child_timeout, child, NULL );
+	g_source_attach( child->timeout_source, context );
+
+	return( child );
+}
+
+static gboolean
+on_child_output( GIOChannel *channel, GIOCondition condition, ShowIfChild *child )
+{
+	gchar buffer[256];
+	gsize length;
+	GIOStatus status;
+
+	do {
+		length = 0;
+		status = g_io_channel_read_chars( channel, buffer, sizeof( buffer ), &length, NULL );
+		if( length ){
+			g_string_append_len( child->output, buffer, length );
+		}
+	} while( status == G_IO_STATUS_NORMAL );
+
+	if( status == G_IO_STATUS_AGAIN ){
+		return( TRUE );
+	}
+
+	child->eof = TRUE;
+	maybe_finish( child );
+
+	return( FALSE );
+}
+
+static void
+on_child_exited( GPid pid, gint status, ShowIfChild *child )
+{
+	g_spawn_close_pid( pid );
+
+	child->exited = TRUE;
+	maybe_finish( child );
+}
+
+/*
+ * the command may have exited while some of its own children keep
+ * the output open: do not kill a pid which may have been reused
+ */
+static gboolean
+on_child_timeout( ShowIfChild *child )
+{
+	static const gchar *thisfn = "fma_show_if_on_child_timeout";
+
+	g_debug( "%s: command=%s, pid=%d: timeout expired",
+			thisfn, child->entry ? child->entry->command : "(cancelled)", ( gint ) child->pid );
+
+	child->timed_out = TRUE;
+
+	if( !child->exited ){
+		kill( child->pid, SIGKILL );
+	}
+
+	maybe_finish( child );
+
+	return( FALSE );
+}
+
+static void
+maybe_finish( ShowIfChild *child )
+{
+	gboolean result;
+
+	if( child->exited && ( child->eof || child->timed_out )){
+
+		if( child->entry ){
+			result = !child->timed_out && !strcmp( child->output->str, "true" );
+			child->entry->child = NULL;
+			set_result( child->entry, result, child->loop == NULL );
+		}
+
+		if( child->loop ){
+			g_main_loop_quit( child->loop );
+		}
+
+		child_free( child );
+	}
+}
+
+static void
+set_result( ShowIfEntry *entry, gboolean result, gboolean notify )
+{
+	static const gchar *thisfn = "fma_show_if_set_result";
+	gboolean changed;
+
+	changed = !entry->has_result || entry->result != result;
+
+	entry->has_result = TRUE;
+	entry->result = result;
+	entry->timestamp = g_get_monotonic_time();
+
+	g_debug( "%s: command=%s, result=%s, changed=%s",
+			thisfn, entry->command, result ? "True":"False", changed ? "True":"False" );
+
+	if( changed && notify && st_notify ){
+		( *st_notify )( st_notify_data );
+	}
+}
+
+/*
+ * the child is left to its sources, which will release it when the
+ * killed command will have been reaped
+ */
+static void
+cancel_entry( const gchar *command, ShowIfEntry *entry, void *empty )
+{
+	if( entry->child ){
+		entry->child->entry = NULL;
+		if( !entry->child->exited ){
+			kill( entry->child->pid, SIGKILL );
+		}
+		entry->child = NULL;
+	}
+}
+
+static void
+child_free( ShowIfChild *child )
+{
+	g_source_destroy( child->io_source );
+	g_source_unref( child->io_source );
+	g_source_destroy( child->child_source );
+	g_source_unref( child->child_source );
+	g_source_destroy( child->timeout_source );
+	g_source_unref( child->timeout_source );
+
+	g_io_channel_unref( child->channel );
+	g_string_free( child->output, TRUE );
+	g_free( child );
+}
+
+static void
+entry_free( ShowIfEntry *entry )
+{
+	g_free( entry->command );
+	g_free( entry );
+}
+
+/*
+ * fma_show_if_running:
+ * @name: the name of the searched process, maybe a full pathname.
+ *
+ * Returns: %TRUE if a process of this name is currently running.
+ */
+gboolean
+fma_show_if_running( const gchar *name )
+{
+	static const gchar *thisfn = "fma_show_if_running";
+	gchar *searched;
+	gboolean found;
+
+	g_return_val_if_fail( name != NULL, FALSE );
+
+	if( !st_processes || g_get_monotonic_time() - st_processes_time >= SHOW_IF_RUNNING_TTL * G_USEC_PER_SEC ){
+		refresh_processes();
+	}
+
+	searched = g_path_get_basename( name );
+	found = g_hash_table_contains( st_processes, searched );
+	g_debug( "%s: searched=%s, found=%s", thisfn, searched, found ? "True":"False" );
+	g_free( searched );
+
+	return( found );
+}
+
+static void
+refresh_processes( void )
+{
+	glibtop_proclist proclist;
+	glibtop_proc_state procstate;
+	pid_t *pid_list;
+	guint i;
+
+	if( st_processes ){
+		g_hash_table_remove_all( st_processes );
+	} else {
+		st_processes = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+	}
+
+	pid_list = glibtop_get_proclist( &proclist, GLIBTOP_KERN_PROC_ALL, 0 );
+
+	for( i=0 ; i<proclist.number ; ++i ){
+		glibtop_get_proc_state( &procstate, pid_list[i] );
+		g_hash_table_add( st_processes, g_strdup( procstate.cmd ));
+	}
+
+	g_free( pid_list );
+
+	st_processes_time = g_get_monotonic_time();
+}
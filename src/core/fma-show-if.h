@@ -0,0 +1,73 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu pivots.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_SHOW_IF_H__
+#define __CORE_FMA_SHOW_IF_H__
+
+/* @title: FMAShowIf
+ * @short_description: The ShowIfTrue and ShowIfRunning evaluator
+ * @include: core/fma-show-if.h
+ *
+ * ShowIfTrue and ShowIfRunning conditions are the most expensive to
+ * evaluate, as they respectively imply to run an external command, and
+ * to scan the running processes.
+ *
+ * The results of ShowIfTrue commands are cached for a short time, and
+ * the least recently used ones are evicted when the cache is full. An
+ * external command which does not terminate before a hard timeout is
+ * killed, and considered as having returned %FALSE.
+ *
+ * By default, a command which does not have a cached result yet is run
+ * synchronously. After fma_show_if_set_async() has been called with a
+ * notification function, commands are run asynchronously instead: until
+ * a first result is available, the condition is considered as %FALSE,
+ * and a stale result is returned while the command is re-run in the
+ * background. The notification function is called each time a late
+ * result changes the outcome of a condition.
+ *
+ * The names of the running processes are gathered in a snapshot which
+ * is shared by all ShowIfRunning conditions, and is refreshed when it
+ * is more than one second old.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef void ( *FMAShowIfNotifyFunc )( void *user_data );
+
+void     fma_show_if_set_async( FMAShowIfNotifyFunc notify, void *user_data );
+void     fma_show_if_cancel   ( void );
+
+gboolean fma_show_if_true     ( const gchar *command );
+gboolean fma_show_if_running  ( const gchar *name );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_SHOW_IF_H__ */
@@ -31,15 +31,15 @@
 #include <config.h>
 #endif
 
-#include <gio/gunixinputstream.h>
 #include <glib/gi18n.h>
-#include <gtk/gtk.h>
 #include <string.h>
 
 #include <api/fma-core-utils.h>
 #include <api/fma-object-api.h>
 
+#include "fma-display-output.h"
 #include "fma-gnome-vfs-uri.h"
+#include "fma-job-runner.h"
 #include "fma-selected-info.h"
 #include "fma-settings.h"
 #include "fma-tokens.h"
@@ -50,31 +50,65 @@ struct _FMATokensClassPrivate {
 	void *empty;						/* so that gcc -pedantic is happy */
 };
 
+/* the lists of strings extracted from the selection
+ * each list is a NULL-terminated array of 'count' strings, so that the
+ * i-th element of a singular form is directly addressable
+ */
+enum {
+	LIST_URIS = 0,
+	LIST_FILENAMES,
+	LIST_BASEDIRS,
+	LIST_BASENAMES,
+	LIST_BASENAMES_WOEXT,
+	LIST_EXTS,
+	LIST_MIMETYPES,						/* computed on first use */
+	LIST_N
+};
+
 /* private instance data
  */
 struct _FMATokensPrivate {
 	gboolean dispose_has_run;
 	guint    count;
-	GSList  *uris;
-	GSList  *filenames;
-	GSList  *basedirs;
-	GSList  *basenames;
-	GSList  *basenames_woext;
-	GSList  *exts;
-	GSList  *mimetypes;
+	gchar  **lists[LIST_N];
+	gchar   *joined[LIST_N][2];			/* space-separated lists, unquoted and quoted, computed on first use */
+	GList   *selection;					/* the selection the mimetypes are computed from */
 	gchar   *hostname;
 	gchar   *username;
 	guint    port;
 	gchar   *scheme;
+	gchar   *cwd;						/* the execution context of the caller, when it is not ours */
+	gchar  **envp;
 };
 
-/*  the structure passed to the callback which waits for the end of the child
+/* a command template is an input string parsed once into an array of
+ * segments, each segment being either a literal text or a parameter;
+ * rendering the template for each element of the selection so only
+ * has to concatenate the segments
  */
 typedef struct {
-	gchar   *command;
-	gboolean is_output_displayed;
-	gint     child_stdout;
-	gint     child_stderr;
+	gchar        token;					/* the parameter, or zero for a literal text */
+	const gchar *text;
+	gsize        len;
+}
+	TemplateSegment;
+
+typedef struct {
+	gchar   *source;
+	GArray  *segments;
+	gboolean singular;
+}
+	CommandTemplate;
+
+/* the data of a task submitted to the job runner: one command to be
+ * spawned, and then waited for the end of the child
+ */
+typedef struct {
+	gchar            *command;
+	gchar            *wdir;
+	gchar           **envp;
+	gboolean          is_output_displayed;
+	FMADisplayOutput *output;
 }
 	ChildStr;
 
@@ -86,18 +120,23 @@ static void      instance_init( GTypeInstance *instance, gpointer klass );
 static void      instance_dispose( GObject *object );
 static void      instance_finalize( GObject *object );
 
-static void      child_watch_fn( GPid pid, gint status, ChildStr *child_str );
-static void      display_output( const gchar *command, int fd_stdout, int fd_stderr );
-static gchar    *display_output_get_content( int fd );
-static void      execute_action_command( gchar *command, const FMAObjectProfile *profile, const FMATokens *tokens );
+static ChildStr  *child_new( const gchar *command, const gchar *execution_mode, const gchar *wdir, gchar **envp );
+static GPid      child_spawn( ChildStr *child_str );
+static void      child_done( GPid pid, gint status, ChildStr *child_str );
+static void      child_free( ChildStr *child_str );
 static gchar    *get_command_execution_display_output( const gchar *command );
 static gchar    *get_command_execution_embedded( const gchar *command );
 static gchar    *get_command_execution_normal( const gchar *command );
 static gchar    *get_command_execution_terminal( const gchar *command );
-static gboolean  is_singular_exec( const FMATokens *tokens, const gchar *exec );
-static gchar    *parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean utf8, gboolean quoted );
+static void      alloc_lists( FMATokens *tokens, guint count );
+static gchar   **get_list( const FMATokens *tokens, guint id );
+static const gchar *get_list_joined( const FMATokens *tokens, guint id, gboolean quoted );
+static GString  *append_nth( GString *output, const FMATokens *tokens, guint id, guint i, gboolean quoted );
+static gchar    *parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean quoted );
 static GString  *quote_string( GString *input, const gchar *name, gboolean quoted );
-static GString  *quote_string_list( GString *input, GSList *names, gboolean quoted );
+static CommandTemplate *template_new( const gchar *input );
+static void      template_free( CommandTemplate *tpl );
+static gchar    *template_render( const CommandTemplate *tpl, const FMATokens *tokens, guint i, gboolean quoted );
 
 GType
 fma_tokens_get_type( void )
@@ -158,6 +197,7 @@ instance_init( GTypeInstance *instance, gpointer klass )
 {
 	static const gchar *thisfn = "fma_tokens_instance_init";
 	FMATokens *self;
+	guint id;
 
 	g_return_if_fail( FMA_IS_TOKENS( instance ));
 
@@ -168,17 +208,18 @@ instance_init( GTypeInstance *instance, gpointer klass )
 
 	self->private = g_new0( FMATokensPrivate, 1 );
 
-	self->private->uris = NULL;
-	self->private->filenames = NULL;
-	self->private->basedirs = NULL;
-	self->private->basenames = NULL;
-	self->private->basenames_woext = NULL;
-	self->private->exts = NULL;
-	self->private->mimetypes = NULL;
+	for( id = 0 ; id < LIST_N ; ++id ){
+		self->private->lists[id] = NULL;
+		self->private->joined[id][0] = NULL;
+		self->private->joined[id][1] = NULL;
+	}
+	self->private->selection = NULL;
 	self->private->hostname = NULL;
 	self->private->username = NULL;
 	self->private->port = 0;
 	self->private->scheme = NULL;
+	self->private->cwd = NULL;
+	self->private->envp = NULL;
 
 	self->private->dispose_has_run = FALSE;
 }
@@ -199,6 +240,9 @@ instance_dispose( GObject *object )
 
 		self->private->dispose_has_run = TRUE;
 
+		fma_selected_info_free_list( self->private->selection );
+		self->private->selection = NULL;
+
 		if( G_OBJECT_CLASS( st_parent_class )->dispose ){
 			G_OBJECT_CLASS( st_parent_class )->dispose( object );
 		}
@@ -210,6 +254,7 @@ instance_finalize( GObject *object )
 {
 	static const gchar *thisfn = "fma_tokens_instance_finalize";
 	FMATokens *self;
+	guint id;
 
 	g_return_if_fail( FMA_IS_TOKENS( object ));
 
@@ -217,16 +262,17 @@ instance_finalize( GObject *object )
 
 	self = FMA_TOKENS( object );
 
+	g_strfreev( self->private->envp );
+	g_free( self->private->cwd );
 	g_free( self->private->scheme );
 	g_free( self->private->username );
 	g_free( self->private->hostname );
-	fma_core_utils_slist_free( self->private->mimetypes );
-	fma_core_utils_slist_free( self->private->exts );
-	fma_core_utils_slist_free( self->private->basenames_woext );
-	fma_core_utils_slist_free( self->private->basenames );
-	fma_core_utils_slist_free( self->private->basedirs );
-	fma_core_utils_slist_free( self->private->filenames );
-	fma_core_utils_slist_free( self->private->uris );
+
+	for( id = 0 ; id < LIST_N ; ++id ){
+		g_strfreev( self->private->lists[id] );
+		g_free( self->private->joined[id][0] );
+		g_free( self->private->joined[id][1] );
+	}
 
 	g_free( self->private );
 
@@ -256,42 +302,38 @@ fma_tokens_new_for_example( void )
 	const gchar *ex_host = _( "test.example.net" );
 	const gchar *ex_user = _( "user" );
 	FMAGnomeVFSURI *vfs;
-	gchar *dirname, *bname, *bname_woext, *ext;
-	GSList *is;
-	gboolean first;
+	gchar *bname;
+	guint i;
 
 	g_debug( "%s:", thisfn );
 
 	tokens = g_object_new( FMA_TYPE_TOKENS, NULL );
-	first = TRUE;
-	tokens->private->count = 2;
+	alloc_lists( tokens, 2 );
 
-	tokens->private->uris = g_slist_append( tokens->private->uris, g_strdup( ex_uri1 ));
-	tokens->private->uris = g_slist_append( tokens->private->uris, g_strdup( ex_uri2 ));
+	tokens->private->lists[LIST_URIS][0] = g_strdup( ex_uri1 );
+	tokens->private->lists[LIST_URIS][1] = g_strdup( ex_uri2 );
 
-	for( is = tokens->private->uris ; is ; is = is->next ){
+	for( i = 0 ; i < tokens->private->count ; ++i ){
 		vfs = g_new0( FMAGnomeVFSURI, 1 );
-		fma_gnome_vfs_uri_parse( vfs, is->data );
+		fma_gnome_vfs_uri_parse( vfs, tokens->private->lists[LIST_URIS][i] );
 
-		tokens->private->filenames = g_slist_append( tokens->private->filenames, g_strdup( vfs->path ));
-		dirname = g_path_get_dirname( vfs->path );
-		tokens->private->basedirs = g_slist_append( tokens->private->basedirs, dirname );
+		tokens->private->lists[LIST_FILENAMES][i] = g_strdup( vfs->path );
+		tokens->private->lists[LIST_BASEDIRS][i] = g_path_get_dirname( vfs->path );
 		bname = g_path_get_basename( vfs->path );
-		tokens->private->basenames = g_slist_append( tokens->private->basenames, bname );
-		fma_core_utils_dir_split_ext( bname, &bname_woext, &ext );
-		tokens->private->basenames_woext = g_slist_append( tokens->private->basenames_woext, bname_woext );
-		tokens->private->exts = g_slist_append( tokens->private->exts, ext );
+		tokens->private->lists[LIST_BASENAMES][i] = bname;
+		fma_core_utils_dir_split_ext( bname,
+				&tokens->private->lists[LIST_BASENAMES_WOEXT][i], &tokens->private->lists[LIST_EXTS][i] );
 
-		if( first ){
+		if( i == 0 ){
 			tokens->private->scheme = g_strdup( vfs->scheme );
-			first = FALSE;
 		}
 
 		fma_gnome_vfs_uri_free( vfs );
 	}
 
-	tokens->private->mimetypes = g_slist_append( tokens->private->mimetypes, g_strdup( ex_mimetype1 ));
-	tokens->private->mimetypes = g_slist_append( tokens->private->mimetypes, g_strdup( ex_mimetype2 ));
+	tokens->private->lists[LIST_MIMETYPES] = g_new0( gchar *, 3 );
+	tokens->private->lists[LIST_MIMETYPES][0] = g_strdup( ex_mimetype1 );
+	tokens->private->lists[LIST_MIMETYPES][1] = g_strdup( ex_mimetype2 );
 
 	tokens->private->hostname = g_strdup( ex_host );
 	tokens->private->username = g_strdup( ex_user );
@@ -312,50 +354,160 @@ fma_tokens_new_from_selection( GList *selection )
 	static const gchar *thisfn = "fma_tokens_new_from_selection";
 	FMATokens *tokens;
 	GList *it;
-	gchar *uri, *filename, *basedir, *basename, *bname_woext, *ext, *mimetype;
-	gboolean first;
+	FMASelectedInfo *info;
+	gchar *basename;
+	guint i;
 
 	g_debug( "%s: selection=%p (count=%d)", thisfn, ( void * ) selection, g_list_length( selection ));
 
-	first = TRUE;
 	tokens = g_object_new( FMA_TYPE_TOKENS, NULL );
+	alloc_lists( tokens, g_list_length( selection ));
 
-	tokens->private->count = g_list_length( selection );
-
-	for( it = selection ; it ; it = it->next ){
-		mimetype = fma_selected_info_get_mime_type( FMA_SELECTED_INFO( it->data ));
+	/* getting the mimetype may imply to query the file: only do that
+	 * when a %m or %M parameter has actually to be expanded
+	 */
+	tokens->private->selection = fma_selected_info_copy_list( selection );
 
-		uri = fma_selected_info_get_uri( FMA_SELECTED_INFO( it->data ));
-		filename = fma_selected_info_get_path( FMA_SELECTED_INFO( it->data ));
-		basedir = fma_selected_info_get_dirname( FMA_SELECTED_INFO( it->data ));
-		basename = fma_selected_info_get_basename( FMA_SELECTED_INFO( it->data ));
-		fma_core_utils_dir_split_ext( basename, &bname_woext, &ext );
+	for( it = selection, i = 0 ; it ; it = it->next, ++i ){
+		info = FMA_SELECTED_INFO( it->data );
+		basename = fma_selected_info_get_basename( info );
 
-		if( first ){
-			tokens->private->hostname = fma_selected_info_get_uri_host( FMA_SELECTED_INFO( it->data ));
-			tokens->private->username = fma_selected_info_get_uri_user( FMA_SELECTED_INFO( it->data ));
-			tokens->private->port = fma_selected_info_get_uri_port( FMA_SELECTED_INFO( it->data ));
-			tokens->private->scheme = fma_selected_info_get_uri_scheme( FMA_SELECTED_INFO( it->data ));
-			first = FALSE;
+		if( i == 0 ){
+			tokens->private->hostname = fma_selected_info_get_uri_host( info );
+			tokens->private->username = fma_selected_info_get_uri_user( info );
+			tokens->private->port = fma_selected_info_get_uri_port( info );
+			tokens->private->scheme = fma_selected_info_get_uri_scheme( info );
 		}
 
-		tokens->private->uris = g_slist_append( tokens->private->uris, uri );
-		tokens->private->filenames = g_slist_append( tokens->private->filenames, filename );
-		tokens->private->basedirs = g_slist_append( tokens->private->basedirs, basedir );
-		tokens->private->basenames = g_slist_append( tokens->private->basenames, basename );
-		tokens->private->basenames_woext = g_slist_append( tokens->private->basenames_woext, bname_woext );
-		tokens->private->exts = g_slist_append( tokens->private->exts, ext );
-		tokens->private->mimetypes = g_slist_append( tokens->private->mimetypes, mimetype );
+		tokens->private->lists[LIST_URIS][i] = fma_selected_info_get_uri( info );
+		tokens->private->lists[LIST_FILENAMES][i] = fma_selected_info_get_path( info );
+		tokens->private->lists[LIST_BASEDIRS][i] = fma_selected_info_get_dirname( info );
+		tokens->private->lists[LIST_BASENAMES][i] = basename;
+		fma_core_utils_dir_split_ext( basename,
+				&tokens->private->lists[LIST_BASENAMES_WOEXT][i], &tokens->private->lists[LIST_EXTS][i] );
 	}
 
 	return( tokens );
 }
 
+/*
+ * fma_tokens_set_environment:
+ * @tokens: this #FMATokens object.
+ * @cwd: [allow-none]: the working directory of the caller.
+ * @envp: [allow-none]: the environment of the caller.
+ *
+ * Sets the execution context of the commands, when the action is
+ * executed on behalf of another process.
+ *
+ * @cwd is used when the profile does not specify a working directory;
+ * @envp, when set, replaces the environment of the current process.
+ */
+void
+fma_tokens_set_environment( FMATokens *tokens, const gchar *cwd, gchar **envp )
+{
+	g_return_if_fail( FMA_IS_TOKENS( tokens ));
+
+	if( !tokens->private->dispose_has_run ){
+
+		g_free( tokens->private->cwd );
+		tokens->private->cwd = g_strdup( cwd );
+
+		g_strfreev( tokens->private->envp );
+		tokens->private->envp = g_strdupv( envp );
+	}
+}
+
+/*
+ * allocates the lists which are directly extracted from the selection
+ * mimetypes are left apart as they are computed on demand
+ */
+static void
+alloc_lists( FMATokens *tokens, guint count )
+{
+	guint id;
+
+	tokens->private->count = count;
+
+	for( id = 0 ; id < LIST_MIMETYPES ; ++id ){
+		tokens->private->lists[id] = g_new0( gchar *, count+1 );
+	}
+}
+
+static gchar **
+get_list( const FMATokens *tokens, guint id )
+{
+	gchar **list;
+	GList *it;
+	guint i;
+
+	if( id == LIST_MIMETYPES && !tokens->private->lists[id] && tokens->private->selection ){
+		list = g_new0( gchar *, tokens->private->count+1 );
+		for( it = tokens->private->selection, i = 0 ; it && i < tokens->private->count ; it = it->next, ++i ){
+			list[i] = fma_selected_info_get_mime_type( FMA_SELECTED_INFO( it->data ));
+		}
+		tokens->private->lists[id] = list;
+	}
+
+	return( tokens->private->lists[id] );
+}
+
+/*
+ * returns the space-separated list of the strings, computing it on first
+ * use as it may be expanded for each element of the selection
+ */
+static const gchar *
+get_list_joined( const FMATokens *tokens, guint id, gboolean quoted )
+{
+	gchar **list;
+	GString *joined;
+	guint i, iq;
+
+	iq = quoted ? 1 : 0;
+
+	if( !tokens->private->joined[id][iq] ){
+		list = get_list( tokens, id );
+		if( !list ){
+			return( "" );
+		}
+
+		/* the lists may have NULL elements (e.g. an unknown mimetype),
+		 * which are skipped
+		 */
+		joined = g_string_new( "" );
+		for( i = 0 ; i < tokens->private->count ; ++i ){
+			if( list[i] ){
+				if( joined->len ){
+					g_string_append_c( joined, ' ' );
+				}
+				joined = quote_string( joined, list[i], quoted );
+			}
+		}
+		tokens->private->joined[id][iq] = g_string_free( joined, FALSE );
+	}
+
+	return( tokens->private->joined[id][iq] );
+}
+
+static GString *
+append_nth( GString *output, const FMATokens *tokens, guint id, guint i, gboolean quoted )
+{
+	gchar **list;
+
+	list = get_list( tokens, id );
+
+	if( list && i < tokens->private->count && list[i] ){
+		output = quote_string( output, list[i], quoted );
+	}
+
+	return( output );
+}
+
 /*
  * fma_tokens_parse_for_display:
  * @tokens: a #FMATokens object.
  * @string: the input string, may or may not contain tokens.
  * @utf8: whether the @input string is UTF-8 encoded, or a standard ASCII string.
+ *  As parameters are ASCII characters, the parsing is the same in both cases.
  *
  * Expands the parameters in the given string.
  *
@@ -368,7 +520,7 @@ fma_tokens_new_from_selection( GList *selection )
 gchar *
 fma_tokens_parse_for_display( const FMATokens *tokens, const gchar *string, gboolean utf8 )
 {
-	return( parse_singular( tokens, string, 0, utf8, FALSE ));
+	return( parse_singular( tokens, string, 0, FALSE ));
 }
 
 /*
@@ -377,13 +529,26 @@ fma_tokens_parse_for_display( const FMATokens *tokens, const gchar *string, gboo
  * @profile: the #FMAObjectProfile to be executed.
  *
  * Execute the given action, regarding the context described by @tokens.
+ *
+ * The commands are submitted as one job to the #FMAJobRunner, which
+ * limits the count of simultaneously running processes when a singular
+ * form command is executed for each element of a large selection.
  */
 void
 fma_tokens_execute_action( const FMATokens *tokens, const FMAObjectProfile *profile )
 {
+	static const FMAJobRunnerTaskFns st_task_fns = {
+		( GPid ( * )( gpointer )) child_spawn,
+		( void ( * )( GPid, gint, gpointer )) child_done,
+		( void ( * )( gpointer )) child_free
+	};
 	gchar *path, *parameters, *exec;
-	gboolean singular;
-	guint i;
+	gchar *execution_mode, *wdir, *wdir_nq, *label;
+	FMAObjectItem *action;
+	CommandTemplate *tpl;
+	GList *tasks;
+	ChildStr *child_str;
+	guint i, count;
 	gchar *command;
 
 	path = fma_object_get_path( profile );
@@ -392,96 +557,42 @@ fma_tokens_execute_action( const FMATokens *tokens, const FMAObjectProfile *prof
 	g_free( parameters );
 	g_free( path );
 
-	singular = is_singular_exec( tokens, exec );
-
-	if( singular ){
-		for( i = 0 ; i < tokens->private->count ; ++i ){
-			command = parse_singular( tokens, exec, i, FALSE, TRUE );
-			execute_action_command( command, profile, tokens );
-			g_free( command );
-		}
-
-	} else {
-		command = parse_singular( tokens, exec, 0, FALSE, TRUE );
-		execute_action_command( command, profile, tokens );
-		g_free( command );
-	}
-
-	g_free( exec );
-}
-
-static void
-child_watch_fn( GPid pid, gint status, ChildStr *child_str )
-{
-	static const gchar *thisfn = "fma_tokens_child_watch_fn";
+	execution_mode = fma_object_get_execution_mode( profile );
+	wdir = fma_object_get_working_dir( profile );
+	wdir_nq = parse_singular( tokens, wdir, 0, FALSE );
+	tasks = NULL;
 
-	g_debug( "%s: pid=%u, status=%d", thisfn, ( guint ) pid, status );
-	g_spawn_close_pid( pid );
-	if( child_str->is_output_displayed ){
-		display_output( child_str->command, child_str->child_stdout, child_str->child_stderr );
+	if(( !wdir_nq || !strlen( wdir_nq )) && tokens->private->cwd ){
+		g_free( wdir_nq );
+		wdir_nq = g_strdup( tokens->private->cwd );
 	}
-	g_free( child_str->command );
-	g_free( child_str );
-}
-
-static void
-display_output( const gchar *command, int fd_stdout, int fd_stderr )
-{
-	GtkWidget *dialog;
-	gchar *std_output, *std_error;
-
-	dialog = gtk_message_dialog_new_with_markup(
-			NULL, GTK_DIALOG_MODAL, GTK_MESSAGE_INFO, GTK_BUTTONS_OK, "<b>%s</b>", _( "Output of the run command" ));
-	g_object_set( G_OBJECT( dialog ) , "title", PACKAGE_NAME, NULL );
 
-	std_output = display_output_get_content( fd_stdout );
-	std_error = display_output_get_content( fd_stderr );
-
-	gtk_message_dialog_format_secondary_markup( GTK_MESSAGE_DIALOG( dialog ),
-			"<b>%s</b>\n%s\n\n<b>%s</b>\n%s\n\n<b>%s</b>\n%s\n\n",
-					_( "Run command:" ), command,
-					_( "Standard output:" ), std_output,
-					_( "Standard error:" ), std_error );
-
-	gtk_dialog_run( GTK_DIALOG( dialog ));
-	gtk_widget_destroy( dialog );
-
-	g_free( std_output );
-	g_free( std_error );
-}
-
-static gchar *
-display_output_get_content( int fd )
-{
-	static const gchar *thisfn = "fma_tokens_display_output_get_content";
-	GInputStream *stream;
-	GString *string;
-	gchar buf[1024];
-	GError *error;
-	gchar *msg;
-
-	string = g_string_new( "" );
-	memset( buf, '\0', sizeof( buf ));
-
-	if( fd > 0 ){
-		stream = g_unix_input_stream_new( fd, TRUE );
-		error = NULL;
-
-		while( g_input_stream_read( stream, buf, sizeof( buf )-1, NULL, &error )){
-			string = g_string_append( string, buf );
-			memset( buf, '\0', sizeof( buf ));
-		}
-		if( error ){
-			g_warning( "%s: g_input_stream_read: %s", thisfn, error->message );
-			g_error_free( error );
+	/* the command-line is parsed only once, even when it has to be
+	 * expanded for each element of the selection
+	 */
+	tpl = template_new( exec );
+	count = tpl->singular ? tokens->private->count : 1;
+
+	for( i = 0 ; i < count ; ++i ){
+		command = template_render( tpl, tokens, i, TRUE );
+		child_str = child_new( command, execution_mode, wdir_nq, tokens->private->envp );
+		if( child_str ){
+			tasks = g_list_prepend( tasks, child_str );
 		}
-		g_input_stream_close( stream, NULL, NULL );
+		g_free( command );
 	}
 
-	msg = g_locale_to_utf8( string->str, -1, NULL, NULL, NULL );
-	g_string_free( string, TRUE );
+	template_free( tpl );
+
+	action = fma_object_get_parent( profile );
+	label = action ? fma_object_get_id( action ) : NULL;
+	fma_job_runner_submit( fma_job_runner_get_default(), label, g_list_reverse( tasks ), &st_task_fns );
 
-	return( msg );
+	g_free( label );
+	g_free( wdir_nq );
+	g_free( wdir );
+	g_free( execution_mode );
+	g_free( exec );
 }
 
 /*
@@ -490,26 +601,20 @@ display_output_get_content( int fd )
  * - Terminal: use the user preference to have a terminal which stays openeded
  * - Embedded: id. Terminal
  * - DisplayOutput: execute in a shell
+ *
+ * Returns: a new ChildStr structure, or %NULL if the execution mode is
+ * unknown.
  */
-static void
-execute_action_command( gchar *command, const FMAObjectProfile *profile, const FMATokens *tokens )
+static ChildStr *
+child_new( const gchar *command, const gchar *execution_mode, const gchar *wdir, gchar **envp )
 {
-	static const gchar *thisfn = "nautilus_actions_execute_action_command";
-	GError *error;
-	gchar *execution_mode, *run_command;
-	gchar **argv;
-	gint argc;
-	gchar *wdir, *wdir_nq;
-	GPid child_pid;
+	static const gchar *thisfn = "fma_tokens_child_new";
 	ChildStr *child_str;
+	gchar *run_command;
+	gboolean is_output_displayed;
 
-	g_debug( "%s: profile=%p", thisfn, ( void * ) profile );
-
-	error = NULL;
 	run_command = NULL;
-	child_str = g_new0( ChildStr, 1 );
-	child_pid = ( GPid ) 0;
-	execution_mode = fma_object_get_execution_mode( profile );
+	is_output_displayed = FALSE;
 
 	if( !strcmp( execution_mode, "Normal" )){
 		run_command = get_command_execution_normal( command );
@@ -521,83 +626,136 @@ execute_action_command( gchar *command, const FMAObjectProfile *profile, const F
 		run_command = get_command_execution_embedded( command );
 
 	} else if( !strcmp( execution_mode, "DisplayOutput" )){
-		child_str->is_output_displayed = TRUE;
+		is_output_displayed = TRUE;
 		run_command = get_command_execution_display_output( command );
 
 	} else {
 		g_warning( "%s: unknown execution mode: %s", thisfn, execution_mode );
 	}
 
-	if( run_command ){
-		child_str->command = g_strdup( run_command );
+	if( !run_command ){
+		return( NULL );
+	}
+
+	child_str = g_new0( ChildStr, 1 );
+	child_str->command = run_command;
+	child_str->wdir = g_strdup( wdir );
+	child_str->envp = g_strdupv( envp );
+	child_str->is_output_displayed = is_output_displayed;
+
+	return( child_str );
+}
 
-		if( !g_shell_parse_argv( run_command, &argc, &argv, &error )){
-			g_warning( "%s: g_shell_parse_argv: %s", thisfn, error->message );
-			g_error_free( error );
+/*
+ * Returns: the pid of the spawned child, or zero.
+ */
+static GPid
+child_spawn( ChildStr *child_str )
+{
+	static const gchar *thisfn = "fma_tokens_child_spawn";
+	GError *error;
+	gchar **argv;
+	gint argc;
+	GPid child_pid;
+	gint child_stdout, child_stderr;
+	GSpawnFlags flags;
 
-		} else {
-			wdir = fma_object_get_working_dir( profile );
-			wdir_nq = parse_singular( tokens, wdir, 0, FALSE, FALSE );
-			g_debug( "%s: run_command=%s, wdir=%s", thisfn, run_command, wdir_nq );
+	error = NULL;
+	child_pid = ( GPid ) 0;
+	flags = G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD;
 
-			/* it appears that at least mplayer does not support g_spawn_async_with_pipes
-			 * (at least when not run in '-quiet' mode) while, e.g., totem and vlc rightly
-			 * support this function
-			 * So only use g_spawn_async_with_pipes when we really need to get back
-			 * the content of output and error streams
-			 * See https://bugzilla.gnome.org/show_bug.cgi?id=644289.
-			 */
-			if( child_str->is_output_displayed ){
-				g_spawn_async_with_pipes(
-						wdir_nq,
-						argv,
-						NULL,
-						G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
-						NULL,
-						NULL,
-						&child_pid,
-						NULL,
-						&child_str->child_stdout,
-						&child_str->child_stderr,
-						&error );
-
-			} else {
-				g_spawn_async(
-						wdir_nq,
-						argv,
-						NULL,
-						G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
-						NULL,
-						NULL,
-						&child_pid,
-						&error );
-			}
+#if GLIB_CHECK_VERSION( 2,34, 0 )
+	/* the command is searched for in the PATH of the caller
+	 */
+	if( child_str->envp ){
+		flags |= G_SPAWN_SEARCH_PATH_FROM_ENVP;
+	}
+#endif
 
-			if( error ){
-				g_warning( "%s: g_spawn_async: %s", thisfn, error->message );
-				g_error_free( error );
-				child_pid = ( GPid ) 0;
+	if( !g_shell_parse_argv( child_str->command, &argc, &argv, &error )){
+		g_warning( "%s: g_shell_parse_argv: %s", thisfn, error->message );
+		g_error_free( error );
+		return( child_pid );
+	}
 
-			} else {
-				g_child_watch_add( child_pid, ( GChildWatchFunc ) child_watch_fn, child_str );
-			}
+	g_debug( "%s: run_command=%s, wdir=%s", thisfn, child_str->command, child_str->wdir );
 
-			g_free( wdir );
-			g_free( wdir_nq );
-			g_strfreev( argv );
+	/* it appears that at least mplayer does not support g_spawn_async_with_pipes
+	 * (at least when not run in '-quiet' mode) while, e.g., totem and vlc rightly
+	 * support this function
+	 * So only use g_spawn_async_with_pipes when we really need to get back
+	 * the content of output and error streams
+	 * See https://bugzilla.gnome.org/show_bug.cgi?id=644289.
+	 */
+	if( child_str->is_output_displayed ){
+		g_spawn_async_with_pipes(
+				child_str->wdir,
+				argv,
+				child_str->envp,
+				flags,
+				NULL,
+				NULL,
+				&child_pid,
+				NULL,
+				&child_stdout,
+				&child_stderr,
+				&error );
+
+		/* the outputs are captured and displayed while the child runs,
+		 * so that it does not stall on a full pipe
+		 */
+		if( !error ){
+			child_str->output = fma_display_output_new( child_str->command, child_stdout, child_stderr );
 		}
 
-		g_free( run_command );
+	} else {
+		g_spawn_async(
+				child_str->wdir,
+				argv,
+				child_str->envp,
+				flags,
+				NULL,
+				NULL,
+				&child_pid,
+				&error );
 	}
 
-	g_free( execution_mode );
+	if( error ){
+		g_warning( "%s: g_spawn_async: %s", thisfn, error->message );
+		g_error_free( error );
+		child_pid = ( GPid ) 0;
+	}
+
+	g_strfreev( argv );
+
+	return( child_pid );
+}
 
-	if( child_pid == ( GPid ) 0 ){
-		g_free( child_str->command );
-		g_free( child_str );
+/*
+ * the job runner has already closed the pid
+ */
+static void
+child_done( GPid pid, gint status, ChildStr *child_str )
+{
+	static const gchar *thisfn = "fma_tokens_child_done";
+
+	g_debug( "%s: pid=%u, status=%d", thisfn, ( guint ) pid, status );
+
+	if( child_str->output ){
+		fma_display_output_child_exited( child_str->output, status );
+		child_str->output = NULL;
 	}
 }
 
+static void
+child_free( ChildStr *child_str )
+{
+	g_free( child_str->command );
+	g_strfreev( child_str->envp );
+	g_free( child_str->wdir );
+	g_free( child_str );
+}
+
 static gchar *
 get_command_execution_display_output( const gchar *command )
 {
@@ -657,25 +815,82 @@ fma_tokens_command_for_terminal( const gchar *pattern, const gchar *command )
 }
 
 /*
- * fma_tokens_is_singular_exec:
- * @tokens: the current #FMATokens object.
- * @exec: the to be executed command-line before having been parsed
+ * parse_singular:
+ * @tokens: a #FMATokens object.
+ * @input: the input string, may or may not contain tokens.
+ * @i: the number of the iteration in a multiple selection, starting with zero.
+ * @quoted: whether the filenames have to be quoted (should be %TRUE when
+ *  about to execute a command).
  *
- * Returns: %TRUE if the first relevant parameter found in @exec
- * command-line is of singular form, %FALSE else.
+ * Returns: the @input string with the parameters expanded for the @i-th
+ * element of the selection, as a newly allocated string which should be
+ * g_free() by the caller, or %NULL if @input is %NULL.
  */
-static gboolean
-is_singular_exec( const FMATokens *tokens, const gchar *exec )
+static gchar *
+parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean quoted )
 {
-	gboolean singular;
+	static const gchar *thisfn = "fma_tokens_parse_singular";
+	CommandTemplate *tpl;
+	gchar *output;
+
+	g_debug( "%s: tokens=%p, input=%s, i=%d, quoted=%s",
+			thisfn, ( void * ) tokens, input, i, quoted ? "true":"false" );
+
+	if( !input ){
+		return( NULL );
+	}
+
+	tpl = template_new( input );
+	output = template_render( tpl, tokens, i, quoted );
+	template_free( tpl );
+
+	return( output );
+}
+
+/*
+ * template_new:
+ * @input: the to be parsed string.
+ *
+ * A command is said of 'singular form' when its first parameter is not
+ * of plural form. In the case of a multiple selection, singular form
+ * commands are executed one time for each element of the selection.
+ *
+ * Unknown parameters, as well as the no-op operators, are just dropped.
+ *
+ * Returns: a new #CommandTemplate, which should be template_free() by
+ * the caller.
+ */
+static CommandTemplate *
+template_new( const gchar *input )
+{
+	static const gchar *st_parameters = "bBcdDfFhmMnpsuUwWxX%";
+	CommandTemplate *tpl;
+	TemplateSegment segment;
+	const gchar *iter, *prev_iter;
 	gboolean found;
-	gchar *iter;
 
-	singular = FALSE;
+	tpl = g_new0( CommandTemplate, 1 );
+	tpl->source = g_strdup( input );
+	tpl->segments = g_array_new( FALSE, FALSE, sizeof( TemplateSegment ));
+	tpl->singular = FALSE;
 	found = FALSE;
-	iter = ( gchar * ) exec;
+	prev_iter = tpl->source;
+
+	while(( iter = strchr( prev_iter, '%' )) != NULL ){
+
+		if( iter > prev_iter ){
+			segment.token = '\0';
+			segment.text = prev_iter;
+			segment.len = iter - prev_iter;
+			g_array_append_val( tpl->segments, segment );
+		}
 
-	while(( iter = g_strstr_len( iter, -1, "%" )) != NULL && !found ){
+		/* a trailing percent sign is ignored
+		 */
+		if( !iter[1] ){
+			prev_iter = iter+1;
+			break;
+		}
 
 		switch( iter[1] ){
 			case 'b':
@@ -686,8 +901,10 @@ is_singular_exec( const FMATokens *tokens, const gchar *exec )
 			case 'u':
 			case 'w':
 			case 'x':
-				found = TRUE;
-				singular = TRUE;
+				if( !found ){
+					found = TRUE;
+					tpl->singular = TRUE;
+				}
 				break;
 
 			case 'B':
@@ -699,7 +916,6 @@ is_singular_exec( const FMATokens *tokens, const gchar *exec )
 			case 'W':
 			case 'X':
 				found = TRUE;
-				singular = FALSE;
 				break;
 
 			/* all other parameters are irrelevant according to DES-EMA
@@ -712,80 +928,67 @@ is_singular_exec( const FMATokens *tokens, const gchar *exec )
 			 */
 		}
 
-		iter += 2;			/* skip the % sign and the character after */
+		if( strchr( st_parameters, iter[1] )){
+			segment.token = iter[1];
+			segment.text = NULL;
+			segment.len = 0;
+			g_array_append_val( tpl->segments, segment );
+		}
+
+		prev_iter = iter+2;			/* skip the % sign and the character after */
 	}
 
-	return( singular );
+	if( *prev_iter ){
+		segment.token = '\0';
+		segment.text = prev_iter;
+		segment.len = strlen( prev_iter );
+		g_array_append_val( tpl->segments, segment );
+	}
+
+	return( tpl );
+}
+
+static void
+template_free( CommandTemplate *tpl )
+{
+	g_array_free( tpl->segments, TRUE );
+	g_free( tpl->source );
+	g_free( tpl );
 }
 
 /*
- * parse_singular:
+ * template_render:
+ * @tpl: a #CommandTemplate.
  * @tokens: a #FMATokens object.
- * @input: the input string, may or may not contain tokens.
  * @i: the number of the iteration in a multiple selection, starting with zero.
- * @utf8: whether the @input string is UTF-8 encoded, or a standard ASCII
- *  string.
- * @quoted: whether the filenames have to be quoted (should be %TRUE when
- *  about to execute a command).
- *
- * A command is said of 'singular form' when its first parameter is not
- * of plural form. In the case of a multiple selection, singular form
- * commands are executed one time for each element of the selection
+ * @quoted: whether the filenames have to be quoted.
  *
- * Returns: a #GSList which contains two fields: the command and its parameters.
- * The returned #GSList should be fma_core_utils_slist_free() by the caller.
+ * Returns: the expanded string, as a newly allocated string which should
+ * be g_free() by the caller.
  */
 static gchar *
-parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean utf8, gboolean quoted )
+template_render( const CommandTemplate *tpl, const FMATokens *tokens, guint i, gboolean quoted )
 {
-	static const gchar *thisfn = "fma_tokens_parse_singular";
 	GString *output;
-	gchar *iter, *prev_iter;
-	const gchar *nth;
+	TemplateSegment *segment;
+	guint is;
 
-	g_debug( "%s: tokens=%p, input=%s, i=%d, utf8=%s, quoted=%s",
-			thisfn, ( void * ) tokens, input, i, utf8 ? "true":"false", quoted ? "true":"false" );
+	output = g_string_sized_new( strlen( tpl->source ));
 
-	output = g_string_new( "" );
+	for( is = 0 ; is < tpl->segments->len ; ++is ){
+		segment = &g_array_index( tpl->segments, TemplateSegment, is );
 
-	/* return NULL if input is NULL
-	 */
-	if( !input ){
-		return( g_string_free( output, TRUE ));
-	}
-
-	/* return an empty string if input is empty
-	 */
-	if( utf8 ){
-		if( !g_utf8_strlen( input, -1 )){
-			return( g_string_free( output, FALSE ));
-		}
-	} else {
-		if( !strlen( input )){
-			return( g_string_free( output, FALSE ));
-		}
-	}
-
-	iter = ( gchar * ) input;
-	prev_iter = iter;
-
-	while(( iter = g_strstr_len( iter, -1, "%" ))){
-		output = g_string_append_len( output, prev_iter, strlen( prev_iter ) - strlen( iter ));
+		switch( segment->token ){
+			case '\0':
+				output = g_string_append_len( output, segment->text, segment->len );
+				break;
 
-		switch( iter[1] ){
 			case 'b':
-				if( tokens->private->basenames ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->basenames, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
+				output = append_nth( output, tokens, LIST_BASENAMES, i, quoted );
 				break;
 
 			case 'B':
-				if( tokens->private->basenames ){
-					output = quote_string_list( output, tokens->private->basenames, quoted );
-				}
+				output = g_string_append( output, get_list_joined( tokens, LIST_BASENAMES, quoted ));
 				break;
 
 			case 'c':
@@ -793,33 +996,19 @@ parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean u
 				break;
 
 			case 'd':
-				if( tokens->private->basedirs ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->basedirs, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
+				output = append_nth( output, tokens, LIST_BASEDIRS, i, quoted );
 				break;
 
 			case 'D':
-				if( tokens->private->basedirs ){
-					output = quote_string_list( output, tokens->private->basedirs, quoted );
-				}
+				output = g_string_append( output, get_list_joined( tokens, LIST_BASEDIRS, quoted ));
 				break;
 
 			case 'f':
-				if( tokens->private->filenames ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->filenames, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
+				output = append_nth( output, tokens, LIST_FILENAMES, i, quoted );
 				break;
 
 			case 'F':
-				if( tokens->private->filenames ){
-					output = quote_string_list( output, tokens->private->filenames, quoted );
-				}
+				output = g_string_append( output, get_list_joined( tokens, LIST_FILENAMES, quoted ));
 				break;
 
 			case 'h':
@@ -831,23 +1020,11 @@ parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean u
 			/* mimetypes are never quoted
 			 */
 			case 'm':
-				if( tokens->private->mimetypes ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->mimetypes, i );
-					if( nth ){
-						output = quote_string( output, nth, FALSE );
-					}
-				}
+				output = append_nth( output, tokens, LIST_MIMETYPES, i, FALSE );
 				break;
 
 			case 'M':
-				if( tokens->private->mimetypes ){
-					output = quote_string_list( output, tokens->private->mimetypes, FALSE );
-				}
-				break;
-
-			/* no-op operators */
-			case 'o':
-			case 'O':
+				output = g_string_append( output, get_list_joined( tokens, LIST_MIMETYPES, FALSE ));
 				break;
 
 			case 'n':
@@ -871,48 +1048,27 @@ parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean u
 				break;
 
 			case 'u':
-				if( tokens->private->uris ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->uris, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
+				output = append_nth( output, tokens, LIST_URIS, i, quoted );
 				break;
 
 			case 'U':
-				if( tokens->private->uris ){
-					output = quote_string_list( output, tokens->private->uris, quoted );
-				}
+				output = g_string_append( output, get_list_joined( tokens, LIST_URIS, quoted ));
 				break;
 
 			case 'w':
-				if( tokens->private->basenames_woext ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->basenames_woext, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
+				output = append_nth( output, tokens, LIST_BASENAMES_WOEXT, i, quoted );
 				break;
 
 			case 'W':
-				if( tokens->private->basenames_woext ){
-					output = quote_string_list( output, tokens->private->basenames_woext, quoted );
-				}
+				output = g_string_append( output, get_list_joined( tokens, LIST_BASENAMES_WOEXT, quoted ));
 				break;
 
 			case 'x':
-				if( tokens->private->exts ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->exts, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
+				output = append_nth( output, tokens, LIST_EXTS, i, quoted );
 				break;
 
 			case 'X':
-				if( tokens->private->exts ){
-					output = quote_string_list( output, tokens->private->exts, quoted );
-				}
+				output = g_string_append( output, get_list_joined( tokens, LIST_EXTS, quoted ));
 				break;
 
 			/* a percent sign
@@ -921,13 +1077,8 @@ parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean u
 				output = g_string_append_c( output, '%' );
 				break;
 		}
-
-		iter += 2;			/* skip the % sign and the character after */
-		prev_iter = iter;	/* store the new start of the string */
 	}
 
-	output = g_string_append_len( output, prev_iter, strlen( prev_iter ));
-
 	return( g_string_free( output, FALSE ));
 }
 
@@ -947,27 +1098,3 @@ quote_string( GString *input, const gchar *name, gboolean quoted )
 
 	return( input );
 }
-
-static GString *
-quote_string_list( GString *input, GSList *names, gboolean quoted )
-{
-	GSList *it;
-	gchar *tmp;
-
-	if( quoted ){
-		GSList *quoted_names = NULL;
-		for( it = names ; it ; it = it->next ){
-			quoted_names = g_slist_append( quoted_names, g_shell_quote(( const gchar * ) it->data ));
-		}
-		tmp = fma_core_utils_slist_join_at_end( quoted_names, " " );
-		fma_core_utils_slist_free( quoted_names );
-
-	} else {
-		tmp = fma_core_utils_slist_join_at_end( g_slist_reverse( names ), " " );
-	}
-
-	input = g_string_append( input, tmp );
-	g_free( tmp );
-
-	return( input );
-}
@@ -48,8 +48,8 @@
  * Adding a parameter requires updating of:
  * - docs/manual/C/figures/fma-legend.png screenshot
  * - docs/manual/C/fma-execution.xml "Multiple execution" paragraph
- * - src/core/fma-tokens.c::is_singular_exec() function
- * - src/core/fma-tokens.c::parse_singular() function
+ * - src/core/fma-tokens.c::template_new() function
+ * - src/core/fma-tokens.c::template_render() function
  * - src/core/fma-object-profile-factory.c:FMAFO_DATA_PARAMETERS comment
  * - src/ui/fma-legend.ui:LegendDialog labels
  *
@@ -113,6 +113,8 @@ GType      fma_tokens_get_type            ( void );
 FMATokens *fma_tokens_new_for_example     ( void );
 FMATokens *fma_tokens_new_from_selection  ( GList *selection );
 
+void       fma_tokens_set_environment     ( FMATokens *tokens, const gchar *cwd, gchar **envp );
+
 gchar     *fma_tokens_parse_for_display   ( const FMATokens *tokens, const gchar *string, gboolean utf8 );
 void       fma_tokens_execute_action      ( const FMATokens *tokens, const FMAObjectProfile *profile );
 
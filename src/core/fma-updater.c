@@ -53,6 +53,14 @@ struct _FMAUpdaterPrivate {
 	gboolean is_level_zero_writable;
 };
 
+/* the batch of items to be written to and deleted from an I/O provider
+ */
+typedef struct {
+	GList *items;
+	GList *deleted;
+}
+	sUpdaterBatch;
+
 static FMAPivotClass *st_parent_class = NULL;
 
 static GType    register_type( void );
@@ -64,6 +72,8 @@ static void     instance_finalize( GObject *object );
 static gboolean are_preferences_locked( const FMAUpdater *updater );
 static gboolean is_level_zero_writable( const FMAUpdater *updater );
 static void     set_writability_status( FMAObjectItem *item, const FMAUpdater *updater );
+static sUpdaterBatch *get_provider_batch( GHashTable *batches, FMAIOProvider *provider );
+static void     free_provider_batch( sUpdaterBatch *batch );
 
 GType
 fma_updater_get_type( void )
@@ -622,3 +632,117 @@ fma_updater_delete_item( const FMAUpdater *updater, const FMAObjectItem *item, G
 
 	return( ret );
 }
+
+/*
+ * fma_updater_write_items:
+ * @updater: this #FMAUpdater instance.
+ * @items: the list of #FMAObjectItem items to be written down to the
+ *  storage subsystem.
+ * @deleted: the list of #FMAObjectItem items to be deleted from the
+ *  storage subsystem.
+ * @failed: a pointer to a #GList where the items which have not been
+ *  written or deleted are appended; the items are not referenced, and
+ *  the list should be g_list_free() by the caller.
+ * @messages: the I/O provider can allocate and store here its error
+ * messages.
+ *
+ * Groups the items by I/O provider, and hands each group to its I/O
+ * provider as a single batch, deletions first.
+ *
+ * As in fma_updater_write_item(), new items are written to the default
+ * writable I/O provider, while new items which are deleted without
+ * having ever been written are just ignored.
+ *
+ * Returns: %TRUE if all the items have been successfully written or
+ * deleted, %FALSE else.
+ */
+gboolean
+fma_updater_write_items( const FMAUpdater *updater, GList *items, GList *deleted, GList **failed, GSList **messages )
+{
+	static const gchar *thisfn = "fma_updater_write_items";
+	gboolean ok;
+	GHashTable *batches;
+	GHashTableIter iter;
+	FMAIOProvider *provider, *writable;
+	sUpdaterBatch *batch;
+	GList *it;
+
+	g_return_val_if_fail( FMA_IS_UPDATER( updater ), FALSE );
+	g_return_val_if_fail( failed, FALSE );
+	g_return_val_if_fail( messages, FALSE );
+
+	ok = TRUE;
+
+	if( !updater->private->dispose_has_run ){
+
+		g_debug( "%s: updater=%p, items=%p (count=%d), deleted=%p (count=%d)",
+				thisfn, ( void * ) updater,
+				( void * ) items, g_list_length( items ),
+				( void * ) deleted, g_list_length( deleted ));
+
+		batches = g_hash_table_new_full( g_direct_hash, g_direct_equal, NULL, ( GDestroyNotify ) free_provider_batch );
+		writable = NULL;
+
+		for( it = deleted ; it ; it = it->next ){
+			provider = fma_object_get_provider( it->data );
+			if( provider ){
+				batch = get_provider_batch( batches, provider );
+				batch->deleted = g_list_prepend( batch->deleted, it->data );
+			}
+		}
+
+		for( it = items ; it ; it = it->next ){
+			provider = fma_object_get_provider( it->data );
+			if( !provider ){
+				if( !writable ){
+					writable = fma_io_provider_find_writable_io_provider( FMA_PIVOT( updater ));
+				}
+				provider = writable;
+			}
+			if( provider ){
+				batch = get_provider_batch( batches, provider );
+				batch->items = g_list_prepend( batch->items, it->data );
+			} else {
+				g_warning( "%s: no writable I/O provider found", thisfn );
+				*failed = g_list_append( *failed, it->data );
+				ok = FALSE;
+			}
+		}
+
+		g_hash_table_iter_init( &iter, batches );
+		while( g_hash_table_iter_next( &iter, ( gpointer * ) &provider, ( gpointer * ) &batch )){
+			batch->items = g_list_reverse( batch->items );
+			batch->deleted = g_list_reverse( batch->deleted );
+			if( fma_io_provider_write_items( provider, batch->items, batch->deleted, failed, messages ) != IIO_PROVIDER_CODE_OK ){
+				ok = FALSE;
+			}
+		}
+
+		g_hash_table_destroy( batches );
+	}
+
+	return( ok );
+}
+
+static sUpdaterBatch *
+get_provider_batch( GHashTable *batches, FMAIOProvider *provider )
+{
+	sUpdaterBatch *batch;
+
+	batch = ( sUpdaterBatch * ) g_hash_table_lookup( batches, provider );
+
+	if( !batch ){
+		batch = g_new0( sUpdaterBatch, 1 );
+		g_hash_table_insert( batches, provider, batch );
+	}
+
+	return( batch );
+}
+
+static void
+free_provider_batch( sUpdaterBatch *batch )
+{
+	g_list_free( batch->items );
+	g_list_free( batch->deleted );
+	g_free( batch );
+}
@@ -91,6 +91,7 @@ gboolean    fma_updater_should_pasted_be_relabeled( const FMAUpdater *updater, c
 GList      *fma_updater_load_items ( FMAUpdater *updater );
 guint       fma_updater_write_item ( const FMAUpdater *updater, FMAObjectItem *item, GSList **messages );
 guint       fma_updater_delete_item( const FMAUpdater *updater, const FMAObjectItem *item, GSList **messages );
+gboolean    fma_updater_write_items( const FMAUpdater *updater, GList *items, GList *deleted, GList **failed, GSList **messages );
 
 G_END_DECLS
 
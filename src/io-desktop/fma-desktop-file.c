@@ -39,6 +39,7 @@
 
 #include "fma-desktop-file.h"
 #include "fma-desktop-keys.h"
+#include "fma-desktop-utils.h"
 
 /* private class data
  */
@@ -219,13 +220,74 @@ FMADesktopFile *
 fma_desktop_file_new_from_path( const gchar *path )
 {
 	static const gchar *thisfn = "fma_desktop_file_new_from_path";
+	GKeyFile *key_file;
+
+	g_debug( "%s: path=%s", thisfn, path );
+	g_return_val_if_fail( path && g_utf8_strlen( path, -1 ) && g_path_is_absolute( path ), NULL );
+
+	key_file = fma_desktop_file_load_key_file( path );
+	if( !key_file ){
+		return( NULL );
+	}
+
+	return( fma_desktop_file_new_from_key_file( path, key_file ));
+}
+
+/**
+ * fma_desktop_file_load_key_file:
+ * @path: the full pathname of a .desktop file.
+ *
+ * Loads the content of the file in a new #GKeyFile.
+ *
+ * As this function does not allocate any GObject, it may be safely called
+ * from a worker thread, the #FMADesktopFile being later built on the
+ * main thread with fma_desktop_file_new_from_key_file().
+ *
+ * Retuns: a newly allocated #GKeyFile which should be g_key_file_free()
+ * by the caller, or %NULL.
+ */
+GKeyFile *
+fma_desktop_file_load_key_file( const gchar *path )
+{
+	static const gchar *thisfn = "fma_desktop_file_load_key_file";
+	GKeyFile *key_file;
+	GError *error;
+
+	g_return_val_if_fail( path && g_path_is_absolute( path ), NULL );
+
+	error = NULL;
+	key_file = g_key_file_new();
+
+	g_key_file_load_from_file( key_file, path, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, &error );
+	if( error ){
+		g_warning( "%s: %s: %s", thisfn, path, error->message );
+		g_error_free( error );
+		g_key_file_free( key_file );
+		return( NULL );
+	}
+
+	return( key_file );
+}
+
+/**
+ * fma_desktop_file_new_from_key_file:
+ * @path: the full pathname of the .desktop file.
+ * @key_file: the #GKeyFile loaded from @path; the returned object takes
+ *  the ownership of it, and it is freed on error.
+ *
+ * Retuns: a newly allocated #FMADesktopFile object, or %NULL.
+ *
+ * First validity checks have been made.
+ */
+FMADesktopFile *
+fma_desktop_file_new_from_key_file( const gchar *path, GKeyFile *key_file )
+{
+	static const gchar *thisfn = "fma_desktop_file_new_from_key_file";
 	FMADesktopFile *ndf;
 	GError *error;
 	gchar *uri;
 
-	ndf = NULL;
-	g_debug( "%s: path=%s", thisfn, path );
-	g_return_val_if_fail( path && g_utf8_strlen( path, -1 ) && g_path_is_absolute( path ), ndf );
+	g_return_val_if_fail( key_file, NULL );
 
 	error = NULL;
 	uri = g_filename_to_uri( path, NULL, &error );
@@ -233,21 +295,16 @@ fma_desktop_file_new_from_path( const gchar *path )
 		g_warning( "%s: %s: %s", thisfn, path, error->message );
 		g_error_free( error );
 		g_free( uri );
+		g_key_file_free( key_file );
 		return( NULL );
 	}
 
 	ndf = ndf_new( uri );
+	g_key_file_free( ndf->private->key_file );
+	ndf->private->key_file = key_file;
 
 	g_free( uri );
 
-	g_key_file_load_from_file( ndf->private->key_file, path, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, &error );
-	if( error ){
-		g_warning( "%s: %s: %s", thisfn, path, error->message );
-		g_error_free( error );
-		g_object_unref( ndf );
-		return( NULL );
-	}
-
 	if( !check_key_file( ndf )){
 		g_object_unref( ndf );
 		return( NULL );
@@ -1138,82 +1195,85 @@ fma_desktop_file_set_uint( const FMADesktopFile *ndf, const gchar *group, const
 }
 
 /**
- * fma_desktop_file_write:
+ * fma_desktop_file_to_data:
  * @ndf: the #FMADesktopFile instance.
+ * @length: [out]: the length of the returned data.
  *
- * Writes the key file to the disk.
- *
- * Returns: %TRUE if write is ok, %FALSE else.
+ * Returns: the content of the key file, as a newly allocated string
+ * which should be g_free() by the caller.
  *
  * Starting with v 3.0.4, locale strings whose identifier include an
  * encoding part are removed from the desktop file when rewriting it
  * (these were wrongly written between v 2.99 and 3.0.3).
  */
+gchar *
+fma_desktop_file_to_data( FMADesktopFile *ndf, gsize *length )
+{
+	gchar *data;
+
+	g_return_val_if_fail( FMA_IS_DESKTOP_FILE( ndf ), NULL );
+
+	data = NULL;
+	*length = 0;
+
+	if( !ndf->private->dispose_has_run ){
+
+		if( ndf->private->key_file ){
+			remove_encoding_part( ndf );
+		}
+
+		data = g_key_file_to_data( ndf->private->key_file, length, NULL );
+	}
+
+	return( data );
+}
+
+/**
+ * fma_desktop_file_write:
+ * @ndf: the #FMADesktopFile instance.
+ *
+ * Writes the key file to the disk.
+ *
+ * The content is first written to a temporary file, flushed to the disk,
+ * and then renamed to the target path, so that the .desktop file is
+ * never seen half-written.
+ *
+ * Returns: %TRUE if write is ok, %FALSE else.
+ */
 gboolean
 fma_desktop_file_write( FMADesktopFile *ndf )
 {
 	static const gchar *thisfn = "fma_desktop_file_write";
 	gboolean ret;
-	gchar *data;
-	GFile *file;
-	GFileOutputStream *stream;
-	GError *error;
+	gchar *data, *path, *temp;
 	gsize length;
 
 	ret = FALSE;
-	error = NULL;
 	g_return_val_if_fail( FMA_IS_DESKTOP_FILE( ndf ), ret );
 
 	if( !ndf->private->dispose_has_run ){
 
-		if( ndf->private->key_file ){
-			remove_encoding_part( ndf );
-		}
-
-		data = g_key_file_to_data( ndf->private->key_file, &length, NULL );
-		file = g_file_new_for_uri( ndf->private->uri );
 		g_debug( "%s: uri=%s", thisfn, ndf->private->uri );
 
-		stream = g_file_replace( file, NULL, FALSE, G_FILE_CREATE_NONE, NULL, &error );
-		if( error ){
-			g_warning( "%s: g_file_replace: %s", thisfn, error->message );
-			g_error_free( error );
-			if( stream ){
-				g_object_unref( stream );
-			}
-			g_object_unref( file );
-			g_free( data );
+		path = g_filename_from_uri( ndf->private->uri, NULL, NULL );
+		if( !path ){
+			g_warning( "%s: %s: not a local file", thisfn, ndf->private->uri );
 			return( FALSE );
 		}
 
-		g_output_stream_write( G_OUTPUT_STREAM( stream ), data, length, NULL, &error );
-		if( error ){
-			g_warning( "%s: g_output_stream_write: %s", thisfn, error->message );
-			g_error_free( error );
-			g_object_unref( stream );
-			g_object_unref( file );
-			g_free( data );
-			return( FALSE );
-		}
+		data = fma_desktop_file_to_data( ndf, &length );
+		temp = fma_desktop_utils_path_write_temp( path, data, length );
 
-		g_output_stream_close( G_OUTPUT_STREAM( stream ), NULL, &error );
-		if( error ){
-			g_warning( "%s: g_output_stream_close: %s", thisfn, error->message );
-			g_error_free( error );
-			g_object_unref( stream );
-			g_object_unref( file );
-			g_free( data );
-			return( FALSE );
+		if( temp ){
+			ret = fma_desktop_utils_path_commit( path, temp );
+			g_free( temp );
 		}
 
-		g_object_unref( stream );
-		g_object_unref( file );
 		g_free( data );
-
-		return( TRUE );
+		g_free( path );
 	}
 
-	return( FALSE );
+	return( ret );
 }
 
 static void
@@ -79,9 +79,13 @@ FMADesktopFile *fma_desktop_file_new              ( void );
 FMADesktopFile *fma_desktop_file_new_from_path    ( const gchar *path );
 FMADesktopFile *fma_desktop_file_new_from_uri     ( const gchar *uri );
 FMADesktopFile *fma_desktop_file_new_for_write    ( const gchar *path );
+FMADesktopFile *fma_desktop_file_new_from_key_file( const gchar *path, GKeyFile *key_file );
+
+GKeyFile       *fma_desktop_file_load_key_file    ( const gchar *path );
 
 GKeyFile       *fma_desktop_file_get_key_file     ( const FMADesktopFile *ndf );
 gchar          *fma_desktop_file_get_key_file_uri ( const FMADesktopFile *ndf );
+gchar          *fma_desktop_file_to_data          ( FMADesktopFile *ndf, gsize *length );
 gboolean        fma_desktop_file_write            ( FMADesktopFile *ndf );
 
 gchar          *fma_desktop_file_get_file_type    ( const FMADesktopFile *ndf );
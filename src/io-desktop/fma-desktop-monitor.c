@@ -235,6 +235,9 @@ fma_desktop_monitor_new( const FMADesktopProvider *provider, const gchar *path )
 }
 
 /*
+ * the event type is forwarded so that the provider is able to tell
+ * created, updated and deleted files apart
+ *
  * - an existing file is modified: n events on dir + m events on file
  * - an existing file is deleted: 1 event on file + 1 event on dir
  * - a new file is created: n events on the dir
@@ -246,5 +249,5 @@ fma_desktop_monitor_new( const FMADesktopProvider *provider, const gchar *path )
 static void
 on_monitor_changed( GFileMonitor *monitor, GFile *file, GFile *other_file, GFileMonitorEvent event_type, FMADesktopMonitor *my_monitor )
 {
-	fma_desktop_provider_on_monitor_event( my_monitor->private->provider );
+	fma_desktop_provider_on_monitor_event( my_monitor->private->provider, my_monitor->private->file, file, other_file, event_type );
 }
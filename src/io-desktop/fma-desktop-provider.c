@@ -32,6 +32,7 @@
 #endif
 
 #include <glib/gi18n.h>
+#include <glib/gstdio.h>
 #include <string.h>
 
 #include <api/fma-core-utils.h>
@@ -42,6 +43,7 @@
 #include "fma-desktop-keys.h"
 #include "fma-desktop-monitor.h"
 #include "fma-desktop-reader.h"
+#include "fma-desktop-utils.h"
 #include "fma-desktop-writer.h"
 
 /* private class data
@@ -53,6 +55,17 @@ struct _FMADesktopProviderClassPrivate {
 static GType         st_module_type = 0;
 static GObjectClass *st_parent_class = NULL;
 static guint         st_burst_timeout = 100;		/* burst timeout in msec */
+static guint         st_self_delay    = 2000;		/* delay of our own events in msec */
+
+/* the event we expect on a path we have just renamed or deleted
+ * a renamed file is reported as created, possibly followed by a
+ * changes-done hint
+ */
+typedef struct {
+	GFileMonitorEvent expected;
+	gint64            expiration;
+}
+	SelfEvent;
 
 static void   class_init( FMADesktopProviderClass *klass );
 static void   instance_init( GTypeInstance *instance, gpointer klass );
@@ -76,6 +89,12 @@ static gchar *iexporter_get_name( const FMAIExporter *exporter );
 static void  *iexporter_get_formats( const FMAIExporter *exporter );
 static void   iexporter_free_formats( const FMAIExporter *exporter, GList *format_list );
 
+static gboolean add_changed_file( FMADesktopProvider *provider, GFile *file, GFileMonitorEvent event, guint type );
+static gboolean is_self_event( FMADesktopProvider *provider, GFile *file, GFileMonitorEvent event );
+static void   set_self_event( FMADesktopProvider *provider, const gchar *path, GFileMonitorEvent expected, gint64 expiration );
+static gboolean is_self_event_expired( const gchar *path, SelfEvent *self_event, gint64 *now );
+static void   free_staged( FMADesktopProvider *provider );
+static gboolean is_desktop_id_available( FMADesktopProvider *provider, const gchar *id );
 static void   on_monitor_timeout( FMADesktopProvider *provider );
 
 GType
@@ -171,11 +190,17 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private = g_new0( FMADesktopProviderPrivate, 1 );
 
 	self->private->dispose_has_run = FALSE;
-	self->private->monitors = NULL;
+	self->private->monitors = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_object_unref );
 	self->private->timeout.timeout = st_burst_timeout;
 	self->private->timeout.handler = ( FMATimeoutFunc ) on_monitor_timeout;
 	self->private->timeout.user_data = self;
 	self->private->timeout.source_id = 0;
+	self->private->changes = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+	self->private->changed_all = FALSE;
+	self->private->transaction = 0;
+	self->private->staged_writes = NULL;
+	self->private->staged_deletes = NULL;
+	self->private->self_written = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_free );
 }
 
 static void
@@ -196,6 +221,15 @@ instance_dispose( GObject *object )
 
 		fma_desktop_provider_release_monitors( self );
 
+		if( self->private->timeout.source_id ){
+			g_source_remove( self->private->timeout.source_id );
+			self->private->timeout.source_id = 0;
+		}
+		g_hash_table_destroy( self->private->monitors );
+		g_hash_table_destroy( self->private->changes );
+		free_staged( self );
+		g_hash_table_destroy( self->private->self_written );
+
 		/* chain up to the parent class */
 		if( G_OBJECT_CLASS( st_parent_class )->dispose ){
 			G_OBJECT_CLASS( st_parent_class )->dispose( object );
@@ -234,11 +268,14 @@ iio_provider_iface_init( FMAIIOProviderInterface *iface )
 	iface->get_id = iio_provider_get_id;
 	iface->get_name = iio_provider_get_name;
 	iface->read_items = fma_desktop_reader_iio_provider_read_items;
+	iface->read_item = fma_desktop_reader_iio_provider_read_item;
+	iface->get_sources = fma_desktop_reader_iio_provider_get_sources;
 	iface->is_willing_to_write = fma_desktop_writer_iio_provider_is_willing_to_write;
 	iface->is_able_to_write = fma_desktop_writer_iio_provider_is_able_to_write;
 	iface->write_item = fma_desktop_writer_iio_provider_write_item;
 	iface->delete_item = fma_desktop_writer_iio_provider_delete_item;
 	iface->duplicate_data = fma_desktop_writer_iio_provider_duplicate_data;
+	iface->write_items = fma_desktop_writer_iio_provider_write_items;
 }
 
 static guint
@@ -311,6 +348,7 @@ iexporter_iface_init( FMAIExporterInterface *iface )
 	iface->free_formats = iexporter_free_formats;
 	iface->to_file = fma_desktop_writer_iexporter_export_to_file;
 	iface->to_buffer = fma_desktop_writer_iexporter_export_to_buffer;
+	iface->to_stream = fma_desktop_writer_iexporter_export_to_stream;
 }
 
 static guint
@@ -343,6 +381,9 @@ iexporter_free_formats( const FMAIExporter *exporter, GList *format_list )
  * @dir: the path to the directory to be monitored. May not exist.
  *
  * Installs a GIO monitor on the given directory.
+ *
+ * Monitors are persistent: a directory which is already monitored is
+ * left untouched, so that no event is lost while the items are reloaded.
  */
 void
 fma_desktop_provider_add_monitor( FMADesktopProvider *provider, const gchar *dir )
@@ -353,26 +394,205 @@ fma_desktop_provider_add_monitor( FMADesktopProvider *provider, const gchar *dir
 
 	if( !provider->private->dispose_has_run ){
 
-		monitor = fma_desktop_monitor_new( provider, dir );
-		provider->private->monitors = g_list_prepend( provider->private->monitors, monitor );
+		if( !g_hash_table_contains( provider->private->monitors, dir )){
+			monitor = fma_desktop_monitor_new( provider, dir );
+			if( monitor ){
+				g_hash_table_insert( provider->private->monitors, g_strdup( dir ), monitor );
+			}
+		}
 	}
 }
 
 /**
  * fma_desktop_provider_on_monitor_event:
  * @provider: this #FMADesktopProvider object.
+ * @dir: the monitored directory.
+ * @file: the file the event is about.
+ * @other_file: the other file involved in the event, if any.
+ * @event_type: the type of the event.
  *
  * Factorize events received from GIO when monitoring desktop directories.
+ *
+ * The .desktop files which are involved in the burst of events are
+ * collected along with the kind of change (created, updated, deleted),
+ * so that only these items have to be reloaded; an event on the
+ * monitored directory itself means that all items have to be reloaded.
+ *
+ * Events on other files (e.g. temporary files), and the events which
+ * result from our own writes, are ignored.
  */
 void
-fma_desktop_provider_on_monitor_event( FMADesktopProvider *provider )
+fma_desktop_provider_on_monitor_event( FMADesktopProvider *provider, GFile *dir, GFile *file, GFile *other_file, GFileMonitorEvent event_type )
 {
+	gboolean relevant;
+
 	g_return_if_fail( FMA_IS_DESKTOP_PROVIDER( provider ));
 
 	if( !provider->private->dispose_has_run ){
 
-		fma_timeout_event( &provider->private->timeout );
+		relevant = FALSE;
+
+		if( !file || g_file_equal( file, dir )){
+			provider->private->changed_all = TRUE;
+			relevant = TRUE;
+
+		} else {
+			switch( event_type ){
+				case G_FILE_MONITOR_EVENT_CREATED:
+					relevant = add_changed_file( provider, file, event_type, IIO_PROVIDER_CHANGE_CREATED );
+					break;
+
+				case G_FILE_MONITOR_EVENT_CHANGED:
+				case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+				case G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED:
+					relevant = add_changed_file( provider, file, event_type, IIO_PROVIDER_CHANGE_UPDATED );
+					break;
+
+				case G_FILE_MONITOR_EVENT_DELETED:
+					relevant = add_changed_file( provider, file, event_type, IIO_PROVIDER_CHANGE_DELETED );
+					break;
+
+				case G_FILE_MONITOR_EVENT_MOVED:
+					relevant = add_changed_file( provider, file, G_FILE_MONITOR_EVENT_DELETED, IIO_PROVIDER_CHANGE_DELETED );
+					if( other_file ){
+						relevant |= add_changed_file( provider, other_file, G_FILE_MONITOR_EVENT_CREATED, IIO_PROVIDER_CHANGE_CREATED );
+					}
+					break;
+
+				default:
+					provider->private->changed_all = TRUE;
+					relevant = TRUE;
+					break;
+			}
+		}
+
+		if( relevant ){
+			fma_timeout_event( &provider->private->timeout );
+		}
+	}
+}
+
+/*
+ * only .desktop files are of interest for us, unless we have just
+ * written them ourselves
+ *
+ * the first and the last events of the burst are kept: a file which is
+ * created then modified is still a new one, and a file which is deleted
+ * then recreated has only been updated
+ *
+ * returns %TRUE if the change has been recorded
+ */
+static gboolean
+add_changed_file( FMADesktopProvider *provider, GFile *file, GFileMonitorEvent event, guint type )
+{
+	gchar *bname, *id;
+	guint previous;
+	gboolean added;
+
+	added = FALSE;
+	bname = g_file_get_basename( file );
+
+	if( bname && g_str_has_suffix( bname, FMA_DESKTOP_FILE_SUFFIX ) && !is_self_event( provider, file, event )){
+		id = fma_core_utils_str_remove_suffix( bname, FMA_DESKTOP_FILE_SUFFIX );
+		previous = GPOINTER_TO_UINT( g_hash_table_lookup( provider->private->changes, id ));
+
+		if( previous == IIO_PROVIDER_CHANGE_CREATED && type != IIO_PROVIDER_CHANGE_DELETED ){
+			type = IIO_PROVIDER_CHANGE_CREATED;
+
+		} else if( previous == IIO_PROVIDER_CHANGE_DELETED && type == IIO_PROVIDER_CHANGE_CREATED ){
+			type = IIO_PROVIDER_CHANGE_UPDATED;
+		}
+
+		g_hash_table_insert( provider->private->changes, id, GUINT_TO_POINTER( type ));
+		added = TRUE;
+	}
+
+	g_free( bname );
+
+	return( added );
+}
+
+/*
+ * whether the @event on this @file is the one expected from one of our
+ * own writes: each expected event is only consumed once, so that an
+ * outside change of the same file is still seen
+ */
+static gboolean
+is_self_event( FMADesktopProvider *provider, GFile *file, GFileMonitorEvent event )
+{
+	gchar *path;
+	SelfEvent *self_event;
+	gboolean is_self;
+
+	is_self = FALSE;
+	path = g_file_get_path( file );
+
+	if( path ){
+		self_event = ( SelfEvent * ) g_hash_table_lookup( provider->private->self_written, path );
+
+		if( self_event ){
+			if( g_get_monotonic_time() < self_event->expiration && event == self_event->expected ){
+				is_self = TRUE;
+			}
+			if( is_self && event == G_FILE_MONITOR_EVENT_CREATED ){
+				self_event->expected = G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT;
+			} else {
+				g_hash_table_remove( provider->private->self_written, path );
+			}
+		}
+		g_free( path );
 	}
+
+	return( is_self );
+}
+
+static void
+set_self_event( FMADesktopProvider *provider, const gchar *path, GFileMonitorEvent expected, gint64 expiration )
+{
+	SelfEvent *self_event;
+
+	self_event = g_new( SelfEvent, 1 );
+	self_event->expected = expected;
+	self_event->expiration = expiration;
+	g_hash_table_insert( provider->private->self_written, g_strdup( path ), self_event );
+}
+
+/*
+ * the expected events which have never come, e.g. because the monitor
+ * reports them otherwise, are purged at the next commit
+ */
+static gboolean
+is_self_event_expired( const gchar *path, SelfEvent *self_event, gint64 *now )
+{
+	return( *now >= self_event->expiration );
+}
+
+/*
+ * whether a .desktop file with this @id still exists in one of the
+ * monitored directories, e.g. when a user file which overrode a system
+ * one has just been deleted
+ */
+static gboolean
+is_desktop_id_available( FMADesktopProvider *provider, const gchar *id )
+{
+	GHashTableIter iter;
+	const gchar *dir;
+	gchar *bname, *path;
+	gboolean found;
+
+	found = FALSE;
+	bname = g_strdup_printf( "%s%s", id, FMA_DESKTOP_FILE_SUFFIX );
+	g_hash_table_iter_init( &iter, provider->private->monitors );
+
+	while( !found && g_hash_table_iter_next( &iter, ( gpointer * ) &dir, NULL )){
+		path = g_build_filename( dir, bname, NULL );
+		found = g_file_test( path, G_FILE_TEST_IS_REGULAR );
+		g_free( path );
+	}
+
+	g_free( bname );
+
+	return( found );
 }
 
 /**
@@ -386,24 +606,300 @@ fma_desktop_provider_release_monitors( FMADesktopProvider *provider )
 {
 	g_return_if_fail( FMA_IS_DESKTOP_PROVIDER( provider ));
 
-	if( provider->private->monitors ){
+	g_hash_table_remove_all( provider->private->monitors );
+}
+
+/**
+ * fma_desktop_provider_begin_write:
+ * @provider: this #FMADesktopProvider object.
+ *
+ * Opens a write transaction: until the matching
+ * fma_desktop_provider_commit_write(), the .desktop files to be written
+ * or deleted are only staged.
+ *
+ * Transactions may be nested: only the outermost commit actually writes
+ * down the staged files.
+ */
+void
+fma_desktop_provider_begin_write( FMADesktopProvider *provider )
+{
+	g_return_if_fail( FMA_IS_DESKTOP_PROVIDER( provider ));
+
+	if( !provider->private->dispose_has_run ){
+
+		provider->private->transaction += 1;
+	}
+}
+
+/**
+ * fma_desktop_provider_stage_write:
+ * @provider: this #FMADesktopProvider object.
+ * @ndf: the #FMADesktopFile to be written.
+ *
+ * Stages the @ndf file to be written at commit time. The content of
+ * the key file is only serialized at that time, so that a file which
+ * is staged several times is only written once.
+ */
+void
+fma_desktop_provider_stage_write( FMADesktopProvider *provider, FMADesktopFile *ndf )
+{
+	g_return_if_fail( FMA_IS_DESKTOP_PROVIDER( provider ));
+	g_return_if_fail( FMA_IS_DESKTOP_FILE( ndf ));
+	g_return_if_fail( provider->private->transaction > 0 );
+
+	if( !provider->private->dispose_has_run ){
+
+		if( !g_list_find( provider->private->staged_writes, ndf )){
+			provider->private->staged_writes = g_list_prepend( provider->private->staged_writes, g_object_ref( ndf ));
+		}
+	}
+}
+
+/**
+ * fma_desktop_provider_stage_delete:
+ * @provider: this #FMADesktopProvider object.
+ * @uri: the URI of the .desktop file to be deleted.
+ *
+ * Stages the @uri file to be deleted at commit time. Deletions are
+ * applied after the writes.
+ */
+void
+fma_desktop_provider_stage_delete( FMADesktopProvider *provider, const gchar *uri )
+{
+	g_return_if_fail( FMA_IS_DESKTOP_PROVIDER( provider ));
+	g_return_if_fail( uri && strlen( uri ));
+	g_return_if_fail( provider->private->transaction > 0 );
+
+	if( !provider->private->dispose_has_run ){
 
-		g_list_foreach( provider->private->monitors, ( GFunc ) g_object_unref, NULL );
-		g_list_free( provider->private->monitors );
-		provider->private->monitors = NULL;
+		provider->private->staged_deletes = g_slist_prepend( provider->private->staged_deletes, g_strdup( uri ));
 	}
 }
 
+/**
+ * fma_desktop_provider_commit_write:
+ * @provider: this #FMADesktopProvider object.
+ *
+ * Closes a write transaction. When this is the outermost one, the staged
+ * files are actually written down:
+ * - all the new contents are first written and flushed to temporary
+ *   files; if one of them fails, nothing is changed on the disk
+ * - then the temporary files are renamed to their final path; if one
+ *   of them fails, the remaining ones are dropped, and nothing is
+ *   deleted
+ * - last the staged files are deleted, unless they have just been
+ *   rewritten, up to the first failure, and the involved directories
+ *   are flushed.
+ *
+ * Only the first phase is all-or-nothing: a failure in the last two
+ * phases leaves on the disk the files which have already been renamed
+ * or deleted. As the deletions come last, an item whose file has been
+ * deleted has always been deleted along with all the writes of the
+ * transaction.
+ *
+ * The monitor events which result from these writes are ignored by this
+ * @provider, as its caller already knows about these changes. Other
+ * processes receive them as a single burst, and so only reload once.
+ *
+ * Returns: %TRUE if the transaction has been successfully committed,
+ * %FALSE else.
+ */
+gboolean
+fma_desktop_provider_commit_write( FMADesktopProvider *provider )
+{
+	static const gchar *thisfn = "fma_desktop_provider_commit_write";
+	gboolean ok;
+	GList *it, *paths, *temps, *ip, *itmp;
+	GSList *is;
+	GHashTable *dirs;
+	GHashTableIter iter;
+	const gchar *dir;
+	gchar *uri, *path, *temp, *data;
+	gsize length;
+	gint64 now, expiration;
+
+	g_return_val_if_fail( FMA_IS_DESKTOP_PROVIDER( provider ), FALSE );
+	g_return_val_if_fail( provider->private->transaction > 0, FALSE );
+
+	if( provider->private->dispose_has_run ){
+		return( FALSE );
+	}
+
+	provider->private->transaction -= 1;
+	if( provider->private->transaction > 0 ){
+		return( TRUE );
+	}
+
+	g_debug( "%s: provider=%p, writes=%u, deletes=%u", thisfn, ( void * ) provider,
+			g_list_length( provider->private->staged_writes ), g_slist_length( provider->private->staged_deletes ));
+
+	ok = TRUE;
+	paths = NULL;
+	temps = NULL;
+
+	for( it = g_list_last( provider->private->staged_writes ) ; it && ok ; it = it->prev ){
+		uri = fma_desktop_file_get_key_file_uri( FMA_DESKTOP_FILE( it->data ));
+		path = g_filename_from_uri( uri, NULL, NULL );
+		g_free( uri );
+		temp = NULL;
+
+		if( path ){
+			data = fma_desktop_file_to_data( FMA_DESKTOP_FILE( it->data ), &length );
+			temp = fma_desktop_utils_path_write_temp( path, data, length );
+			g_free( data );
+		}
+
+		if( temp ){
+			paths = g_list_prepend( paths, path );
+			temps = g_list_prepend( temps, temp );
+
+		} else {
+			g_free( path );
+			ok = FALSE;
+		}
+	}
+
+	if( !ok ){
+		for( itmp = temps ; itmp ; itmp = itmp->next ){
+			g_unlink(( const gchar * ) itmp->data );
+		}
+		g_list_free_full( temps, ( GDestroyNotify ) g_free );
+		g_list_free_full( paths, ( GDestroyNotify ) g_free );
+		free_staged( provider );
+		return( FALSE );
+	}
+
+	/* the transaction is now actually applied
+	 */
+	now = g_get_monotonic_time();
+	g_hash_table_foreach_remove( provider->private->self_written, ( GHRFunc ) is_self_event_expired, &now );
+
+	expiration = now + ( gint64 ) st_self_delay * 1000;
+	dirs = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+
+	for( ip = paths, itmp = temps ; ip && itmp ; ip = ip->next, itmp = itmp->next ){
+		if( ok ){
+			set_self_event( provider, ( const gchar * ) ip->data, G_FILE_MONITOR_EVENT_CREATED, expiration );
+			g_hash_table_add( dirs, g_path_get_dirname(( const gchar * ) ip->data ));
+			ok = fma_desktop_utils_path_commit(( const gchar * ) ip->data, ( const gchar * ) itmp->data );
+
+		} else {
+			g_unlink(( const gchar * ) itmp->data );
+		}
+	}
+
+	provider->private->staged_deletes = g_slist_reverse( provider->private->staged_deletes );
+
+	for( is = provider->private->staged_deletes ; is && ok ; is = is->next ){
+		path = g_filename_from_uri(( const gchar * ) is->data, NULL, NULL );
+
+		/* an item may be deleted and then written again to the same path
+		 */
+		if( path && g_list_find_custom( paths, path, ( GCompareFunc ) strcmp )){
+			g_free( path );
+			continue;
+		}
+		if( path ){
+			set_self_event( provider, path, G_FILE_MONITOR_EVENT_DELETED, expiration );
+			g_hash_table_add( dirs, g_path_get_dirname( path ));
+			g_free( path );
+		}
+		if( !fma_desktop_utils_uri_delete(( const gchar * ) is->data )){
+			ok = FALSE;
+		}
+	}
+
+	g_hash_table_iter_init( &iter, dirs );
+	while( g_hash_table_iter_next( &iter, ( gpointer * ) &dir, NULL )){
+		fma_desktop_utils_dir_sync( dir );
+	}
+
+	g_hash_table_destroy( dirs );
+	g_list_free_full( temps, ( GDestroyNotify ) g_free );
+	g_list_free_full( paths, ( GDestroyNotify ) g_free );
+	free_staged( provider );
+
+	return( ok );
+}
+
+/**
+ * fma_desktop_provider_rollback_write:
+ * @provider: this #FMADesktopProvider object.
+ *
+ * Cancels the current write transaction, along with all the transactions
+ * it is nested in. Nothing has been written to the disk yet.
+ */
+void
+fma_desktop_provider_rollback_write( FMADesktopProvider *provider )
+{
+	g_return_if_fail( FMA_IS_DESKTOP_PROVIDER( provider ));
+
+	if( !provider->private->dispose_has_run ){
+
+		provider->private->transaction = 0;
+		free_staged( provider );
+	}
+}
+
+static void
+free_staged( FMADesktopProvider *provider )
+{
+	g_list_free_full( provider->private->staged_writes, ( GDestroyNotify ) g_object_unref );
+	provider->private->staged_writes = NULL;
+	g_slist_free_full( provider->private->staged_deletes, ( GDestroyNotify ) g_free );
+	provider->private->staged_deletes = NULL;
+}
+
 static void
 on_monitor_timeout( FMADesktopProvider *provider )
 {
 	static const gchar *thisfn = "fma_desktop_provider_on_monitor_timeout";
+	GHashTableIter iter;
+	const gchar *id;
+	gpointer type;
+	GSList *changes;
+	FMAIIOProviderChange *change;
 
 	/* last individual notification is older that the st_burst_timeout
 	 * so triggers the FMAIIOProvider interface and destroys this timeout
 	 */
-	g_debug( "%s: triggering FMAIIOProvider interface for provider=%p (%s)",
-			thisfn, ( void * ) provider, G_OBJECT_TYPE_NAME( provider ));
+	g_debug( "%s: triggering FMAIIOProvider interface for provider=%p (%s), changed_all=%s, changes=%u",
+			thisfn, ( void * ) provider, G_OBJECT_TYPE_NAME( provider ),
+			provider->private->changed_all ? "True":"False", g_hash_table_size( provider->private->changes ));
+
+	if( provider->private->changed_all || !g_hash_table_size( provider->private->changes )){
+		fma_iio_provider_item_changed( FMA_IIO_PROVIDER( provider ));
+
+	} else {
+		changes = NULL;
+		g_hash_table_iter_init( &iter, provider->private->changes );
+
+		while( g_hash_table_iter_next( &iter, ( gpointer * ) &id, &type )){
+			change = g_new0( FMAIIOProviderChange, 1 );
+			change->id = ( gchar * ) id;
+			change->type = GPOINTER_TO_UINT( type );
+
+			/* the final state of the item depends on all the monitored
+			 * directories, as the first found .desktop file is the
+			 * preferred one
+			 */
+			if( is_desktop_id_available( provider, id )){
+				if( change->type == IIO_PROVIDER_CHANGE_DELETED ){
+					change->type = IIO_PROVIDER_CHANGE_UPDATED;
+				}
+			} else {
+				change->type = IIO_PROVIDER_CHANGE_DELETED;
+			}
+
+			changes = g_slist_prepend( changes, change );
+		}
+
+		fma_iio_provider_items_changed_full( FMA_IIO_PROVIDER( provider ), changes );
+
+		/* identifiers are owned by the hash table */
+		g_slist_free_full( changes, ( GDestroyNotify ) g_free );
+	}
 
-	fma_iio_provider_item_changed( FMA_IIO_PROVIDER( provider ));
+	g_hash_table_remove_all( provider->private->changes );
+	provider->private->changed_all = FALSE;
 }
@@ -40,7 +40,7 @@
  * should only be used through the FMAIIOProvider interface.
  */
 
-#include <glib-object.h>
+#include <gio/gio.h>
 
 #include <api/fma-object-item.h>
 #include <api/fma-timeout.h>
@@ -60,9 +60,15 @@ G_BEGIN_DECLS
  */
 typedef struct _FMADesktopProviderPrivate {
 	/*< private >*/
-	gboolean   dispose_has_run;
-	GList     *monitors;
-	FMATimeout timeout;
+	gboolean    dispose_has_run;
+	GHashTable *monitors;				/* path -> FMADesktopMonitor */
+	FMATimeout  timeout;
+	GHashTable *changes;				/* id -> FMAIIOProviderChangeType */
+	gboolean    changed_all;
+	guint       transaction;			/* count of nested write transactions */
+	GList      *staged_writes;			/* FMADesktopFile to be written */
+	GSList     *staged_deletes;			/* uris to be deleted */
+	GHashTable *self_written;			/* path -> the next event expected from our own writes */
 }
 	FMADesktopProviderPrivate;
 
@@ -91,9 +97,15 @@ GType fma_desktop_provider_get_type        ( void );
 void  fma_desktop_provider_register_type   ( GTypeModule *module );
 
 void  fma_desktop_provider_add_monitor     ( FMADesktopProvider *provider, const gchar *dir );
-void  fma_desktop_provider_on_monitor_event( FMADesktopProvider *provider );
+void  fma_desktop_provider_on_monitor_event( FMADesktopProvider *provider, GFile *dir, GFile *file, GFile *other_file, GFileMonitorEvent event_type );
 void  fma_desktop_provider_release_monitors( FMADesktopProvider *provider );
 
+void     fma_desktop_provider_begin_write   ( FMADesktopProvider *provider );
+void     fma_desktop_provider_stage_write   ( FMADesktopProvider *provider, FMADesktopFile *ndf );
+void     fma_desktop_provider_stage_delete  ( FMADesktopProvider *provider, const gchar *uri );
+gboolean fma_desktop_provider_commit_write  ( FMADesktopProvider *provider );
+void     fma_desktop_provider_rollback_write( FMADesktopProvider *provider );
+
 G_END_DECLS
 
 #endif /* __IO_DESKTOP_FMA_DESKTOP_PROVIDER_H__ */
@@ -48,11 +48,20 @@
 #include "fma-desktop-xdg-dirs.h"
 
 typedef struct {
-	gchar *path;
-	gchar *id;
+	gchar    *path;
+	gchar    *id;
+	gboolean  preloaded;				/* whether load_desktop_paths() has run */
+	GKeyFile *key_file;					/* NULL if preloading has failed */
 }
 	sDesktopPath;
 
+/* .desktop files are parsed on a thread pool when there are at least
+ * this count of them; the FMADesktopFile and the FMAObjectItem objects
+ * themselves are always built on the calling thread
+ */
+#define READ_PARALLEL_MIN_FILES		32
+#define READ_MAX_THREADS			8
+
 /* the structure passed as reader data to FMAIFactoryObject
  */
 typedef struct {
@@ -64,9 +73,11 @@ typedef struct {
 #define ERR_NOT_DESKTOP		_( "The Desktop I/O Provider is not able to handle the URI" )
 
 static GList             *get_list_of_desktop_paths( FMADesktopProvider *provider, GSList **mesages );
-static void               get_list_of_desktop_files( const FMADesktopProvider *provider, GList **files, const gchar *dir, GSList **messages );
-static gboolean           is_already_loaded( const FMADesktopProvider *provider, GList *files, const gchar *desktop_id );
+static void               get_list_of_desktop_files( const FMADesktopProvider *provider, GList **files, GHashTable *seen, const gchar *dir, GSList **messages );
+static gboolean           is_already_loaded( const FMADesktopProvider *provider, GHashTable *seen, const gchar *desktop_id );
 static GList             *desktop_path_from_id( const FMADesktopProvider *provider, GList *files, const gchar *dir, const gchar *id );
+static void               load_desktop_paths( GList *paths );
+static void               load_desktop_path( sDesktopPath *dps, gpointer user_data );
 static FMAIFactoryObject *item_from_desktop_path( const FMADesktopProvider *provider, sDesktopPath *dps, GSList **messages );
 static FMAIFactoryObject *item_from_desktop_file( const FMADesktopProvider *provider, FMADesktopFile *ndf, GSList **messages );
 static void               desktop_weak_notify( FMADesktopFile *ndf, GObject *item );
@@ -98,9 +109,10 @@ fma_desktop_reader_iio_provider_read_items( const FMAIIOProvider *provider, GSLi
 	g_return_val_if_fail( FMA_IS_IIO_PROVIDER( provider ), NULL );
 
 	items = NULL;
-	fma_desktop_provider_release_monitors( FMA_DESKTOP_PROVIDER( provider ));
 
 	desktop_paths = get_list_of_desktop_paths( FMA_DESKTOP_PROVIDER( provider ), messages );
+	load_desktop_paths( desktop_paths );
+
 	for( ip = desktop_paths ; ip ; ip = ip->next ){
 
 		item = item_from_desktop_path( FMA_DESKTOP_PROVIDER( provider ), ( sDesktopPath * ) ip->data, messages );
@@ -117,6 +129,120 @@ fma_desktop_reader_iio_provider_read_items( const FMAIIOProvider *provider, GSLi
 	return( items );
 }
 
+/*
+ * Returns a newly allocated FMAIFactoryObject-derived object, or %NULL
+ * if the item doesn't exist (anymore)
+ *
+ * As when reading the whole list of items, the .desktop file is searched
+ * for in the ordered list of XDG_DATA_DIRS/subdirs, the first found being
+ * the preferred one; monitors are left untouched.
+ *
+ * This is implementation of FMAIIOProvider::read_item method
+ */
+FMAObjectItem *
+fma_desktop_reader_iio_provider_read_item( const FMAIIOProvider *provider, const gchar *id, GSList **messages )
+{
+	static const gchar *thisfn = "fma_desktop_reader_iio_provider_read_item";
+	FMAIFactoryObject *item;
+	GSList *xdg_dirs, *idir;
+	GSList *subdirs, *isub;
+	gchar *dir, *bname;
+	sDesktopPath dps;
+	gboolean found;
+
+	g_debug( "%s: provider=%p (%s), id=%s, messages=%p",
+			thisfn, ( void * ) provider, G_OBJECT_TYPE_NAME( provider ), id, ( void * ) messages );
+
+	g_return_val_if_fail( FMA_IS_IIO_PROVIDER( provider ), NULL );
+
+	item = NULL;
+	found = FALSE;
+	xdg_dirs = fma_desktop_xdg_dirs_get_data_dirs();
+	subdirs = fma_core_utils_slist_from_split( FMA_DESKTOP_PROVIDER_SUBDIRS, G_SEARCHPATH_SEPARATOR_S );
+	bname = g_strdup_printf( "%s%s", id, FMA_DESKTOP_FILE_SUFFIX );
+
+	for( idir = xdg_dirs ; idir && !found ; idir = idir->next ){
+		for( isub = subdirs ; isub && !found ; isub = isub->next ){
+
+			dir = g_build_filename(( gchar * ) idir->data, ( gchar * ) isub->data, NULL );
+			dps.path = g_build_filename( dir, bname, NULL );
+			dps.id = ( gchar * ) id;
+			dps.preloaded = FALSE;
+			dps.key_file = NULL;
+
+			if( g_file_test( dps.path, G_FILE_TEST_IS_REGULAR )){
+				found = TRUE;
+				item = item_from_desktop_path( FMA_DESKTOP_PROVIDER( provider ), &dps, messages );
+			}
+
+			g_free( dps.path );
+			g_free( dir );
+		}
+	}
+
+	g_free( bname );
+	fma_core_utils_slist_free( subdirs );
+	fma_core_utils_slist_free( xdg_dirs );
+
+	g_debug( "%s: item=%p", thisfn, ( void * ) item );
+	return( item ? FMA_OBJECT_ITEM( item ) : NULL );
+}
+
+/*
+ * Returns the list of the XDG_DATA_DIRS/subdirs directories, along with
+ * the .desktop files they contain
+ *
+ * As the items may then be loaded from the FMAPivot cache without being
+ * read, this is also where the monitors are installed, if not already done.
+ *
+ * This is implementation of FMAIIOProvider::get_sources method
+ */
+GSList *
+fma_desktop_reader_iio_provider_get_sources( const FMAIIOProvider *provider )
+{
+	static const gchar *thisfn = "fma_desktop_reader_iio_provider_get_sources";
+	GSList *sources;
+	GSList *xdg_dirs, *idir;
+	GSList *subdirs, *isub;
+	gchar *dir;
+	GDir *dir_handle;
+	const gchar *name;
+
+	g_return_val_if_fail( FMA_IS_IIO_PROVIDER( provider ), NULL );
+
+	sources = NULL;
+
+	xdg_dirs = fma_desktop_xdg_dirs_get_data_dirs();
+	subdirs = fma_core_utils_slist_from_split( FMA_DESKTOP_PROVIDER_SUBDIRS, G_SEARCHPATH_SEPARATOR_S );
+
+	for( idir = xdg_dirs ; idir ; idir = idir->next ){
+		for( isub = subdirs ; isub ; isub = isub->next ){
+
+			dir = g_build_filename(( gchar * ) idir->data, ( gchar * ) isub->data, NULL );
+			fma_desktop_provider_add_monitor( FMA_DESKTOP_PROVIDER( provider ), dir );
+
+			dir_handle = g_file_test( dir, G_FILE_TEST_IS_DIR ) ? g_dir_open( dir, 0, NULL ) : NULL;
+			if( dir_handle ){
+				while(( name = g_dir_read_name( dir_handle ))){
+					if( g_str_has_suffix( name, FMA_DESKTOP_FILE_SUFFIX )){
+						sources = g_slist_prepend( sources, g_build_filename( dir, name, NULL ));
+					}
+				}
+				g_dir_close( dir_handle );
+			}
+
+			sources = g_slist_prepend( sources, dir );
+		}
+	}
+
+	fma_core_utils_slist_free( subdirs );
+	fma_core_utils_slist_free( xdg_dirs );
+
+	g_debug( "%s: provider=%p, count=%d", thisfn, ( void * ) provider, g_slist_length( sources ));
+
+	return( g_slist_reverse( sources ));
+}
+
 /*
  * returns a list of sDesktopPath items
  *
@@ -133,9 +259,11 @@ get_list_of_desktop_paths( FMADesktopProvider *provider, GSList **messages )
 	GList *files;
 	GSList *xdg_dirs, *idir;
 	GSList *subdirs, *isub;
+	GHashTable *seen;
 	gchar *dir;
 
 	files = NULL;
+	seen = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
 	xdg_dirs = fma_desktop_xdg_dirs_get_data_dirs();
 	subdirs = fma_core_utils_slist_from_split( FMA_DESKTOP_PROVIDER_SUBDIRS, G_SEARCHPATH_SEPARATOR_S );
 
@@ -149,11 +277,12 @@ get_list_of_desktop_paths( FMADesktopProvider *provider, GSList **messages )
 
 			dir = g_build_filename(( gchar * ) idir->data, ( gchar * ) isub->data, NULL );
 			fma_desktop_provider_add_monitor( provider, dir );
-			get_list_of_desktop_files( provider, &files, dir, messages );
+			get_list_of_desktop_files( provider, &files, seen, dir, messages );
 			g_free( dir );
 		}
 	}
 
+	g_hash_table_destroy( seen );
 	fma_core_utils_slist_free( subdirs );
 	fma_core_utils_slist_free( xdg_dirs );
 
@@ -163,9 +292,11 @@ get_list_of_desktop_paths( FMADesktopProvider *provider, GSList **messages )
 /*
  * scans the directory for .desktop files
  * only adds to the list those which have not been yet loaded
+ *
+ * @seen: the set of the (lowercased) desktop ids already added to @files.
  */
 static void
-get_list_of_desktop_files( const FMADesktopProvider *provider, GList **files, const gchar *dir, GSList **messages )
+get_list_of_desktop_files( const FMADesktopProvider *provider, GList **files, GHashTable *seen, const gchar *dir, GSList **messages )
 {
 	static const gchar *thisfn = "fma_desktop_reader_get_list_of_desktop_files";
 	GDir *dir_handle;
@@ -196,7 +327,7 @@ get_list_of_desktop_files( const FMADesktopProvider *provider, GList **files, co
 		while(( name = g_dir_read_name( dir_handle ))){
 			if( g_str_has_suffix( name, FMA_DESKTOP_FILE_SUFFIX )){
 				desktop_id = fma_core_utils_str_remove_suffix( name, FMA_DESKTOP_FILE_SUFFIX );
-				if( !is_already_loaded( provider, *files, desktop_id )){
+				if( !is_already_loaded( provider, seen, desktop_id )){
 					*files = desktop_path_from_id( provider, *files, dir, desktop_id );
 				}
 				g_free( desktop_id );
@@ -210,19 +341,23 @@ close_dir_handle:
 	}
 }
 
+/*
+ * desktop ids are compared case-insensitively: the lowercased id is
+ * recorded in @seen the first time it is found
+ */
 static gboolean
-is_already_loaded( const FMADesktopProvider *provider, GList *files, const gchar *desktop_id )
+is_already_loaded( const FMADesktopProvider *provider, GHashTable *seen, const gchar *desktop_id )
 {
 	gboolean found;
-	GList *ip;
-	sDesktopPath *dps;
+	gchar *key;
 
-	found = FALSE;
-	for( ip = files ; ip && !found ; ip = ip->next ){
-		dps = ( sDesktopPath * ) ip->data;
-		if( !g_ascii_strcasecmp( dps->id, desktop_id )){
-			found = TRUE;
-		}
+	key = g_ascii_strdown( desktop_id, -1 );
+	found = g_hash_table_contains( seen, key );
+
+	if( found ){
+		g_free( key );
+	} else {
+		g_hash_table_add( seen, key );
 	}
 
 	return( found );
@@ -248,16 +383,67 @@ desktop_path_from_id( const FMADesktopProvider *provider, GList *files, const gc
 	return( list );
 }
 
+/*
+ * Parses the .desktop files into GKeyFile's
+ *
+ * GKeyFile parsing is CPU-bound and independent for each file, while
+ * not involving any GObject: when there are enough files, it is so run
+ * on a thread pool; the function returns when all files are loaded.
+ */
+static void
+load_desktop_paths( GList *paths )
+{
+	static const gchar *thisfn = "fma_desktop_reader_load_desktop_paths";
+	GThreadPool *pool;
+	GList *ip;
+	guint count, threads;
+
+	count = g_list_length( paths );
+	if( count < READ_PARALLEL_MIN_FILES ){
+		return;
+	}
+
+	threads = MIN( fma_core_utils_get_processors_count(), READ_MAX_THREADS );
+	g_debug( "%s: count=%u, threads=%u", thisfn, count, threads );
+
+	pool = g_thread_pool_new(( GFunc ) load_desktop_path, NULL, threads, FALSE, NULL );
+
+	for( ip = paths ; ip ; ip = ip->next ){
+		g_thread_pool_push( pool, ip->data, NULL );
+	}
+
+	/* wait for all the files be loaded */
+	g_thread_pool_free( pool, FALSE, TRUE );
+}
+
+/*
+ * run on a worker thread: each sDesktopPath is only accessed by one thread
+ */
+static void
+load_desktop_path( sDesktopPath *dps, gpointer user_data )
+{
+	dps->key_file = fma_desktop_file_load_key_file( dps->path );
+	dps->preloaded = TRUE;
+}
+
 /*
  * Returns a newly allocated FMAIFactoryObject-derived object, initialized
  * from the .desktop file pointed to by sDesktopPath struct
+ *
+ * If the file has already been parsed by load_desktop_paths(), the
+ * FMADesktopFile takes the ownership of the loaded key file.
  */
 static FMAIFactoryObject *
 item_from_desktop_path( const FMADesktopProvider *provider, sDesktopPath *dps, GSList **messages )
 {
 	FMADesktopFile *ndf;
 
-	ndf = fma_desktop_file_new_from_path( dps->path );
+	if( dps->preloaded ){
+		ndf = dps->key_file ? fma_desktop_file_new_from_key_file( dps->path, dps->key_file ) : NULL;
+		dps->key_file = NULL;
+	} else {
+		ndf = fma_desktop_file_new_from_path( dps->path );
+	}
 	if( !ndf ){
 		return( NULL );
 	}
@@ -335,6 +521,9 @@ free_desktop_paths( GList *paths )
 		dps = ( sDesktopPath * ) ip->data;
 		g_free( dps->path );
 		g_free( dps->id );
+		if( dps->key_file ){
+			g_key_file_free( dps->key_file );
+		}
 		g_free( dps );
 	}
 
@@ -37,6 +37,8 @@
 G_BEGIN_DECLS
 
 GList        *fma_desktop_reader_iio_provider_read_items     ( const FMAIIOProvider *provider, GSList **messages );
+FMAObjectItem *fma_desktop_reader_iio_provider_read_item     ( const FMAIIOProvider *provider, const gchar *id, GSList **messages );
+GSList       *fma_desktop_reader_iio_provider_get_sources   ( const FMAIIOProvider *provider );
 
 guint         fma_desktop_reader_iimporter_import_from_uri   ( const FMAIImporter *instance, void *parms_ptr );
 
@@ -32,9 +32,12 @@
 #endif
 
 #include <errno.h>
+#include <fcntl.h>
 #include <gio/gio.h>
 #include <glib/gstdio.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <api/fma-core-utils.h>
 
@@ -138,3 +141,136 @@ fma_desktop_utils_uri_is_writable( const gchar *uri )
 
 	return( writable );
 }
+
+/**
+ * fma_desktop_utils_path_write_temp:
+ * @path: the path of the file to be finally written.
+ * @data: the content of the file.
+ * @length: the length of @data.
+ *
+ * Writes @data to a new temporary file besides @path, and flushes it
+ * to the disk, so that it may then be atomically renamed to @path with
+ * fma_desktop_utils_path_commit().
+ *
+ * The temporary file is hidden and does not have the .desktop suffix,
+ * so that it is ignored by the monitors. It is given the mode of the
+ * existing @path, or the default mode of a new file, as the renamed file
+ * keeps it.
+ *
+ * Returns: the path of the temporary file as a newly allocated string
+ * which should be g_free() by the caller, or %NULL if an error occurred.
+ */
+gchar *
+fma_desktop_utils_path_write_temp( const gchar *path, const gchar *data, gsize length )
+{
+	static const gchar *thisfn = "fma_desktop_utils_path_write_temp";
+	gchar *dir, *bname, *temp;
+	gint fd;
+	gssize written;
+	gsize offset;
+	gboolean ok;
+	GStatBuf st;
+	mode_t mode, mask;
+
+	dir = g_path_get_dirname( path );
+	bname = g_path_get_basename( path );
+	temp = g_strdup_printf( "%s%s.%s.XXXXXX", dir, G_DIR_SEPARATOR_S, bname );
+	g_free( bname );
+	g_free( dir );
+
+	fd = g_mkstemp( temp );
+	if( fd == -1 ){
+		g_warning( "%s: %s: %s", thisfn, temp, g_strerror( errno ));
+		g_free( temp );
+		return( NULL );
+	}
+
+	if( g_stat( path, &st ) == 0 ){
+		mode = st.st_mode & 07777;
+	} else {
+		mask = umask( 0 );
+		umask( mask );
+		mode = 0666 & ~mask;
+	}
+
+	ok = TRUE;
+
+	if( fchmod( fd, mode ) == -1 ){
+		g_warning( "%s: %s: %s", thisfn, temp, g_strerror( errno ));
+		ok = FALSE;
+	}
+
+	offset = 0;
+	while( ok && offset < length ){
+		written = write( fd, data+offset, length-offset );
+		if( written >= 0 ){
+			offset += written;
+		} else if( errno != EINTR ){
+			g_warning( "%s: %s: %s", thisfn, temp, g_strerror( errno ));
+			ok = FALSE;
+		}
+	}
+
+	if( ok && fsync( fd ) == -1 ){
+		g_warning( "%s: %s: %s", thisfn, temp, g_strerror( errno ));
+		ok = FALSE;
+	}
+
+	if( close( fd ) == -1 && ok ){
+		g_warning( "%s: %s: %s", thisfn, temp, g_strerror( errno ));
+		ok = FALSE;
+	}
+
+	if( !ok ){
+		g_unlink( temp );
+		g_free( temp );
+		temp = NULL;
+	}
+
+	return( temp );
+}
+
+/**
+ * fma_desktop_utils_path_commit:
+ * @path: the path of the file to be written.
+ * @temp: the temporary file returned by fma_desktop_utils_path_write_temp().
+ *
+ * Atomically replaces @path with @temp. The temporary file is removed
+ * if it cannot be renamed.
+ *
+ * Returns: %TRUE if the file has been replaced, %FALSE else.
+ */
+gboolean
+fma_desktop_utils_path_commit( const gchar *path, const gchar *temp )
+{
+	static const gchar *thisfn = "fma_desktop_utils_path_commit";
+
+	if( g_rename( temp, path ) == -1 ){
+		g_warning( "%s: %s: %s", thisfn, path, g_strerror( errno ));
+		g_unlink( temp );
+		return( FALSE );
+	}
+
+	return( TRUE );
+}
+
+/**
+ * fma_desktop_utils_dir_sync:
+ * @dir: the path of a directory.
+ *
+ * Flushes the entries of the @dir directory to the disk, so that the
+ * files which have been renamed or deleted in it survive a crash.
+ *
+ * This is a best effort: errors are just ignored.
+ */
+void
+fma_desktop_utils_dir_sync( const gchar *dir )
+{
+	gint fd;
+
+	fd = g_open( dir, O_RDONLY, 0 );
+	if( fd != -1 ){
+		fsync( fd );
+		close( fd );
+	}
+}
@@ -39,6 +39,10 @@ GSList  *fma_desktop_utils_gslist_remove_from( GSList *list, const gchar *string
 gboolean fma_desktop_utils_uri_delete     ( const gchar *uri );
 gboolean fma_desktop_utils_uri_is_writable( const gchar *uri );
 
+gchar   *fma_desktop_utils_path_write_temp( const gchar *path, const gchar *data, gsize length );
+gboolean fma_desktop_utils_path_commit    ( const gchar *path, const gchar *temp );
+void     fma_desktop_utils_dir_sync       ( const gchar *dir );
+
 G_END_DECLS
 
 #endif /* __IO_DESKTOP_FMA_DESKTOP_UTILS_H__ */
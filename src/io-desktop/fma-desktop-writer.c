@@ -66,6 +66,7 @@ static ExportFormatFn st_export_format_fn[] = {
 static guint           write_item( const FMAIIOProvider *provider, const FMAObjectItem *item, FMADesktopFile *ndf, GSList **messages );
 
 static void            desktop_weak_notify( FMADesktopFile *ndf, GObject *item );
+static void            release_unwritten_item( FMAObjectItem *item );
 
 static void            write_start_write_type( FMADesktopFile *ndp, FMAObjectItem *item );
 static void            write_done_write_subitems_list( FMADesktopFile *ndp, FMAObjectItem *item );
@@ -239,7 +240,10 @@ write_item( const FMAIIOProvider *provider, const FMAObjectItem *item, FMADeskto
 
 	fma_ifactory_provider_write_item( FMA_IFACTORY_PROVIDER( provider ), ndf, FMA_IFACTORY_OBJECT( item ), messages );
 
-	if( !fma_desktop_file_write( ndf )){
+	fma_desktop_provider_begin_write( self );
+	fma_desktop_provider_stage_write( self, ndf );
+
+	if( !fma_desktop_provider_commit_write( self )){
 		ret = IIO_PROVIDER_CODE_WRITE_ERROR;
 	}
 
@@ -278,7 +282,9 @@ fma_desktop_writer_iio_provider_delete_item( const FMAIIOProvider *provider, con
 	if( ndf ){
 		g_return_val_if_fail( FMA_IS_DESKTOP_FILE( ndf ), ret );
 		uri = fma_desktop_file_get_key_file_uri( ndf );
-		if( fma_desktop_utils_uri_delete( uri )){
+		fma_desktop_provider_begin_write( self );
+		fma_desktop_provider_stage_delete( self, uri );
+		if( fma_desktop_provider_commit_write( self )){
 			ret = IIO_PROVIDER_CODE_OK;
 		}
 		g_free( uri );
@@ -291,6 +297,109 @@ fma_desktop_writer_iio_provider_delete_item( const FMAIIOProvider *provider, con
 	return( ret );
 }
 
+/*
+ * This is implementation of FMAIIOProvider::write_items method
+ *
+ * The whole batch is handled as a single write transaction: nothing is
+ * written if one item cannot be serialized, and the files are only
+ * deleted once all the others have been written (see
+ * fma_desktop_provider_commit_write()).
+ *
+ * When the batch fails, the new items whose file has not been written
+ * are detached from the FMADesktopFile allocated for them, so that they
+ * are still new when written again.
+ */
+guint
+fma_desktop_writer_iio_provider_write_items( const FMAIIOProvider *provider, const GList *items, const GList *deleted, GSList **messages )
+{
+	static const gchar *thisfn = "fma_desktop_writer_iio_provider_write_items";
+	guint ret;
+	FMADesktopProvider *self;
+	const GList *it;
+	GList *created;
+
+	g_debug( "%s: provider=%p (%s), items=%p (count=%d), deleted=%p (count=%d), messages=%p",
+			thisfn,
+			( void * ) provider, G_OBJECT_TYPE_NAME( provider ),
+			( void * ) items, g_list_length(( GList * ) items ),
+			( void * ) deleted, g_list_length(( GList * ) deleted ),
+			( void * ) messages );
+
+	ret = IIO_PROVIDER_CODE_PROGRAM_ERROR;
+
+	g_return_val_if_fail( FMA_IS_DESKTOP_PROVIDER( provider ), ret );
+
+	self = FMA_DESKTOP_PROVIDER( provider );
+
+	if( self->private->dispose_has_run ){
+		return( IIO_PROVIDER_CODE_NOT_WILLING_TO_RUN );
+	}
+
+	ret = IIO_PROVIDER_CODE_OK;
+	created = NULL;
+	fma_desktop_provider_begin_write( self );
+
+	for( it = deleted ; it && ret == IIO_PROVIDER_CODE_OK ; it = it->next ){
+		ret = fma_desktop_writer_iio_provider_delete_item( provider, FMA_OBJECT_ITEM( it->data ), messages );
+	}
+
+	for( it = items ; it && ret == IIO_PROVIDER_CODE_OK ; it = it->next ){
+		if( !fma_object_get_provider_data( it->data )){
+			created = g_list_prepend( created, it->data );
+		}
+		ret = fma_desktop_writer_iio_provider_write_item( provider, FMA_OBJECT_ITEM( it->data ), messages );
+	}
+
+	if( ret == IIO_PROVIDER_CODE_OK ){
+		if( !fma_desktop_provider_commit_write( self )){
+			ret = IIO_PROVIDER_CODE_WRITE_ERROR;
+		}
+
+	} else {
+		g_warning( "%s: unable to write the batch, ret=%d", thisfn, ret );
+		fma_desktop_provider_rollback_write( self );
+	}
+
+	if( ret != IIO_PROVIDER_CODE_OK ){
+		g_list_foreach( created, ( GFunc ) release_unwritten_item, NULL );
+	}
+
+	g_list_free( created );
+
+	return( ret );
+}
+
+/*
+ * a new item of a failed batch: if its file has not been written, drop
+ * the FMADesktopFile which has been allocated to it by write_item(),
+ * along with the content of its key file
+ */
+static void
+release_unwritten_item( FMAObjectItem *item )
+{
+	static const gchar *thisfn = "fma_desktop_writer_release_unwritten_item";
+	FMADesktopFile *ndf;
+	gchar *uri, *path;
+	gboolean written;
+
+	ndf = ( FMADesktopFile * ) fma_object_get_provider_data( item );
+
+	if( ndf ){
+		uri = fma_desktop_file_get_key_file_uri( ndf );
+		path = g_filename_from_uri( uri, NULL, NULL );
+		written = path && g_file_test( path, G_FILE_TEST_EXISTS );
+		g_free( path );
+		g_free( uri );
+
+		if( !written ){
+			g_debug( "%s: item=%p, ndf=%p", thisfn, ( void * ) item, ( void * ) ndf );
+			fma_object_set_provider_data( item, NULL );
+			g_object_weak_unref( G_OBJECT( item ), ( GWeakNotify ) desktop_weak_notify, ndf );
+			g_object_unref( ndf );
+		}
+	}
+}
+
 static void
 desktop_weak_notify( FMADesktopFile *ndf, GObject *item )
 {
@@ -404,6 +513,71 @@ fma_desktop_writer_iexporter_export_to_buffer( const FMAIExporter *instance, FMA
 	return( code );
 }
 
+/**
+ * fma_desktop_writer_iexporter_export_to_stream:
+ * @instance: this #FMAIExporter instance.
+ * @parms: a #FMAIExporterStreamParms structure.
+ *
+ * Export the specified 'item' to the output stream.
+ *
+ * #GKeyFile is not able to serialize itself to a stream: the content of
+ * the single exported item is built before being written.
+ */
+guint
+fma_desktop_writer_iexporter_export_to_stream( const FMAIExporter *instance, FMAIExporterStreamParms *parms )
+{
+	static const gchar *thisfn = "fma_desktop_writer_iexporter_export_to_stream";
+	guint code, write_code;
+	ExportFormatFn *fmt;
+	FMADesktopFile *ndf;
+	gchar *data, *msg;
+	gsize length;
+	GError *error;
+
+	g_debug( "%s: instance=%p, parms=%p", thisfn, ( void * ) instance, ( void * ) parms );
+
+	code = FMA_IEXPORTER_CODE_OK;
+
+	if( !parms->exported || !FMA_IS_OBJECT_ITEM( parms->exported )){
+		code = FMA_IEXPORTER_CODE_INVALID_ITEM;
+	}
+
+	if( code == FMA_IEXPORTER_CODE_OK ){
+		fmt = find_export_format_fn( parms->format );
+
+		if( !fmt ){
+			code = FMA_IEXPORTER_CODE_INVALID_FORMAT;
+
+		} else {
+			ndf = fma_desktop_file_new();
+			write_code = fma_ifactory_provider_write_item( FMA_IFACTORY_PROVIDER( instance ), ndf, FMA_IFACTORY_OBJECT( parms->exported ), &parms->messages );
+
+			if( write_code != IIO_PROVIDER_CODE_OK ){
+				code = FMA_IEXPORTER_CODE_ERROR;
+
+			} else {
+				data = fma_desktop_file_to_data( ndf, &length );
+				error = NULL;
+
+				if( !g_output_stream_write_all( parms->stream, data, length, NULL, NULL, &error )){
+					msg = g_strdup_printf( "%s: %s", thisfn, error->message );
+					g_warning( "%s", msg );
+					parms->messages = g_slist_append( parms->messages, msg );
+					g_error_free( error );
+					code = FMA_IEXPORTER_CODE_UNABLE_TO_WRITE;
+				}
+
+				g_free( data );
+			}
+
+			g_object_unref( ndf );
+		}
+	}
+
+	g_debug( "%s: returning code=%u", thisfn, code );
+	return( code );
+}
+
 /**
  * fma_desktop_writer_iexporter_export_to_file:
  * @instance: this #FMAIExporter instance.
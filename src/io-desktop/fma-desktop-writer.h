@@ -45,6 +45,10 @@ guint    fma_desktop_writer_iio_provider_write_item         ( const FMAIIOProvid
 guint    fma_desktop_writer_iio_provider_delete_item        ( const FMAIIOProvider *provider,
 																	const FMAObjectItem *item,
 																	GSList **messages );
+guint    fma_desktop_writer_iio_provider_write_items        ( const FMAIIOProvider *provider,
+																	const GList *items,
+																	const GList *deleted,
+																	GSList **messages );
 guint    fma_desktop_writer_iio_provider_duplicate_data     ( const FMAIIOProvider *provider,
 																	FMAObjectItem *dest,
 																	const FMAObjectItem *source,
@@ -54,6 +58,8 @@ guint    fma_desktop_writer_iexporter_export_to_buffer      ( const FMAIExporter
 																	FMAIExporterBufferParmsv2 *parms );
 guint    fma_desktop_writer_iexporter_export_to_file        ( const FMAIExporter *instance,
 																	FMAIExporterFileParmsv2 *parms );
+guint    fma_desktop_writer_iexporter_export_to_stream      ( const FMAIExporter *instance,
+																	FMAIExporterStreamParms *parms );
 
 guint    fma_desktop_writer_ifactory_provider_write_start   ( const FMAIFactoryProvider *provider,
 																	void *writer_data,
@@ -232,6 +232,7 @@ iexporter_iface_init( FMAIExporterInterface *iface )
 	iface->free_formats = iexporter_free_formats;
 	iface->to_file = fma_xml_writer_export_to_file;
 	iface->to_buffer = fma_xml_writer_export_to_buffer;
+	iface->to_stream = fma_xml_writer_export_to_stream;
 }
 
 static guint
@@ -34,6 +34,7 @@
 #include <gio/gio.h>
 #include <libintl.h>
 #include <libxml/tree.h>
+#include <libxml/xmlsave.h>
 #include <string.h>
 
 #include <api/fma-core-utils.h>
@@ -79,6 +80,14 @@ struct _FMAXMLWriterPrivate {
 	xmlNodePtr       locale_node;
 };
 
+/* the libxml2 output callbacks context, when writing to a GOutputStream
+ */
+typedef struct {
+	GOutputStream *stream;
+	GError        *error;
+}
+	sStreamContext;
+
 /* the association between an export format and the functions
  */
 struct ExportFormatFn {
@@ -122,8 +131,10 @@ static ExportFormatFn *find_export_format_fn_from_quark( GQuark format );
 #endif
 
 static gchar          *get_output_fname( const FMAObjectItem *item, const gchar *folder, const gchar *format );
-static void            output_xml_to_file( const gchar *xml, const gchar *filename, GSList **msg );
+static guint           output_xml_to_file( FMAXMLWriter *writer, const gchar *filename, GSList **msg );
 static guint           writer_to_buffer( FMAXMLWriter *writer );
+static guint           writer_to_stream( FMAXMLWriter *writer, GOutputStream *stream, GSList **msg );
+static int             on_stream_write( sStreamContext *context, const char *buffer, int len );
 
 static ExportFormatFn st_export_format_fn[] = {
 
@@ -320,6 +331,53 @@ fma_xml_writer_export_to_buffer( const FMAIExporter *instance, FMAIExporterBuffe
 	return( code );
 }
 
+/**
+ * fma_xml_writer_export_to_stream:
+ * @instance: this #FMAIExporter instance.
+ * @parms: a #FMAIExporterStreamParms structure.
+ *
+ * Export the specified 'item' to the output stream, without building
+ * the whole document as a string.
+ */
+guint
+fma_xml_writer_export_to_stream( const FMAIExporter *instance, FMAIExporterStreamParms *parms )
+{
+	static const gchar *thisfn = "fma_xml_writer_export_to_stream";
+	FMAXMLWriter *writer;
+	guint code;
+
+	g_debug( "%s: instance=%p, parms=%p", thisfn, ( void * ) instance, ( void * ) parms );
+
+	code = FMA_IEXPORTER_CODE_OK;
+
+	if( !parms->exported || !FMA_IS_OBJECT_ITEM( parms->exported )){
+		code = FMA_IEXPORTER_CODE_INVALID_ITEM;
+	}
+
+	if( code == FMA_IEXPORTER_CODE_OK ){
+		writer = FMA_XML_WRITER( g_object_new( FMA_XML_WRITER_TYPE, NULL ));
+
+		writer->private->provider = ( FMAIExporter * ) instance;
+		writer->private->exported = parms->exported;
+		writer->private->messages = parms->messages;
+		writer->private->fn_str = find_export_format_fn( parms->format );
+		writer->private->buffer = NULL;
+
+		if( !writer->private->fn_str ){
+			code = FMA_IEXPORTER_CODE_INVALID_FORMAT;
+
+		} else {
+			code = writer_to_stream( writer, parms->stream, &writer->private->messages );
+		}
+
+		parms->messages = writer->private->messages;
+		g_object_unref( writer );
+	}
+
+	g_debug( "%s: returning code=%u", thisfn, code );
+	return( code );
+}
+
 /**
  * fma_xml_writer_export_to_file:
  * @instance: this #FMAIExporter instance.
@@ -368,20 +426,14 @@ fma_xml_writer_export_to_file( const FMAIExporter *instance, FMAIExporterFilePar
 			code = FMA_IEXPORTER_CODE_INVALID_FORMAT;
 
 		} else {
-			code = writer_to_buffer( writer );
+			filename = get_output_fname( parms->exported, parms->folder, format2 );
 
-			if( code == FMA_IEXPORTER_CODE_OK ){
-				filename = get_output_fname( parms->exported, parms->folder, format2 );
-
-				if( filename ){
-					parms->basename = g_path_get_basename( filename );
-					output_xml_to_file(
-							writer->private->buffer, filename, parms->messages ? &writer->private->messages : NULL );
-					g_free( filename );
-				}
+			if( filename ){
+				parms->basename = g_path_get_basename( filename );
+				code = output_xml_to_file(
+						writer, filename, parms->messages ? &writer->private->messages : NULL );
+				g_free( filename );
 			}
-
-			g_free( writer->private->buffer );
 		}
 
 		g_object_unref( writer );
@@ -878,23 +930,24 @@ get_output_fname( const FMAObjectItem *item, const gchar *folder, const gchar *f
 
 /*
  * output_xml_to_file:
- * @xml: the xml buffer.
+ * @writer: this #FMAXMLWriter instance.
  * @filename: the full path of the output filename as an URI.
  * @msg: a GSList to append messages.
  *
- * Exports an item to the given filename.
+ * Exports an item to the given filename, the document being written
+ * to the file as it is serialized.
  */
-static void
-output_xml_to_file( const gchar *xml, const gchar *filename, GSList **msg )
+static guint
+output_xml_to_file( FMAXMLWriter *writer, const gchar *filename, GSList **msg )
 {
 	static const gchar *thisfn = "fma_xml_writer_output_xml_to_file";
 	GFile *file;
 	GFileOutputStream *stream;
 	GError *error = NULL;
 	gchar *errmsg;
+	guint code;
 
-	g_return_if_fail( xml );
-	g_return_if_fail( filename && g_utf8_strlen( filename, -1 ));
+	g_return_val_if_fail( filename && g_utf8_strlen( filename, -1 ), FMA_IEXPORTER_CODE_INVALID_TARGET );
 
 	g_debug( "%s: filename=%s", thisfn, filename );
 
@@ -906,27 +959,18 @@ output_xml_to_file( const gchar *xml, const gchar *filename, GSList **msg )
 		g_warning( "%s", errmsg );
 		if( msg ){
 			*msg = g_slist_append( *msg, errmsg );
+		} else {
+			g_free( errmsg );
 		}
 		g_error_free( error );
 		if( stream ){
 			g_object_unref( stream );
 		}
 		g_object_unref( file );
-		return;
+		return( FMA_IEXPORTER_CODE_UNABLE_TO_WRITE );
 	}
 
-	g_output_stream_write( G_OUTPUT_STREAM( stream ), xml, g_utf8_strlen( xml, -1 ), NULL, &error );
-	if( error ){
-		errmsg = g_strdup_printf( "%s: g_output_stream_write: %s", thisfn, error->message );
-		g_warning( "%s", errmsg );
-		if( msg ){
-			*msg = g_slist_append( *msg, errmsg );
-		}
-		g_error_free( error );
-		g_object_unref( stream );
-		g_object_unref( file );
-		return;
-	}
+	code = writer_to_stream( writer, G_OUTPUT_STREAM( stream ), msg );
 
 	g_output_stream_close( G_OUTPUT_STREAM( stream ), NULL, &error );
 	if( error ){
@@ -934,15 +978,17 @@ output_xml_to_file( const gchar *xml, const gchar *filename, GSList **msg )
 		g_warning( "%s", errmsg );
 		if( msg ){
 			*msg = g_slist_append( *msg, errmsg );
+		} else {
+			g_free( errmsg );
 		}
 		g_error_free( error );
-		g_object_unref( stream );
-		g_object_unref( file );
-		return;
+		code = FMA_IEXPORTER_CODE_UNABLE_TO_WRITE;
 	}
 
 	g_object_unref( stream );
 	g_object_unref( file );
+
+	return( code );
 }
 
 static guint
@@ -965,3 +1011,59 @@ writer_to_buffer( FMAXMLWriter *writer )
 
 	return( code );
 }
+
+/*
+ * serialize the document to the stream through the libxml2 output
+ * buffers, so that the text is never held as a whole in memory
+ */
+static guint
+writer_to_stream( FMAXMLWriter *writer, GOutputStream *stream, GSList **msg )
+{
+	static const gchar *thisfn = "fma_xml_writer_writer_to_stream";
+	guint code;
+	xmlDocPtr doc;
+	xmlSaveCtxtPtr save;
+	sStreamContext context;
+	gchar *errmsg;
+
+	code = FMA_IEXPORTER_CODE_OK;
+	doc = build_xml_doc( writer );
+
+	context.stream = stream;
+	context.error = NULL;
+
+	save = xmlSaveToIO(( xmlOutputWriteCallback ) on_stream_write, NULL, &context, "UTF-8", XML_SAVE_FORMAT );
+	if( save ){
+		xmlSaveDoc( save, doc );
+		xmlSaveClose( save );
+	}
+
+	if( !save || context.error ){
+		errmsg = g_strdup_printf( "%s: %s", thisfn, context.error ? context.error->message : "xmlSaveToIO" );
+		g_warning( "%s", errmsg );
+		if( msg ){
+			*msg = g_slist_append( *msg, errmsg );
+		} else {
+			g_free( errmsg );
+		}
+		if( context.error ){
+			g_error_free( context.error );
+		}
+		code = FMA_IEXPORTER_CODE_UNABLE_TO_WRITE;
+	}
+
+	xmlFreeDoc (doc);
+	xmlCleanupParser();
+
+	return( code );
+}
+
+static int
+on_stream_write( sStreamContext *context, const char *buffer, int len )
+{
+	if( !context->error ){
+		g_output_stream_write_all( context->stream, buffer, len, NULL, NULL, &context->error );
+	}
+
+	return( context->error ? -1 : len );
+}
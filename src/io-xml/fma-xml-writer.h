@@ -73,6 +73,7 @@ GType  fma_xml_writer_get_type        ( void );
 
 guint  fma_xml_writer_export_to_buffer( const FMAIExporter *instance, FMAIExporterBufferParmsv2 *parms );
 guint  fma_xml_writer_export_to_file  ( const FMAIExporter *instance, FMAIExporterFileParmsv2 *parms );
+guint  fma_xml_writer_export_to_stream( const FMAIExporter *instance, FMAIExporterStreamParms *parms );
 
 guint  fma_xml_writer_write_start     ( const FMAIFactoryProvider *writer, void *writer_data, const FMAIFactoryObject *object, GSList **messages  );
 guint  fma_xml_writer_write_data      ( const FMAIFactoryProvider *writer, void *writer_data, const FMAIFactoryObject *object, const FMADataBoxed *boxed, GSList **messages );
@@ -42,6 +42,7 @@
 #include <core/fma-pivot.h>
 #include <core/fma-about.h>
 #include <core/fma-selected-info.h>
+#include <core/fma-show-if.h>
 #include <core/fma-tokens.h>
 
 #include "fma-menu-plugin.h"
@@ -60,12 +61,42 @@ struct _FMAMenuPluginPrivate {
 	gulong     items_changed_handler;
 	gulong     settings_changed_handler;
 	FMATimeout change_timeout;
+	FMATimeout updated_timeout;
+	gboolean   full_reload;
 };
 
 static GObjectClass *st_parent_class  = NULL;
 static GType         st_actions_type  = 0;
 static gint          st_burst_timeout = 100;		/* burst timeout in msec */
 
+/* the data which may embed parameters, and have so to be expanded
+ * against the current selection when building the menu
+ * the mask of the data which actually embed parameters is attached to
+ * each object of the tree, with a bit per data of this table
+ */
+typedef struct {
+	const gchar *name;
+	GType      ( *type )( void );
+	gboolean     utf8;
+}
+	TokensData;
+
+static const TokensData st_tokens_data[] = {
+	{ FMAFO_DATA_LABEL,              fma_object_item_get_type,   TRUE },
+	{ FMAFO_DATA_TOOLTIP,            fma_object_item_get_type,   TRUE },
+	{ FMAFO_DATA_ICON,               fma_object_item_get_type,   TRUE },
+	{ FMAFO_DATA_TOOLBAR_LABEL,      fma_object_action_get_type, TRUE },
+	{ FMAFO_DATA_TRY_EXEC,           fma_icontext_get_type,      FALSE },
+	{ FMAFO_DATA_SHOW_IF_REGISTERED, fma_icontext_get_type,      FALSE },
+	{ FMAFO_DATA_SHOW_IF_TRUE,       fma_icontext_get_type,      FALSE },
+	{ FMAFO_DATA_SHOW_IF_RUNNING,    fma_icontext_get_type,      FALSE },
+	{ NULL }
+};
+
+#define TOKENS_MASK_DATA                "fma-menu-plugin-tokens-mask"
+#define TOKENS_MASK_ITEMS_SLIST         ( 1U << 30 )
+#define TOKENS_MASK_COMPUTED            ( 1U << 31 )
+
 static void                 class_init( FMAMenuPluginClass *klass );
 static void                 instance_init( GTypeInstance *instance, gpointer klass );
 static void                 instance_constructed( GObject *object );
@@ -78,11 +109,10 @@ static GList               *menu_provider_get_file_items( FileManagerMenuProvide
 	defined( HAVE_NEMO_MENU_PROVIDER_GET_TOOLBAR_ITEMS )
 static GList               *menu_provider_get_toolbar_items( FileManagerMenuProvider *provider, GtkWidget *window, FileManagerFileInfo *current_folder );
 #endif
-static GList               *selected_info_get_list_from_item( FileManagerFileInfo *item );
-static GList               *selected_info_get_list_from_list( GList *selection );
-static FMASelectedInfo     *new_from_file_manager_file_info( FileManagerFileInfo *item );
+static GList               *selected_info_get_list_from_item( FMAMenuPlugin *plugin, FileManagerFileInfo *item );
+static GList               *selected_info_get_list_from_list( FMAMenuPlugin *plugin, GList *selection );
 static GList               *build_filemanager_menu( FMAMenuPlugin *plugin, guint target, GList *selection );
-static GList               *build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMATokens *tokens );
+static GList               *build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMATokens *tokens, GHashTable *candidates );
 static void                 attach_submenu_to_item( FileManagerMenuItem *item, GList *subitems );
 static void                 weak_notify_profile( FMAObjectProfile *profile, FileManagerMenuItem *item );
 static void                 execute_action( FileManagerMenuItem *item, FMAObjectProfile *profile );
@@ -91,14 +121,20 @@ static FileManagerMenuItem *create_item_from_profile( FMAObjectProfile *profile,
 static FileManagerMenuItem *create_item_from_menu( FMAObjectMenu *menu, GList *subitems, guint target );
 static FileManagerMenuItem *create_menu_item( const FMAObjectItem *item, guint target );
 static FMAObjectItem       *expand_tokens_item( const FMAObjectItem *item, FMATokens *tokens );
-static void                 expand_tokens_context( FMAIContext *context, FMATokens *tokens );
-static FMAObjectProfile    *get_candidate_profile( FMAObjectAction *action, guint target, GList *files );
+static void                 expand_tokens_object( FMAObject *object, FMATokens *tokens, guint mask );
+static gboolean             item_has_tokens( const FMAObjectItem *item );
+static guint                get_tokens_mask( FMAObject *object );
+static void                 set_tokens_mask_rec( GList *tree );
+static gboolean             is_dynamic_subitem( const gchar *subitem );
+static FMAObjectProfile    *get_candidate_profile( FMAObjectAction *action, guint target, GList *files, GHashTable *candidates );
 static GList               *create_root_menu( FMAMenuPlugin *plugin, GList *filemanager_menu );
 static void                 weak_notify_menu_item( void *user_data /* =NULL */, FileManagerMenuItem *item );
 static GList               *add_about_item( FMAMenuPlugin *plugin, GList *filemanager_menu );
 static void                 on_pivot_items_changed_handler( FMAPivot *pivot, FMAMenuPlugin *plugin );
 static void                 on_settings_key_changed_handler( const gchar *group, const gchar *key, gconstpointer new_value, gboolean mandatory, FMAMenuPlugin *plugin );
 static void                 on_change_event_timeout( FMAMenuPlugin *plugin );
+static void                 on_show_if_changed( FMAMenuPlugin *plugin );
+static void                 on_updated_event_timeout( FMAMenuPlugin *plugin );
 
 GType
 fma_menu_plugin_get_type( void )
@@ -179,6 +215,11 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private->change_timeout.handler = ( FMATimeoutFunc ) on_change_event_timeout;
 	self->private->change_timeout.user_data = self;
 	self->private->change_timeout.source_id = 0;
+	self->private->updated_timeout.timeout = st_burst_timeout;
+	self->private->updated_timeout.handler = ( FMATimeoutFunc ) on_updated_event_timeout;
+	self->private->updated_timeout.user_data = self;
+	self->private->updated_timeout.source_id = 0;
+	self->private->full_reload = FALSE;
 }
 
 /*
@@ -191,6 +232,9 @@ instance_init( GTypeInstance *instance, gpointer klass )
  * - whether to add the 'About FileManager-Actions' item
  * - whether to create a 'FileManager-Actions actions' root menu
  *   > registering for notifications against FMASettings
+ *
+ * - whether a late ShowIfTrue result changes the outcome of a condition
+ *   > registering for notifications against FMAShowIf
  */
 static void
 instance_constructed( GObject *object )
@@ -216,7 +260,9 @@ instance_constructed( GObject *object )
 		/* setup FMAPivot properties before loading items
 		 */
 		fma_pivot_set_loadable( priv->pivot, !PIVOT_LOAD_DISABLED & !PIVOT_LOAD_INVALID );
+		fma_pivot_set_cacheable( priv->pivot, TRUE );
 		fma_pivot_load_items( priv->pivot );
+		set_tokens_mask_rec( fma_pivot_get_items( priv->pivot ));
 
 		/* register against FMAPivot to be notified of items changes
 		 */
@@ -255,6 +301,11 @@ instance_constructed( GObject *object )
 				IPREFS_ITEMS_LIST_ORDER_MODE,
 				G_CALLBACK( on_settings_key_changed_handler ),
 				object );
+
+		/* the file manager main loop is running: do not block it
+		 * while evaluating ShowIfTrue commands
+		 */
+		fma_show_if_set_async(( FMAShowIfNotifyFunc ) on_show_if_changed, object );
 	}
 }
 
@@ -272,6 +323,16 @@ instance_dispose( GObject *object )
 
 		self->private->dispose_has_run = TRUE;
 
+		fma_show_if_set_async( NULL, NULL );
+		fma_show_if_cancel();
+
+		if( self->private->change_timeout.source_id ){
+			g_source_remove( self->private->change_timeout.source_id );
+		}
+		if( self->private->updated_timeout.source_id ){
+			g_source_remove( self->private->updated_timeout.source_id );
+		}
+
 		if( self->private->items_changed_handler ){
 			g_signal_handler_disconnect( self->private->pivot, self->private->items_changed_handler );
 		}
@@ -348,7 +409,7 @@ menu_provider_get_background_items(
 
 	if( !FMA_MENU_PLUGIN( provider )->private->dispose_has_run ){
 
-		selected = selected_info_get_list_from_item( current_folder );
+		selected = selected_info_get_list_from_item( FMA_MENU_PLUGIN( provider ), current_folder );
 
 		if( selected ){
 			uri = file_manager_file_info_get_uri( current_folder );
@@ -393,7 +454,7 @@ menu_provider_get_file_items( FileManagerMenuProvider *provider, GtkWidget *wind
 			return(( GList * ) NULL );
 		}
 
-		selected = selected_info_get_list_from_list(( GList * ) files );
+		selected = selected_info_get_list_from_list( FMA_MENU_PLUGIN( provider ), ( GList * ) files );
 
 		if( selected ){
 			g_debug( "%s: provider=%p, window=%p, files=%p, count=%d",
@@ -447,7 +508,7 @@ menu_provider_get_toolbar_items( FileManagerMenuProvider *provider, GtkWidget *w
 
 	if( !FMA_MENU_PLUGIN( provider )->private->dispose_has_run ){
 
-		selected = selected_info_get_list_from_item( current_folder );
+		selected = selected_info_get_list_from_item( FMA_MENU_PLUGIN( provider ), current_folder );
 
 		if( selected ){
 			uri = file_manager_file_info_get_uri( current_folder );
@@ -479,16 +540,14 @@ menu_provider_get_toolbar_items( FileManagerMenuProvider *provider, GtkWidget *w
  * same URI that the @item.
  */
 static GList *
-selected_info_get_list_from_item( FileManagerFileInfo *item )
+selected_info_get_list_from_item( FMAMenuPlugin *plugin, FileManagerFileInfo *item )
 {
 	GList *selected;
+	GList *selection;
 
-	selected = NULL;
-	FMASelectedInfo *info = new_from_file_manager_file_info( item );
-
-	if( info ){
-		selected = g_list_prepend( NULL, info );
-	}
+	selection = g_list_prepend( NULL, item );
+	selected = selected_info_get_list_from_list( plugin, selection );
+	g_list_free( selection );
 
 	return( selected );
 }
@@ -499,36 +558,36 @@ selected_info_get_list_from_item( FileManagerFileInfo *item )
  *
  * Returns: a #GList list of #FMASelectedInfo items whose URI correspond
  * to those of @nautilus_selection.
+ *
+ * Only the file attributes which are needed by the conditions of the
+ * loaded items are queried here; the other ones will be queried if
+ * needed when expanding the parameters.
  */
 static GList *
-selected_info_get_list_from_list( GList *selection )
+selected_info_get_list_from_list( FMAMenuPlugin *plugin, GList *selection )
 {
 	GList *selected;
+	GList *uris, *mimetypes;
 	GList *it;
 
-	selected = NULL;
+	uris = NULL;
+	mimetypes = NULL;
 
 	for( it = selection ; it ; it = it->next ){
-		FMASelectedInfo *info = new_from_file_manager_file_info( FILE_MANAGER_FILE_INFO( it->data ));
-
-		if( info ){
-			selected = g_list_prepend( selected, info );
-		}
+		uris = g_list_prepend( uris, file_manager_file_info_get_uri( FILE_MANAGER_FILE_INFO( it->data )));
+		mimetypes = g_list_prepend( mimetypes, file_manager_file_info_get_mime_type( FILE_MANAGER_FILE_INFO( it->data )));
 	}
 
-	return( selected ? g_list_reverse( selected ) : NULL );
-}
+	uris = g_list_reverse( uris );
+	mimetypes = g_list_reverse( mimetypes );
 
-static FMASelectedInfo *
-new_from_file_manager_file_info( FileManagerFileInfo *item )
-{
-	gchar *uri = file_manager_file_info_get_uri( item );
-	gchar *mimetype = file_manager_file_info_get_mime_type( item );
-	FMASelectedInfo *info = fma_selected_info_create_for_uri( uri, mimetype, NULL );
-	g_free( mimetype );
-	g_free( uri );
+	selected = fma_selected_info_create_for_uris(
+			uris, mimetypes, fma_pivot_get_selection_attributes( plugin->private->pivot ), NULL );
+
+	g_list_free_full( mimetypes, ( GDestroyNotify ) g_free );
+	g_list_free_full( uris, ( GDestroyNotify ) g_free );
 
-	return( info );
+	return( selected );
 }
 
 /*
@@ -552,6 +611,7 @@ build_filemanager_menu( FMAMenuPlugin *plugin, guint target, GList *selection )
 	GList *filemanager_menu;
 	FMATokens *tokens;
 	GList *tree;
+	GHashTable *candidates;
 	gboolean items_add_about_item;
 	gboolean items_create_root_menu;
 
@@ -562,7 +622,16 @@ build_filemanager_menu( FMAMenuPlugin *plugin, guint target, GList *selection )
 	tree = fma_pivot_get_items( plugin->private->pivot );
 	g_debug( "%s: tree=%p, count=%d", thisfn, ( void * ) tree, g_list_length( tree ));
 
-	filemanager_menu = build_filemanager_menu_rec( tree, target, selection, tokens );
+	/* only the items which are found in the candidate index have to be
+	 * fully examined
+	 */
+	candidates = fma_pivot_get_candidates( plugin->private->pivot, target, selection );
+
+	filemanager_menu = build_filemanager_menu_rec( tree, target, selection, tokens, candidates );
+
+	if( candidates ){
+		g_hash_table_destroy( candidates );
+	}
 
 	/* the FMATokens object has been attached (and reffed) by each found
 	 * candidate profile, so it will be actually finalized only on actual
@@ -587,7 +656,7 @@ build_filemanager_menu( FMAMenuPlugin *plugin, guint target, GList *selection )
 }
 
 static GList *
-build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMATokens *tokens )
+build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMATokens *tokens, GHashTable *candidates )
 {
 	static const gchar *thisfn = "fma_menu_plugin_build_filemanager_menu_rec";
 	GList *filemanager_menu;
@@ -604,6 +673,11 @@ build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMAToke
 	for( it=tree ; it ; it=it->next ){
 
 		g_return_val_if_fail( FMA_IS_OBJECT_ITEM( it->data ), NULL );
+
+		if( candidates && !g_hash_table_contains( candidates, it->data )){
+			continue;
+		}
+
 		label = fma_object_get_label( it->data );
 		g_debug( "%s: examining %s", thisfn, label );
 
@@ -634,7 +708,7 @@ build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMAToke
 			subitems = fma_object_get_items( FMA_OBJECT( it->data ));
 			g_debug( "%s: menu has %d items", thisfn, g_list_length( subitems ));
 
-			submenu = build_filemanager_menu_rec( subitems, target, selection, tokens );
+			submenu = build_filemanager_menu_rec( subitems, target, selection, tokens, candidates );
 			g_debug( "%s: submenu has %d items", thisfn, g_list_length( submenu ));
 
 			if( submenu ){
@@ -655,7 +729,7 @@ build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMAToke
 
 		/* if we have an action, searches for a candidate profile
 		 */
-		profile = get_candidate_profile( FMA_OBJECT_ACTION( item ), target, selection );
+		profile = get_candidate_profile( FMA_OBJECT_ACTION( item ), target, selection, candidates );
 		if( profile ){
 			menu_item = create_item_from_profile( profile, target, selection, tokens );
 			filemanager_menu = g_list_append( filemanager_menu, menu_item );
@@ -683,131 +757,186 @@ build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMAToke
  * - the menu (itself)
  * - the action and its profiles
  *
- * Returns: a duplicated object which has to be g_object_unref() by the caller.
+ * Items which do not embed any parameter are returned as is, without
+ * being duplicated. Else, only the data which actually embed parameters
+ * are expanded.
+ *
+ * Returns: a new reference on either the @item itself or a duplicated
+ * object, which has to be g_object_unref() by the caller.
  */
 static FMAObjectItem *
 expand_tokens_item( const FMAObjectItem *src, FMATokens *tokens )
 {
-	gchar *old, *new;
-	GSList *subitems_slist, *its, *new_slist;
-	GList *subitems, *it;
 	FMAObjectItem *item;
+	GList *subitems, *it;
+	FMAObject *origin;
+
+	if( !item_has_tokens( src )){
+		return( FMA_OBJECT_ITEM( g_object_ref(( gpointer ) src )));
+	}
 
 	item = FMA_OBJECT_ITEM( fma_object_duplicate( src, FMA_DUPLICATE_OBJECT ));
 
-	/* label, tooltip and icon name
-	 * plus the toolbar label if this is an action
+	/* label, tooltip and icon name, plus the toolbar label if this is
+	 * an action; a FMAObjectItem, whether it is an action or a menu, is
+	 * also a FMAIContext
 	 */
-	old = fma_object_get_label( item );
-	new = fma_tokens_parse_for_display( tokens, old, TRUE );
-	fma_object_set_label( item, new );
-	g_free( old );
-	g_free( new );
-
-	old = fma_object_get_tooltip( item );
-	new = fma_tokens_parse_for_display( tokens, old, TRUE );
-	fma_object_set_tooltip( item, new );
-	g_free( old );
-	g_free( new );
-
-	old = fma_object_get_icon( item );
-	new = fma_tokens_parse_for_display( tokens, old, TRUE );
-	fma_object_set_icon( item, new );
-	g_free( old );
-	g_free( new );
+	expand_tokens_object( FMA_OBJECT( item ), tokens, get_tokens_mask( FMA_OBJECT( src )));
 
+	/* last, deal with profiles of an action
+	 * desktop Exec key = GConf path+parameters, and the working directory
+	 * are parsed at execution time: do not touch them here
+	 */
 	if( FMA_IS_OBJECT_ACTION( item )){
-		old = fma_object_get_toolbar_label( item );
-		new = fma_tokens_parse_for_display( tokens, old, TRUE );
-		fma_object_set_toolbar_label( item, new );
-		g_free( old );
-		g_free( new );
+
+		subitems = fma_object_get_items( item );
+
+		for( it = subitems ; it ; it = it->next ){
+			origin = ( FMAObject * ) fma_object_get_origin( it->data );
+			expand_tokens_object( FMA_OBJECT( it->data ), tokens, get_tokens_mask( origin ? origin : FMA_OBJECT( it->data )));
+		}
 	}
 
-	/* A FMAObjectItem, whether it is an action or a menu, is also a FMAIContext
-	 */
-	expand_tokens_context( FMA_ICONTEXT( item ), tokens );
+	return( item );
+}
+
+static void
+expand_tokens_object( FMAObject *object, FMATokens *tokens, guint mask )
+{
+	gchar *old, *new;
+	GSList *subitems_slist, *its, *new_slist;
+	guint i;
+
+	for( i = 0 ; st_tokens_data[i].name ; ++i ){
+		if( mask & ( 1 << i )){
+			old = ( gchar * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( object ), st_tokens_data[i].name );
+			new = fma_tokens_parse_for_display( tokens, old, st_tokens_data[i].utf8 );
+			fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( object ), st_tokens_data[i].name, new );
+			g_free( old );
+			g_free( new );
+		}
+	}
 
 	/* subitems lists, whether this is the profiles list of an action
 	 * or the items list of a menu, may be dynamic and embed a command;
 	 * this command itself may embed parameters
 	 */
-	subitems_slist = fma_object_get_items_slist( item );
-	new_slist = NULL;
-	for( its = subitems_slist ; its ; its = its->next ){
-		old = ( gchar * ) its->data;
-		if( old[0] == '[' && old[strlen(old)-1] == ']' ){
-			new = fma_tokens_parse_for_display( tokens, old, FALSE );
-		} else {
-			new = g_strdup( old );
+	if( mask & TOKENS_MASK_ITEMS_SLIST ){
+		subitems_slist = fma_object_get_items_slist( object );
+		new_slist = NULL;
+		for( its = subitems_slist ; its ; its = its->next ){
+			old = ( gchar * ) its->data;
+			if( is_dynamic_subitem( old )){
+				new = fma_tokens_parse_for_display( tokens, old, FALSE );
+			} else {
+				new = g_strdup( old );
+			}
+			new_slist = g_slist_prepend( new_slist, new );
 		}
-		new_slist = g_slist_prepend( new_slist, new );
+		fma_object_set_items_slist( object, new_slist );
+		fma_core_utils_slist_free( subitems_slist );
+		fma_core_utils_slist_free( new_slist );
 	}
-	fma_object_set_items_slist( item, new_slist );
-	fma_core_utils_slist_free( subitems_slist );
-	fma_core_utils_slist_free( new_slist );
+}
 
-	/* last, deal with profiles of an action
-	 */
-	if( FMA_IS_OBJECT_ACTION( item )){
+/*
+ * whether the item, or one of its profiles if an action, embeds parameters
+ */
+static gboolean
+item_has_tokens( const FMAObjectItem *item )
+{
+	gboolean has_tokens;
+	GList *it;
 
-		subitems = fma_object_get_items( item );
+	has_tokens = ( get_tokens_mask( FMA_OBJECT( item )) != 0 );
 
-		for( it = subitems ; it ; it = it->next ){
+	if( !has_tokens && FMA_IS_OBJECT_ACTION( item )){
+		for( it = fma_object_get_items( item ) ; it && !has_tokens ; it = it->next ){
+			has_tokens = ( get_tokens_mask( FMA_OBJECT( it->data )) != 0 );
+		}
+	}
 
-			/* desktop Exec key = GConf path+parameters
-			 * do not touch them here
-			 */
-			old = fma_object_get_working_dir( it->data );
-			new = fma_tokens_parse_for_display( tokens, old, FALSE );
-			fma_object_set_working_dir( it->data, new );
-			g_free( old );
-			g_free( new );
+	return( has_tokens );
+}
+
+/*
+ * returns the mask of the data which embed parameters for this object
+ *
+ * the mask is computed once, and then attached to the object; as the
+ * items are rebuilt each time they are reloaded, it never has to be
+ * reset
+ */
+static guint
+get_tokens_mask( FMAObject *object )
+{
+	guint mask;
+	guint i;
+	gchar *value;
+	GSList *subitems_slist, *its;
+
+	mask = GPOINTER_TO_UINT( g_object_get_data( G_OBJECT( object ), TOKENS_MASK_DATA ));
+
+	if( !mask ){
+		mask = TOKENS_MASK_COMPUTED;
 
-			/* a FMAObjectProfile is also a FMAIContext
-			 */
-			expand_tokens_context( FMA_ICONTEXT( it->data ), tokens );
+		for( i = 0 ; st_tokens_data[i].name ; ++i ){
+			if( g_type_is_a( G_OBJECT_TYPE( object ), st_tokens_data[i].type() )){
+				value = ( gchar * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( object ), st_tokens_data[i].name );
+				if( value && strchr( value, '%' )){
+					mask |= ( 1 << i );
+				}
+				g_free( value );
+			}
+		}
+
+		if( FMA_IS_OBJECT_ITEM( object )){
+			subitems_slist = fma_object_get_items_slist( object );
+			for( its = subitems_slist ; its ; its = its->next ){
+				if( is_dynamic_subitem(( const gchar * ) its->data )){
+					mask |= TOKENS_MASK_ITEMS_SLIST;
+				}
+			}
+			fma_core_utils_slist_free( subitems_slist );
 		}
+
+		g_object_set_data( G_OBJECT( object ), TOKENS_MASK_DATA, GUINT_TO_POINTER( mask ));
 	}
 
-	return( item );
+	return( mask & ~TOKENS_MASK_COMPUTED );
 }
 
+/*
+ * computes the tokens mask of each object of the tree at load time,
+ * so that building the menu does not have to
+ */
 static void
-expand_tokens_context( FMAIContext *context, FMATokens *tokens )
+set_tokens_mask_rec( GList *tree )
 {
-	gchar *old, *new;
+	GList *it;
+
+	for( it = tree ; it ; it = it->next ){
+		get_tokens_mask( FMA_OBJECT( it->data ));
+
+		if( FMA_IS_OBJECT_ITEM( it->data )){
+			set_tokens_mask_rec( fma_object_get_items( it->data ));
+		}
+	}
+}
 
-	old = fma_object_get_try_exec( context );
-	new = fma_tokens_parse_for_display( tokens, old, FALSE );
-	fma_object_set_try_exec( context, new );
-	g_free( old );
-	g_free( new );
-
-	old = fma_object_get_show_if_registered( context );
-	new = fma_tokens_parse_for_display( tokens, old, FALSE );
-	fma_object_set_show_if_registered( context, new );
-	g_free( old );
-	g_free( new );
-
-	old = fma_object_get_show_if_true( context );
-	new = fma_tokens_parse_for_display( tokens, old, FALSE );
-	fma_object_set_show_if_true( context, new );
-	g_free( old );
-	g_free( new );
-
-	old = fma_object_get_show_if_running( context );
-	new = fma_tokens_parse_for_display( tokens, old, FALSE );
-	fma_object_set_show_if_running( context, new );
-	g_free( old );
-	g_free( new );
+static gboolean
+is_dynamic_subitem( const gchar *subitem )
+{
+	return( subitem && subitem[0] == '[' && subitem[strlen( subitem )-1] == ']' );
 }
 
 /*
  * could also be a FMAObjectAction method - but this is not used elsewhere
+ *
+ * the action is a duplicate of the pivot one, so are its profiles: the
+ * candidate index has been built on the origin profiles
  */
 static FMAObjectProfile *
-get_candidate_profile( FMAObjectAction *action, guint target, GList *files )
+get_candidate_profile( FMAObjectAction *action, guint target, GList *files, GHashTable *candidates )
 {
 	static const gchar *thisfn = "fma_menu_plugin_get_candidate_profile";
 	FMAObjectProfile *candidate = NULL;
@@ -820,6 +949,11 @@ get_candidate_profile( FMAObjectAction *action, guint target, GList *files )
 
 	for( ip = profiles ; ip && !candidate ; ip = ip->next ){
 		FMAObjectProfile *profile = FMA_OBJECT_PROFILE( ip->data );
+		FMAObjectProfile *origin = ( FMAObjectProfile * ) fma_object_get_origin( profile );
+
+		if( candidates && !g_hash_table_contains( candidates, origin ? origin : profile )){
+			continue;
+		}
 
 		if( fma_icontext_is_candidate( FMA_ICONTEXT( profile ), target, files )){
 			profile_label = fma_object_get_label( profile );
@@ -1101,20 +1235,62 @@ on_settings_key_changed_handler( const gchar *group, const gchar *key, gconstpoi
 
 	if( !plugin->private->dispose_has_run ){
 
+		plugin->private->full_reload = TRUE;
 		fma_timeout_event( &plugin->private->change_timeout );
 	}
 }
 
 /*
  * automatically reloads the items, then signal the file manager.
+ *
+ * a change in the preferences requires a full reload, while items
+ * changes reported by the I/O providers may only re-read these items
  */
 static void
 on_change_event_timeout( FMAMenuPlugin *plugin )
 {
 	static const gchar *thisfn = "fma_menu_plugin_on_change_event_timeout";
-	g_debug( "%s: timeout expired", thisfn );
+	g_debug( "%s: timeout expired, full_reload=%s",
+			thisfn, plugin->private->full_reload ? "True":"False" );
+
+	if( plugin->private->full_reload ){
+		fma_pivot_load_items( plugin->private->pivot );
+	} else {
+		fma_pivot_reload_items( plugin->private->pivot );
+	}
+	plugin->private->full_reload = FALSE;
+
+	set_tokens_mask_rec( fma_pivot_get_items( plugin->private->pivot ));
+
+#if defined( HAVE_NAUTILUS_MENU_PROVIDER_EMIT_ITEMS_UPDATED_SIGNAL ) || \
+	defined( HAVE_NEMO_MENU_PROVIDER_EMIT_ITEMS_UPDATED_SIGNAL )
+	file_manager_menu_provider_emit_items_updated_signal( FILE_MANAGER_MENU_PROVIDER( plugin ));
+#endif
+}
+
+/* FMAShowIf has received a late ShowIfTrue result which changes the
+ * outcome of a condition: several results may come in a burst
+ */
+static void
+on_show_if_changed( FMAMenuPlugin *plugin )
+{
+	g_return_if_fail( FMA_IS_MENU_PLUGIN( plugin ));
+
+	if( !plugin->private->dispose_has_run ){
 
-	fma_pivot_load_items( plugin->private->pivot );
+		fma_timeout_event( &plugin->private->updated_timeout );
+	}
+}
+
+/*
+ * signal the file manager that it should rebuild its menus, without
+ * reloading the items
+ */
+static void
+on_updated_event_timeout( FMAMenuPlugin *plugin )
+{
+	static const gchar *thisfn = "fma_menu_plugin_on_updated_event_timeout";
+	g_debug( "%s: timeout expired", thisfn );
 
 #if defined( HAVE_NAUTILUS_MENU_PROVIDER_EMIT_ITEMS_UPDATED_SIGNAL ) || \
 	defined( HAVE_NEMO_MENU_PROVIDER_EMIT_ITEMS_UPDATED_SIGNAL )
@@ -0,0 +1,616 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+/*
+ * A latency benchmark of the hot paths of the file manager plugin.
+ *
+ * A synthetic corpus of menus, actions and profiles is written as
+ * .desktop files in a temporary XDG environment, along with a synthetic
+ * selection of files. The benchmark then times:
+ * - loading the items, both from the .desktop files and from the cache;
+ * - creating the FMASelectedInfo objects for the selection;
+ * - evaluating fma_icontext_is_candidate() on each context of the tree;
+ * - creating a FMATokens object from the selection;
+ * - expanding the tokens of labels, tooltips and parameters;
+ * - building the menu, as the plugin does in build_filemanager_menu(),
+ *   minus the creation of the file manager objects.
+ *
+ * Results are printed on stdout as one JSON object per line.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib/gi18n.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <api/fma-core-utils.h>
+#include <api/fma-object-api.h>
+
+#include <core/fma-pivot.h>
+#include <core/fma-selected-info.h>
+#include <core/fma-tokens.h>
+
+static gint       actions    = 200;
+static gint       menus      = 20;
+static gint       profiles   = 2;
+static gint       files      = 50;
+static gint       iterations = 20;
+static gboolean   keep       = FALSE;
+static gboolean   version    = FALSE;
+
+static GOptionEntry entries[] = {
+
+	{ "actions"              , 'a', 0, G_OPTION_ARG_INT         , &actions,
+			N_( "The count of actions to be generated [200]" ), N_( "<N>" ) },
+	{ "menus"                , 'm', 0, G_OPTION_ARG_INT         , &menus,
+			N_( "The count of menus to be generated [20]" ), N_( "<N>" ) },
+	{ "profiles"             , 'p', 0, G_OPTION_ARG_INT         , &profiles,
+			N_( "The count of profiles of each action [2]" ), N_( "<N>" ) },
+	{ "files"                , 'f', 0, G_OPTION_ARG_INT         , &files,
+			N_( "The count of selected files [50]" ), N_( "<M>" ) },
+	{ "iterations"           , 'i', 0, G_OPTION_ARG_INT         , &iterations,
+			N_( "The count of iterations of each benchmark [20]" ), N_( "<K>" ) },
+	{ "keep"                 , 'k', 0, G_OPTION_ARG_NONE        , &keep,
+			N_( "Keep the generated corpus" ), NULL },
+	{ NULL }
+};
+
+static GOptionEntry misc_entries[] = {
+
+	{ "version"              , 'v', 0, G_OPTION_ARG_NONE        , &version,
+			N_( "Output the version number" ), NULL },
+	{ NULL }
+};
+
+/* the data shared by all benchmarks
+ */
+typedef struct {
+	FMAPivot  *pivot;
+	GList     *uris;
+	GList     *selection;
+	FMATokens *tokens;
+	guint      count;					/* a result, so that the work is not optimized out */
+}
+	BenchData;
+
+typedef void ( *BenchFn )( BenchData *data );
+
+static const gchar *st_mimetypes[] = {
+	"text/plain;text/x-csrc;",
+	"image/*;",
+	"*;",
+	"inode/directory;",
+	"application/pdf;text/*;",
+	NULL
+};
+
+static const gchar *st_extensions[] = { "txt", "c", "png", "pdf", "html", NULL };
+
+static GOptionContext  *init_options( void );
+static void             check_options( int argc, char **argv, GOptionContext *context );
+static void             exit_with_usage( void );
+static void             setup_environment( const gchar *root );
+static void             write_corpus( const gchar *dir );
+static GList           *write_selection( const gchar *dir );
+static void             run( const gchar *name, BenchFn fn, BenchData *data );
+static void             bench_load_items( BenchData *data );
+static void             bench_selected_info( BenchData *data );
+static void             bench_is_candidate( BenchData *data );
+static guint            is_candidate_rec( GList *tree, GList *selection );
+static void             bench_tokens_new( BenchData *data );
+static void             bench_tokens_expand( BenchData *data );
+static guint            tokens_expand_rec( GList *tree, FMATokens *tokens );
+static void             bench_build_menu( BenchData *data );
+static guint            build_menu_rec( GList *tree, GList *selection, FMATokens *tokens, GHashTable *candidates );
+static void             remove_tree( const gchar *path );
+
+int
+main( int argc, char **argv )
+{
+	gchar *root, *dir;
+	BenchData data;
+
+#if !GLIB_CHECK_VERSION( 2,36, 0 )
+	g_type_init();
+#endif
+
+	GOptionContext *context = init_options();
+	check_options( argc, argv, context );
+
+	root = g_dir_make_tmp( "fma-bench-XXXXXX", NULL );
+	if( !root ){
+		g_printerr( _( "Error: unable to create a temporary directory.\n" ));
+		exit( EXIT_FAILURE );
+	}
+
+	/* the environment must be set before GLib caches the XDG directories
+	 */
+	setup_environment( root );
+
+	dir = g_build_filename( root, "data", "file-manager", "actions", NULL );
+	write_corpus( dir );
+	g_free( dir );
+
+	dir = g_build_filename( root, "files", NULL );
+	data.uris = write_selection( dir );
+	g_free( dir );
+
+	data.pivot = fma_pivot_new();
+	fma_pivot_set_loadable( data.pivot, !PIVOT_LOAD_DISABLED & !PIVOT_LOAD_INVALID );
+	data.selection = NULL;
+	data.tokens = NULL;
+	data.count = 0;
+
+	run( "load_items", bench_load_items, &data );
+
+	/* the first load writes the cache, next ones read it
+	 */
+	fma_pivot_set_cacheable( data.pivot, TRUE );
+	fma_pivot_load_items( data.pivot );
+	run( "load_items_cached", bench_load_items, &data );
+
+	run( "selected_info_create_for_uris", bench_selected_info, &data );
+	run( "icontext_is_candidate", bench_is_candidate, &data );
+	run( "tokens_new_from_selection", bench_tokens_new, &data );
+	run( "tokens_expand", bench_tokens_expand, &data );
+	run( "build_filemanager_menu", bench_build_menu, &data );
+
+	g_object_unref( data.tokens );
+	fma_selected_info_free_list( data.selection );
+	g_list_free_full( data.uris, ( GDestroyNotify ) g_free );
+	g_object_unref( data.pivot );
+
+	if( keep ){
+		g_printerr( "corpus kept in %s\n", root );
+	} else {
+		remove_tree( root );
+	}
+	g_free( root );
+
+	return( 0 );
+}
+
+static GOptionContext *
+init_options( void )
+{
+	GOptionContext *context;
+	gchar* description;
+	GOptionGroup *misc_group;
+
+	context = g_option_context_new( _( "Benchmark the file manager menu hot paths." ));
+
+#ifdef ENABLE_NLS
+	bindtextdomain( GETTEXT_PACKAGE, GNOMELOCALEDIR );
+# ifdef HAVE_BIND_TEXTDOMAIN_CODESET
+	bind_textdomain_codeset( GETTEXT_PACKAGE, "UTF-8" );
+# endif
+	textdomain( GETTEXT_PACKAGE );
+	g_option_context_add_main_entries( context, entries, GETTEXT_PACKAGE );
+#else
+	g_option_context_add_main_entries( context, entries, NULL );
+#endif
+
+	description = g_strdup_printf( "%s.\n%s", PACKAGE_STRING,
+			_( "Bug reports are welcomed at https://gitlab.gnome.org/GNOME/filemanager-actions/issues/\n" ));
+
+	g_option_context_set_description( context, description );
+
+	g_free( description );
+
+	misc_group = g_option_group_new(
+			"misc", _( "Miscellaneous options" ), _( "Miscellaneous options" ), NULL, NULL );
+	g_option_group_add_entries( misc_group, misc_entries );
+	g_option_context_add_group( context, misc_group );
+
+	return( context );
+}
+
+static void
+check_options( int argc, char **argv, GOptionContext *context )
+{
+	GError *error = NULL;
+
+	if( !g_option_context_parse( context, &argc, &argv, &error )){
+		g_printerr( _( "Syntax error: %s\n" ), error->message );
+		g_error_free (error);
+		exit_with_usage();
+	}
+
+	g_option_context_free( context );
+
+	if( version ){
+		fma_core_utils_print_version();
+		exit( EXIT_SUCCESS );
+	}
+
+	gint errors = 0;
+
+	if( actions < 1 || menus < 0 || profiles < 1 || files < 1 || iterations < 1 ){
+		g_printerr( _( "Error: counts must be positive.\n" ));
+		errors += 1;
+	}
+
+	if( errors ){
+		exit_with_usage();
+	}
+}
+
+static void
+exit_with_usage( void )
+{
+	g_printerr( _( "Try %s --help for usage.\n" ), g_get_prgname());
+	exit( EXIT_FAILURE );
+}
+
+/*
+ * isolate the benchmark from the user configuration
+ */
+static void
+setup_environment( const gchar *root )
+{
+	static const gchar *vars[] = {
+		"XDG_DATA_HOME",   "data",
+		"XDG_DATA_DIRS",   "system-data",
+		"XDG_CONFIG_HOME", "config",
+		"XDG_CONFIG_DIRS", "system-config",
+		"XDG_CACHE_HOME",  "cache",
+		"XDG_RUNTIME_DIR", "runtime",
+		NULL
+	};
+	guint i;
+	gchar *path;
+
+	for( i = 0 ; vars[i] ; i += 2 ){
+		path = g_build_filename( root, vars[i+1], NULL );
+		g_mkdir_with_parents( path, 0700 );
+		g_setenv( vars[i], path, TRUE );
+		g_free( path );
+	}
+}
+
+/*
+ * actions are distributed among the menus, the remaining ones being
+ * left at the level zero; labels of one action out of three embed a
+ * parameter, so that tokens expansion is actually exercised
+ */
+static void
+write_corpus( const gchar *dir )
+{
+	GString *content;
+	gchar *path;
+	gint i, j, k;
+
+	g_mkdir_with_parents( dir, 0700 );
+	content = g_string_new( "" );
+
+	for( i = 0 ; i < actions ; ++i ){
+		g_string_assign( content, "[Desktop Entry]\nType=Action\n" );
+		if( i % 3 ){
+			g_string_append_printf( content, "Name=Bench action %d\n", i );
+		} else {
+			g_string_append_printf( content, "Name=Bench action %d on %%b\n", i );
+		}
+		g_string_append_printf( content, "Tooltip=Run the bench action %d on %%F\n", i );
+		g_string_append( content, "Profiles=" );
+		for( j = 0 ; j < profiles ; ++j ){
+			g_string_append_printf( content, "p%d;", j );
+		}
+		g_string_append( content, "\n" );
+
+		for( j = 0 ; j < profiles ; ++j ){
+			k = ( i + j ) % g_strv_length(( gchar ** ) st_mimetypes );
+			g_string_append_printf( content, "\n[X-Action-Profile p%d]\n", j );
+			g_string_append_printf( content, "Name=Profile %d\n", j );
+			g_string_append( content, "Exec=echo %d %F\n" );
+			g_string_append_printf( content, "MimeTypes=%s\n", st_mimetypes[k] );
+			if( k == 2 ){
+				g_string_append( content, "Basenames=*.txt;*.c;\n" );
+			}
+			if( i % 2 ){
+				g_string_append( content, "Schemes=file;sftp;\n" );
+			}
+			if( i % 5 == 0 ){
+				g_string_append( content, "SelectionCount=>0\n" );
+			}
+		}
+
+		path = g_strdup_printf( "%s/bench-action-%d.desktop", dir, i );
+		g_file_set_contents( path, content->str, content->len, NULL );
+		g_free( path );
+	}
+
+	for( k = 0 ; k < menus ; ++k ){
+		g_string_assign( content, "[Desktop Entry]\nType=Menu\n" );
+		g_string_append_printf( content, "Name=Bench menu %d\n", k );
+		g_string_append( content, "ItemsList=" );
+		for( i = k ; i < actions / 2 ; i += menus ){
+			g_string_append_printf( content, "bench-action-%d;", i );
+		}
+		g_string_append( content, "\n" );
+
+		path = g_strdup_printf( "%s/bench-menu-%d.desktop", dir, k );
+		g_file_set_contents( path, content->str, content->len, NULL );
+		g_free( path );
+	}
+
+	g_string_free( content, TRUE );
+}
+
+/*
+ * returns the list of the URIs of the selected files
+ */
+static GList *
+write_selection( const gchar *dir )
+{
+	GList *uris;
+	gchar *path, *bname;
+	gint i;
+
+	g_mkdir_with_parents( dir, 0700 );
+	uris = NULL;
+
+	for( i = 0 ; i < files ; ++i ){
+		if( i % 10 == 9 ){
+			bname = g_strdup_printf( "folder-%d", i );
+			path = g_build_filename( dir, bname, NULL );
+			g_mkdir( path, 0700 );
+
+		} else {
+			bname = g_strdup_printf( "file-%d.%s", i, st_extensions[i % g_strv_length(( gchar ** ) st_extensions )] );
+			path = g_build_filename( dir, bname, NULL );
+			g_file_set_contents( path, "bench\n", -1, NULL );
+		}
+
+		uris = g_list_prepend( uris, g_filename_to_uri( path, NULL, NULL ));
+		g_free( path );
+		g_free( bname );
+	}
+
+	return( g_list_reverse( uris ));
+}
+
+/*
+ * times @iterations runs of the @fn function, and prints the result
+ */
+static void
+run( const gchar *name, BenchFn fn, BenchData *data )
+{
+	gint i;
+	gint64 start, elapsed, total, min, max;
+
+	total = 0;
+	min = G_MAXINT64;
+	max = 0;
+
+	for( i = 0 ; i < iterations ; ++i ){
+		start = g_get_monotonic_time();
+		( *fn )( data );
+		elapsed = g_get_monotonic_time() - start;
+
+		total += elapsed;
+		min = MIN( min, elapsed );
+		max = MAX( max, elapsed );
+	}
+
+	g_print( "{\"benchmark\": \"%s\", \"actions\": %d, \"menus\": %d, \"profiles\": %d, \"files\": %d, "
+			"\"iterations\": %d, \"min_usec\": %" G_GINT64_FORMAT ", \"mean_usec\": %" G_GINT64_FORMAT ", "
+			"\"max_usec\": %" G_GINT64_FORMAT ", \"result\": %u}\n",
+			name, actions, menus, profiles, files,
+			iterations, min, total / iterations, max, data->count );
+}
+
+static void
+bench_load_items( BenchData *data )
+{
+	fma_pivot_load_items( data->pivot );
+	data->count = g_list_length( fma_pivot_get_items( data->pivot ));
+}
+
+static void
+bench_selected_info( BenchData *data )
+{
+	gchar *errmsg;
+
+	errmsg = NULL;
+	fma_selected_info_free_list( data->selection );
+	data->selection = fma_selected_info_create_for_uris(
+			data->uris, NULL, fma_pivot_get_selection_attributes( data->pivot ), &errmsg );
+	data->count = g_list_length( data->selection );
+
+	if( errmsg ){
+		g_printerr( "%s\n", errmsg );
+		g_free( errmsg );
+	}
+}
+
+static void
+bench_is_candidate( BenchData *data )
+{
+	data->count = is_candidate_rec( fma_pivot_get_items( data->pivot ), data->selection );
+}
+
+static guint
+is_candidate_rec( GList *tree, GList *selection )
+{
+	GList *it;
+	guint count;
+
+	count = 0;
+
+	for( it = tree ; it ; it = it->next ){
+		if( fma_icontext_is_candidate( FMA_ICONTEXT( it->data ), ITEM_TARGET_SELECTION, selection )){
+			count += 1;
+		}
+		if( FMA_IS_OBJECT_ITEM( it->data )){
+			count += is_candidate_rec( fma_object_get_items( it->data ), selection );
+		}
+	}
+
+	return( count );
+}
+
+static void
+bench_tokens_new( BenchData *data )
+{
+	if( data->tokens ){
+		g_object_unref( data->tokens );
+	}
+	data->tokens = fma_tokens_new_from_selection( data->selection );
+	data->count = 1;
+}
+
+static void
+bench_tokens_expand( BenchData *data )
+{
+	data->count = tokens_expand_rec( fma_pivot_get_items( data->pivot ), data->tokens );
+}
+
+static guint
+tokens_expand_rec( GList *tree, FMATokens *tokens )
+{
+	GList *it;
+	guint count;
+	gchar *str, *expanded;
+
+	count = 0;
+
+	for( it = tree ; it ; it = it->next ){
+		if( FMA_IS_OBJECT_PROFILE( it->data )){
+			str = fma_object_get_parameters( it->data );
+
+		} else {
+			str = fma_object_get_tooltip( it->data );
+			expanded = fma_tokens_parse_for_display( tokens, str, TRUE );
+			count += strlen( expanded );
+			g_free( expanded );
+			g_free( str );
+
+			str = fma_object_get_label( it->data );
+			count += tokens_expand_rec( fma_object_get_items( it->data ), tokens );
+		}
+
+		expanded = fma_tokens_parse_for_display( tokens, str, TRUE );
+		count += strlen( expanded );
+		g_free( expanded );
+		g_free( str );
+	}
+
+	return( count );
+}
+
+/*
+ * same as build_filemanager_menu() in the menu plugin
+ */
+static void
+bench_build_menu( BenchData *data )
+{
+	FMATokens *tokens;
+	GHashTable *candidates;
+
+	tokens = fma_tokens_new_from_selection( data->selection );
+	candidates = fma_pivot_get_candidates( data->pivot, ITEM_TARGET_SELECTION, data->selection );
+
+	data->count = build_menu_rec( fma_pivot_get_items( data->pivot ), data->selection, tokens, candidates );
+
+	if( candidates ){
+		g_hash_table_destroy( candidates );
+	}
+	g_object_unref( tokens );
+}
+
+static guint
+build_menu_rec( GList *tree, GList *selection, FMATokens *tokens, GHashTable *candidates )
+{
+	GList *it, *ip;
+	guint count;
+	gchar *label, *expanded;
+
+	count = 0;
+
+	for( it = tree ; it ; it = it->next ){
+
+		if( candidates && !g_hash_table_contains( candidates, it->data )){
+			continue;
+		}
+		if( !fma_icontext_is_candidate( FMA_ICONTEXT( it->data ), ITEM_TARGET_SELECTION, selection )){
+			continue;
+		}
+
+		label = fma_object_get_label( it->data );
+		expanded = fma_tokens_parse_for_display( tokens, label, TRUE );
+		g_free( label );
+
+		if( FMA_IS_OBJECT_MENU( it->data )){
+			if( build_menu_rec( fma_object_get_items( it->data ), selection, tokens, candidates )){
+				count += 1;
+			}
+
+		} else {
+			for( ip = fma_object_get_items( it->data ) ; ip ; ip = ip->next ){
+				if( candidates && !g_hash_table_contains( candidates, ip->data )){
+					continue;
+				}
+				if( fma_icontext_is_candidate( FMA_ICONTEXT( ip->data ), ITEM_TARGET_SELECTION, selection )){
+					count += 1;
+					break;
+				}
+			}
+		}
+
+		g_free( expanded );
+	}
+
+	return( count );
+}
+
+static void
+remove_tree( const gchar *path )
+{
+	GDir *dir;
+	const gchar *name;
+	gchar *child;
+
+	if( g_file_test( path, G_FILE_TEST_IS_DIR ) && !g_file_test( path, G_FILE_TEST_IS_SYMLINK )){
+		dir = g_dir_open( path, 0, NULL );
+		if( dir ){
+			while(( name = g_dir_read_name( dir ))){
+				child = g_build_filename( path, name, NULL );
+				remove_tree( child );
+				g_free( child );
+			}
+			g_dir_close( dir );
+		}
+	}
+
+	g_remove( path );
+}
@@ -34,6 +34,7 @@
 #include <gtk/gtk.h>
 #include <string.h>
 
+#include "api/fma-core-utils.h"
 #include "api/fma-object-api.h"
 
 #include "core/fma-exporter.h"
@@ -112,9 +113,11 @@ static void   instance_finalize( GObject *application );
 
 static void   get_from_dnd_clipboard_callback( GtkClipboard *clipboard, GtkSelectionData *selection_data, guint info, guchar *data );
 static void   clear_dnd_clipboard_callback( GtkClipboard *clipboard, FMAClipboardDndData *data );
-static gchar *export_rows( FMAClipboard *clipboard, GList *rows, const gchar *dest_folder );
-static gchar *export_objects( FMAClipboard *clipboard, GList *objects );
-static gchar *export_row_object( FMAClipboard *clipboard, FMAObject *object, const gchar *dest_folder, GList **exported, gboolean first );
+static void   export_rows( FMAClipboard *clipboard, GList *rows, const gchar *dest_folder, GOutputStream *stream );
+static void   export_objects( FMAClipboard *clipboard, GList *objects, GOutputStream *stream );
+static void   export_row_object( FMAClipboard *clipboard, FMAObject *object, const gchar *dest_folder, GOutputStream *stream, GList **exported, gboolean first );
+static GOutputStream *export_stream_new( void );
+static gchar *export_stream_steal( GOutputStream *stream, gsize *length );
 
 static void   get_from_primary_clipboard_callback( GtkClipboard *gtk_clipboard, GtkSelectionData *selection_data, guint info, FMAClipboard *clipboard );
 static void   clear_primary_clipboard( FMAClipboard *clipboard );
@@ -379,7 +382,9 @@ gchar *
 fma_clipboard_dnd_get_text( FMAClipboard *clipboard, GList *rows )
 {
 	static const gchar *thisfn = "fma_clipboard_dnd_get_text";
+	GOutputStream *stream;
 	gchar *buffer;
+	gsize length;
 
 	g_return_val_if_fail( FMA_IS_CLIPBOARD( clipboard ), NULL );
 
@@ -390,8 +395,10 @@ fma_clipboard_dnd_get_text( FMAClipboard *clipboard, GList *rows )
 
 	if( !clipboard->private->dispose_has_run ){
 
-		buffer = export_rows( clipboard, rows, NULL );
-		g_debug( "%s: returning buffer=%p (length=%lu)", thisfn, ( void * ) buffer, g_utf8_strlen( buffer, -1 ));
+		stream = export_stream_new();
+		export_rows( clipboard, rows, NULL, stream );
+		buffer = export_stream_steal( stream, &length );
+		g_debug( "%s: returning buffer=%p (length=%lu)", thisfn, ( void * ) buffer, ( gulong ) length );
 	}
 
 	return( buffer );
@@ -409,7 +416,6 @@ fma_clipboard_dnd_drag_end( FMAClipboard *clipboard )
 	static const gchar *thisfn = "fma_clipboard_dnd_drag_end";
 	GtkSelectionData *selection;
 	FMAClipboardDndData *data;
-	gchar *buffer;
 
 	g_debug( "%s: clipboard=%p", thisfn, ( void * ) clipboard );
 	g_return_if_fail( FMA_IS_CLIPBOARD( clipboard ));
@@ -425,8 +431,7 @@ fma_clipboard_dnd_drag_end( FMAClipboard *clipboard )
 
 			if( data->target == FMA_XCHANGE_FORMAT_XDS ){
 				g_debug( "%s: folder=%s", thisfn, data->folder );
-				buffer = export_rows( clipboard, data->rows, data->folder );
-				g_free( buffer );
+				export_rows( clipboard, data->rows, data->folder, NULL );
 			}
 
 			gtk_selection_data_free( selection );
@@ -480,29 +485,25 @@ clear_dnd_clipboard_callback( GtkClipboard *clipboard, FMAClipboardDndData *data
 }
 
 /*
- * returns a buffer which contains all exported items if dest_folder is null
- * else export items as files to target directory, returning an empty string
+ * writes all exported items to the stream if dest_folder is null
+ * else export items as files to target directory
  */
-static gchar *
-export_rows( FMAClipboard *clipboard, GList *rows, const gchar *dest_folder )
+static void
+export_rows( FMAClipboard *clipboard, GList *rows, const gchar *dest_folder, GOutputStream *stream )
 {
 	static const gchar *thisfn = "fma_clipboard_export_rows";
-	GString *data;
 	GtkTreeModel *model;
 	GList *exported, *irow;
 	GtkTreePath *path;
 	GtkTreeIter iter;
 	FMAObject *object;
-	gchar *buffer;
 	gboolean first;
 
-	g_debug( "%s: clipboard=%p, rows=%p (count=%d), dest_folder=%s",
-			thisfn, ( void * ) clipboard, ( void * ) rows, g_list_length( rows ), dest_folder );
+	g_debug( "%s: clipboard=%p, rows=%p (count=%d), dest_folder=%s, stream=%p",
+			thisfn, ( void * ) clipboard, ( void * ) rows, g_list_length( rows ), dest_folder, ( void * ) stream );
 
 	first = TRUE;
-	buffer = NULL;
 	exported = NULL;
-	data = g_string_new( "" );
 	model = gtk_tree_row_reference_get_model(( GtkTreeRowReference * ) rows->data );
 
 	for( irow = rows ; irow ; irow = irow->next ){
@@ -511,59 +512,46 @@ export_rows( FMAClipboard *clipboard, GList *rows, const gchar *dest_folder )
 			gtk_tree_model_get_iter( model, &iter, path );
 			gtk_tree_path_free( path );
 			gtk_tree_model_get( model, &iter, TREE_COLUMN_NAOBJECT, &object, -1 );
-			buffer = export_row_object( clipboard, object, dest_folder, &exported, first );
-			if( buffer && strlen( buffer )){
-				data = g_string_append( data, buffer );
-				g_free( buffer );
-			}
+			export_row_object( clipboard, object, dest_folder, stream, &exported, first );
 			g_object_unref( object );
 		}
 		first = FALSE;
 	}
 
 	g_list_free( exported );
-	return( g_string_free( data, FALSE ));
 }
 
-static gchar *
-export_objects( FMAClipboard *clipboard, GList *objects )
+static void
+export_objects( FMAClipboard *clipboard, GList *objects, GOutputStream *stream )
 {
-	gchar *buffer;
-	GString *data;
 	GList *exported;
 	GList *iobj;
 	FMAObject *object;
 	gboolean first;
 
 	first = TRUE;
-	buffer = NULL;
 	exported = NULL;
-	data = g_string_new( "" );
 
 	for( iobj = objects ; iobj ; iobj = iobj->next ){
 		object = FMA_OBJECT( iobj->data );
-		buffer = export_row_object( clipboard, object, NULL, &exported, first );
-		if( buffer && strlen( buffer )){
-			data = g_string_append( data, buffer );
-			g_free( buffer );
-		}
+		export_row_object( clipboard, object, NULL, stream, &exported, first );
 		g_object_unref( object );
 		first = FALSE;
 	}
 
 	g_list_free( exported );
-	return( g_string_free( data, FALSE ));
 }
 
 /*
- * export to a buffer if dest_folder is null, and returns this buffer
- * else export to a new file in the target directory (returning an empty string)
+ * export to the stream if dest_folder is null
+ * else export to a new file in the target directory, the exporter
+ * writing directly to this file
  *
  * exported maintains a list of exported items, so that the same item is not
  * exported twice
  */
-static gchar *
-export_row_object( FMAClipboard *clipboard, FMAObject *object, const gchar *dest_folder, GList **exported, gboolean first )
+static void
+export_row_object( FMAClipboard *clipboard, FMAObject *object, const gchar *dest_folder, GOutputStream *stream, GList **exported, gboolean first )
 {
 	static const gchar *thisfn = "fma_clipboard_export_row_object";
 	GList *subitems, *isub;
@@ -572,25 +560,17 @@ export_row_object( FMAClipboard *clipboard, FMAObject *object, const gchar *dest
 	FMAObjectItem *item;
 	gchar *item_label;
 	gint index;
-	GString *data;
-	gchar *buffer;
 	gchar *format;
 	gchar *fname;
 	GSList *msgs;
 
-	data = g_string_new( "" );
-
 	/* if we have a menu, first export the subitems
 	 */
 	if( FMA_IS_OBJECT_MENU( object )){
 		subitems = fma_object_get_items( object );
 
 		for( isub = subitems ; isub ; isub = isub->next ){
-			buffer = export_row_object( clipboard, isub->data, dest_folder, exported, first );
-			if( buffer && strlen( buffer )){
-				data = g_string_append( data, buffer );
-				g_free( buffer );
-			}
+			export_row_object( clipboard, isub->data, dest_folder, stream, exported, first );
 			first = FALSE;
 		}
 	}
@@ -617,12 +597,12 @@ export_row_object( FMAClipboard *clipboard, FMAObject *object, const gchar *dest
 
 		*exported = g_list_prepend( *exported, ( gpointer ) item );
 		format = fma_settings_get_string( IPREFS_EXPORT_PREFERRED_FORMAT, NULL, NULL );
-		g_return_val_if_fail( format && strlen( format ), NULL );
+		g_return_if_fail( format && strlen( format ));
 
 		if( !strcmp( format, EXPORTER_FORMAT_ASK )){
 			g_free( format );
 			format = fma_export_ask_user( item, first );
-			g_return_val_if_fail( format && strlen( format ), NULL );
+			g_return_if_fail( format && strlen( format ));
 		}
 
 		if( strcmp( format, EXPORTER_FORMAT_NOEXPORT ) != 0 ){
@@ -631,18 +611,44 @@ export_row_object( FMAClipboard *clipboard, FMAObject *object, const gchar *dest
 				g_free( fname );
 
 			} else {
-				buffer = fma_exporter_to_buffer( FMA_PIVOT( updater ), item, format, &msgs );
-				if( buffer && strlen( buffer )){
-					data = g_string_append( data, buffer );
-					g_free( buffer );
-				}
+				fma_exporter_to_stream( FMA_PIVOT( updater ), item, format, stream, &msgs );
 			}
 		}
 
 		g_free( format );
 	}
 
-	return( g_string_free( data, FALSE ));
+	fma_core_utils_slist_free( msgs );
+}
+
+/*
+ * the clipboard and drag-and-drop payloads are accumulated in a single
+ * growing memory buffer
+ */
+static GOutputStream *
+export_stream_new( void )
+{
+	return( g_memory_output_stream_new( NULL, 0, g_realloc, g_free ));
+}
+
+/*
+ * returns the exported data as a null-terminated string which should
+ * be g_free() by the caller, @length being set to its length without
+ * the trailing null byte
+ */
+static gchar *
+export_stream_steal( GOutputStream *stream, gsize *length )
+{
+	gchar *buffer;
+
+	g_output_stream_write_all( stream, "", 1, NULL, NULL, NULL );
+	g_output_stream_close( stream, NULL, NULL );
+
+	*length = g_memory_output_stream_get_data_size( G_MEMORY_OUTPUT_STREAM( stream )) - 1;
+	buffer = g_memory_output_stream_steal_data( G_MEMORY_OUTPUT_STREAM( stream ));
+	g_object_unref( stream );
+
+	return( buffer );
 }
 
 /**
@@ -802,7 +808,9 @@ get_from_primary_clipboard_callback( GtkClipboard *gtk_clipboard, GtkSelectionDa
 {
 	static const gchar *thisfn = "fma_clipboard_get_from_primary_clipboard_callback";
 	PrimaryData *user_data;
+	GOutputStream *stream;
 	gchar *buffer;
+	gsize length;
 	GdkAtom selection_data_target;
 
 	selection_data_target = gtk_selection_data_get_target( selection_data );
@@ -814,9 +822,11 @@ get_from_primary_clipboard_callback( GtkClipboard *gtk_clipboard, GtkSelectionDa
 	user_data = clipboard->private->primary_data;
 
 	if( info == FMA_CLIPBOARD_FORMAT_TEXT_PLAIN ){
-		buffer = export_objects( clipboard, user_data->items );
+		stream = export_stream_new();
+		export_objects( clipboard, user_data->items, stream );
+		buffer = export_stream_steal( stream, &length );
 		gtk_selection_data_set( selection_data,
-				selection_data_target, 8, ( const guchar * ) buffer, strlen( buffer ));
+				selection_data_target, 8, ( const guchar * ) buffer, length );
 		g_free( buffer );
 
 	} else {
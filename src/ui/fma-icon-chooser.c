@@ -37,6 +37,7 @@
 #include "fma-application.h"
 #include "base-gtk-utils.h"
 #include "fma-icon-chooser.h"
+#include "fma-icon-loader.h"
 #include "fma-main-window.h"
 
 /* private class data
@@ -79,16 +80,6 @@ enum {
 	THEME_CONTEXT_N_COLUMN
 };
 
-/* column ordering in the ThemeIconView model
- * foreach selected context, we display in the icon view the list of
- * corresponding icons
- */
-enum {
-	THEME_ICON_LABEL_COLUMN = 0,
-	THEME_ICON_PIXBUF_COLUMN,
-	THEME_ICON_N_COLUMN
-};
-
 static const gchar     *st_xmlui_filename = PKGUIDIR "/fma-icon-chooser.ui";
 static const gchar     *st_toplevel_name  = "IconChooserDialog";
 static const gchar     *st_wsp_name       = IPREFS_ICON_CHOOSER_WSP;
@@ -120,6 +111,8 @@ static gboolean      on_icon_view_button_press_event( GtkWidget *widget, GdkEven
 static gboolean      on_key_pressed_event( GtkWidget *widget, GdkEventKey *event, FMAIconChooser *editor );
 static void          on_themed_context_changed( GtkTreeSelection *selection, FMAIconChooser *editor );
 static void          on_themed_icon_changed( GtkIconView *icon_view, FMAIconChooser *editor );
+static void          on_themed_icon_scrolled( GtkAdjustment *adjustment, FMAIconChooser *editor );
+static gboolean      themed_icon_set_visible( FMAIconChooser *editor );
 static void          on_themed_apply_button_clicked( GtkButton *button, FMAIconChooser *editor );
 static void          on_themed_apply_triggered( FMAIconChooser *editor );
 static void          on_path_selection_changed( GtkFileChooser *chooser, FMAIconChooser *editor );
@@ -399,8 +392,8 @@ do_initialize_themed_icons( FMAIconChooser *editor )
 	gtk_tree_view_append_column( context_view, column );
 
 	icon_view = GTK_ICON_VIEW( base_window_get_widget( BASE_WINDOW( editor ), "ThemedIconView" ));
-	gtk_icon_view_set_text_column( icon_view, THEME_ICON_LABEL_COLUMN );
-	gtk_icon_view_set_pixbuf_column( icon_view, THEME_ICON_PIXBUF_COLUMN );
+	gtk_icon_view_set_text_column( icon_view, ICON_LOADER_LABEL_COLUMN );
+	gtk_icon_view_set_pixbuf_column( icon_view, ICON_LOADER_PIXBUF_COLUMN );
 	gtk_icon_view_set_selection_mode( icon_view, GTK_SELECTION_BROWSE );
 
 	selection = gtk_tree_view_get_selection( context_view );
@@ -494,6 +487,7 @@ fillup_themed_icons( FMAIconChooser *editor )
 	GtkTreeSelection *selection;
 	GtkTreePath *path;
 	GtkIconView *icon_view;
+	GtkAdjustment *adjustment;
 
 	icon_view = GTK_ICON_VIEW( base_window_get_widget( BASE_WINDOW( editor ), "ThemedIconView" ));
 	base_window_signal_connect(
@@ -502,6 +496,24 @@ fillup_themed_icons( FMAIconChooser *editor )
 			"selection-changed",
 			G_CALLBACK( on_themed_icon_changed ));
 
+	/* the pixbufs of the visible icons are loaded first
+	 * the visible range changes when the view is scrolled, but also
+	 * when it is laid out again, e.g. after a resize
+	 */
+	adjustment = gtk_scrollable_get_vadjustment( GTK_SCROLLABLE( icon_view ));
+	if( adjustment ){
+		base_window_signal_connect(
+				BASE_WINDOW( editor ),
+				G_OBJECT( adjustment ),
+				"value-changed",
+				G_CALLBACK( on_themed_icon_scrolled ));
+		base_window_signal_connect(
+				BASE_WINDOW( editor ),
+				G_OBJECT( adjustment ),
+				"changed",
+				G_CALLBACK( on_themed_icon_scrolled ));
+	}
+
 	/* catch double-click */
 	base_window_signal_connect(
 			BASE_WINDOW( editor ),
@@ -656,7 +668,8 @@ on_destroy( GtkWidget *widget, GdkEvent *event, void *foo )
 
 	g_debug( "%s: widget=%p", thisfn, ( void * ) widget );
 
-	/* clear the various models
+	/* clear the context model
+	 * the icon stores are cached by the icon loader, and so only released
 	 */
 	context_view = GTK_TREE_VIEW( fma_gtk_utils_find_widget_by_name( GTK_CONTAINER( widget ), "ThemedTreeView" ));
 	context_store = GTK_LIST_STORE( gtk_tree_view_get_model( context_view ));
@@ -669,8 +682,7 @@ on_destroy( GtkWidget *widget, GdkEvent *event, void *foo )
 					THEME_CONTEXT_STORE_COLUMN, &icon_store,
 					-1 );
 			if( icon_store ){
-				g_debug( "%s: context=%s, clearing store=%p", thisfn, context_label, ( void * ) icon_store );
-				gtk_list_store_clear( icon_store );
+				g_debug( "%s: context=%s, releasing store=%p", thisfn, context_label, ( void * ) icon_store );
 				g_object_unref( icon_store );
 			}
 
@@ -762,6 +774,11 @@ on_themed_context_changed( GtkTreeSelection *selection, FMAIconChooser *editor )
 			gtk_label_set_text( GTK_LABEL( preview_label ), "" );
 		}
 
+		/* until the view has been laid out, it is displayed from its top */
+		if( !themed_icon_set_visible( editor )){
+			fma_icon_loader_set_visible( store, 0, 0 );
+		}
+
 		g_free( last_path );
 		g_free( context );
 		g_object_unref( store );
@@ -788,7 +805,7 @@ on_themed_icon_changed( GtkIconView *icon_view, FMAIconChooser *editor )
 
 		if( gtk_tree_model_get_iter( model, &iter, ( GtkTreePath * ) selected->data )){
 			gtk_tree_model_get( model, &iter,
-					THEME_ICON_LABEL_COLUMN, &label,
+					ICON_LOADER_LABEL_COLUMN, &label,
 					-1 );
 
 			preview_image = base_window_get_widget( BASE_WINDOW( editor ), "ThemedIconImage" );
@@ -814,6 +831,43 @@ on_themed_icon_changed( GtkIconView *icon_view, FMAIconChooser *editor )
 	}
 }
 
+/*
+ * the visible range of the icon view may have changed
+ */
+static void
+on_themed_icon_scrolled( GtkAdjustment *adjustment, FMAIconChooser *editor )
+{
+	themed_icon_set_visible( editor );
+}
+
+/*
+ * have the icon loader load the icons of the visible range first
+ *
+ * returns %FALSE if the icon view has not been laid out yet
+ */
+static gboolean
+themed_icon_set_visible( FMAIconChooser *editor )
+{
+	GtkIconView *icon_view;
+	GtkTreeModel *model;
+	GtkTreePath *first, *last;
+	gboolean set;
+
+	set = FALSE;
+	icon_view = GTK_ICON_VIEW( base_window_get_widget( BASE_WINDOW( editor ), "ThemedIconView" ));
+	model = gtk_icon_view_get_model( icon_view );
+
+	if( model && gtk_icon_view_get_visible_range( icon_view, &first, &last )){
+		fma_icon_loader_set_visible( GTK_LIST_STORE( model ),
+				gtk_tree_path_get_indices( first )[0], gtk_tree_path_get_indices( last )[0] );
+		gtk_tree_path_free( first );
+		gtk_tree_path_free( last );
+		set = TRUE;
+	}
+
+	return( set );
+}
+
 static void
 on_themed_apply_button_clicked( GtkButton *button, FMAIconChooser *editor )
 {
@@ -892,47 +946,22 @@ on_path_apply_button_clicked( GtkButton *button, FMAIconChooser *editor )
 	on_current_icon_changed( editor );
 }
 
+/*
+ * the names of the icons are all available in the returned store, while
+ * the pixbufs are loaded in the background
+ */
 static GtkListStore *
 theme_context_load_icons( FMAIconChooser *editor, const gchar *context )
 {
 	static const gchar *thisfn = "fma_icon_chooser_theme_context_load_icons";
-	GtkTreeIter iter;
-	GList *ic;
-	GError *error;
 	gint width, height;
 
 	g_debug( "%s: editor=%p, context=%s", thisfn, ( void * ) editor, context );
 
-	GtkIconTheme *icon_theme = gtk_icon_theme_get_default();
-	GtkListStore *store = gtk_list_store_new( THEME_ICON_N_COLUMN, G_TYPE_STRING, GDK_TYPE_PIXBUF );
-
-	GList *icon_list = g_list_sort( gtk_icon_theme_list_icons( icon_theme, context ), ( GCompareFunc ) g_utf8_collate );
-
 	if( !gtk_icon_size_lookup( VIEW_ICON_SIZE, &width, &height )){
 		width = VIEW_ICON_DEFAULT_WIDTH;
 	}
 	g_debug( "%s: width=%d", thisfn, width );
 
-	for( ic = icon_list ; ic ; ic = ic->next ){
-		const gchar *icon_name = ( const gchar * ) ic->data;
-		error = NULL;
-		GdkPixbuf *pixbuf = gtk_icon_theme_load_icon(
-				icon_theme, icon_name, width, GTK_ICON_LOOKUP_GENERIC_FALLBACK, &error );
-		if( error ){
-			g_warning( "%s: %s", thisfn, error->message );
-			g_error_free( error );
-		} else {
-			gtk_list_store_append( store, &iter );
-			gtk_list_store_set( store, &iter,
-					THEME_ICON_LABEL_COLUMN, icon_name,
-					THEME_ICON_PIXBUF_COLUMN, pixbuf,
-					-1 );
-			g_object_unref( pixbuf );
-		}
-	}
-	g_debug( "%s: %d loaded icons in store=%p", thisfn, g_list_length( icon_list ), ( void * ) store );
-	g_list_foreach( icon_list, ( GFunc ) g_free, NULL );
-	g_list_free( icon_list );
-
-	return( store );
+	return( fma_icon_loader_get_store( context, width ));
 }
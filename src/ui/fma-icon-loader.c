@@ -0,0 +1,437 @@
+/*
+ * Nautilus Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "api/fma-core-utils.h"
+
+#include "fma-icon-loader.h"
+
+/* a loader is attached to each cached store
+ * it is only ever accessed from the main thread: the worker threads
+ * only see the sLoaderJob they are given
+ */
+typedef struct {
+	gint          ref_count;
+	GtkListStore *store;
+	gint          size;
+	guint         count;
+	gchar       **filenames;			/* NULL for builtin icons */
+	guint8       *status;
+	guint         pending;				/* count of ROW_PENDING rows */
+	guint         in_flight;
+	guint         first_visible;
+	guint         last_visible;
+	guint         cursor;				/* where to search for the next non-visible row */
+	gboolean      stopped;				/* when removed from the cache */
+}
+	sLoader;
+
+/* the status of each row of the store
+ */
+enum {
+	ROW_PENDING = 0,
+	ROW_RUNNING,
+	ROW_DONE
+};
+
+/* a pixbuf to be loaded by a worker thread
+ */
+typedef struct {
+	sLoader   *loader;
+	guint      row;
+	gchar     *filename;
+	gint       size;
+	GdkPixbuf *pixbuf;
+}
+	sLoaderJob;
+
+#define ICON_LOADER_PROP_DATA			"fma-icon-loader-prop-data"
+
+/* the count of jobs which may be simultaneously queued for a store,
+ * so that a newly visible range does not wait behind the whole context
+ */
+#define ICON_LOADER_MAX_JOBS			16
+#define ICON_LOADER_MAX_THREADS			4
+
+static GHashTable  *st_cache = NULL;
+static GThreadPool *st_pool  = NULL;
+
+static GHashTable *get_cache( void );
+static void        on_theme_changed( GtkIconTheme *theme, void *empty );
+static sLoader    *loader_new( const gchar *context, gint size );
+static void        loader_stop_unref( sLoader *loader );
+static void        loader_unref( sLoader *loader );
+static void        feed( sLoader *loader );
+static gint        next_pending( sLoader *loader );
+static void        load_builtin( sLoader *loader, guint row );
+static void        load_job( sLoaderJob *job, void *empty );
+static gboolean    on_job_done( sLoaderJob *job );
+static void        set_row_pixbuf( sLoader *loader, guint row, GdkPixbuf *pixbuf );
+
+/**
+ * fma_icon_loader_get_store:
+ * @context: the icon theme context.
+ * @size: the size of the icons, in pixels.
+ *
+ * Returns: the list store of the icons of @context, with a new reference
+ * which should be g_object_unref() by the caller.
+ *
+ * The names of the icons are all set, while the pixbufs are filled in
+ * as they are loaded.
+ */
+GtkListStore *
+fma_icon_loader_get_store( const gchar *context, gint size )
+{
+	static const gchar *thisfn = "fma_icon_loader_get_store";
+	GHashTable *cache;
+	gchar *theme, *key;
+	sLoader *loader;
+
+	g_return_val_if_fail( context && g_utf8_strlen( context, -1 ), NULL );
+
+	theme = NULL;
+	g_object_get( gtk_settings_get_default(), "gtk-icon-theme-name", &theme, NULL );
+	key = g_strdup_printf( "%s:%d:%s", theme ? theme : "", size, context );
+	g_free( theme );
+
+	cache = get_cache();
+	loader = ( sLoader * ) g_hash_table_lookup( cache, key );
+
+	if( loader ){
+		g_debug( "%s: key=%s, store=%p found in cache", thisfn, key, ( void * ) loader->store );
+		g_free( key );
+
+	} else {
+		loader = loader_new( context, size );
+		g_debug( "%s: key=%s, count=%u, store=%p", thisfn, key, loader->count, ( void * ) loader->store );
+		g_hash_table_insert( cache, key, loader );
+		feed( loader );
+	}
+
+	return( g_object_ref( loader->store ));
+}
+
+/**
+ * fma_icon_loader_set_visible:
+ * @store: a list store returned by fma_icon_loader_get_store().
+ * @first: the index of the first visible row.
+ * @last: the index of the last visible row.
+ *
+ * Loads the pixbufs of the visible rows before the others.
+ */
+void
+fma_icon_loader_set_visible( GtkListStore *store, gint first, gint last )
+{
+	sLoader *loader;
+
+	g_return_if_fail( GTK_IS_LIST_STORE( store ));
+
+	loader = ( sLoader * ) g_object_get_data( G_OBJECT( store ), ICON_LOADER_PROP_DATA );
+
+	if( loader && loader->count ){
+		first = CLAMP( first, 0, ( gint ) loader->count-1 );
+		last = CLAMP( last, first, ( gint ) loader->count-1 );
+
+		loader->first_visible = first;
+		loader->last_visible = last;
+		loader->cursor = ( last+1 ) % loader->count;
+
+		feed( loader );
+	}
+}
+
+static GHashTable *
+get_cache( void )
+{
+	if( !st_cache ){
+		st_cache = g_hash_table_new_full(
+				g_str_hash, g_str_equal, ( GDestroyNotify ) g_free, ( GDestroyNotify ) loader_stop_unref );
+
+		g_signal_connect(
+				gtk_icon_theme_get_default(), "changed", G_CALLBACK( on_theme_changed ), NULL );
+	}
+
+	return( st_cache );
+}
+
+/*
+ * the stores which are currently displayed are kept alive by their
+ * views, but are not completed anymore
+ */
+static void
+on_theme_changed( GtkIconTheme *theme, void *empty )
+{
+	static const gchar *thisfn = "fma_icon_loader_on_theme_changed";
+
+	g_debug( "%s: theme=%p, clearing %u cached stores",
+			thisfn, ( void * ) theme, g_hash_table_size( st_cache ));
+
+	g_hash_table_remove_all( st_cache );
+}
+
+/*
+ * the names are only looked up in the icon theme, which does not
+ * involve reading the image files: a name which cannot be found is
+ * not displayed
+ */
+static sLoader *
+loader_new( const gchar *context, gint size )
+{
+	GtkIconTheme *icon_theme;
+	GList *icon_list, *ic;
+	GPtrArray *filenames;
+	GtkIconInfo *info;
+	const gchar *filename;
+	GtkTreeIter iter;
+	sLoader *loader;
+
+	loader = g_new0( sLoader, 1 );
+	loader->ref_count = 1;
+	loader->size = size;
+	loader->store = gtk_list_store_new( ICON_LOADER_N_COLUMN, G_TYPE_STRING, GDK_TYPE_PIXBUF );
+
+	icon_theme = gtk_icon_theme_get_default();
+	icon_list = g_list_sort( gtk_icon_theme_list_icons( icon_theme, context ), ( GCompareFunc ) g_utf8_collate );
+	filenames = g_ptr_array_new();
+
+	for( ic = icon_list ; ic ; ic = ic->next ){
+		info = gtk_icon_theme_lookup_icon(
+				icon_theme, ( const gchar * ) ic->data, size, GTK_ICON_LOOKUP_GENERIC_FALLBACK );
+		if( info ){
+			filename = gtk_icon_info_get_filename( info );
+			g_ptr_array_add( filenames, g_strdup( filename ));
+
+			gtk_list_store_append( loader->store, &iter );
+			gtk_list_store_set( loader->store, &iter, ICON_LOADER_LABEL_COLUMN, ic->data, -1 );
+#if GTK_CHECK_VERSION( 3, 8, 0 )
+			g_object_unref( info );
+#else
+			gtk_icon_info_free( info );
+#endif
+		}
+	}
+
+	g_list_foreach( icon_list, ( GFunc ) g_free, NULL );
+	g_list_free( icon_list );
+
+	loader->count = filenames->len;
+	loader->filenames = ( gchar ** ) g_ptr_array_free( filenames, FALSE );
+	loader->status = g_new0( guint8, loader->count );
+	loader->pending = loader->count;
+
+	g_object_set_data( G_OBJECT( loader->store ), ICON_LOADER_PROP_DATA, loader );
+
+	return( loader );
+}
+
+static void
+loader_stop_unref( sLoader *loader )
+{
+	loader->stopped = TRUE;
+	loader_unref( loader );
+}
+
+/*
+ * the store may survive to the loader when it is still displayed
+ */
+static void
+loader_unref( sLoader *loader )
+{
+	guint i;
+
+	loader->ref_count -= 1;
+
+	if( !loader->ref_count ){
+		g_object_set_data( G_OBJECT( loader->store ), ICON_LOADER_PROP_DATA, NULL );
+		g_object_unref( loader->store );
+
+		for( i = 0 ; i < loader->count ; ++i ){
+			g_free( loader->filenames[i] );
+		}
+		g_free( loader->filenames );
+		g_free( loader->status );
+		g_free( loader );
+	}
+}
+
+/*
+ * queue the next rows to be loaded, up to ICON_LOADER_MAX_JOBS
+ * builtin icons, which do not have a filename, are cheaply loaded
+ * from the main thread
+ */
+static void
+feed( sLoader *loader )
+{
+	sLoaderJob *job;
+	gint row;
+
+	if( !st_pool ){
+		st_pool = g_thread_pool_new(( GFunc ) load_job, NULL,
+				MIN( fma_core_utils_get_processors_count(), ICON_LOADER_MAX_THREADS ), FALSE, NULL );
+	}
+
+	while( !loader->stopped && loader->in_flight < ICON_LOADER_MAX_JOBS ){
+		row = next_pending( loader );
+		if( row < 0 ){
+			break;
+		}
+
+		loader->pending -= 1;
+
+		if( !loader->filenames[row] ){
+			load_builtin( loader, row );
+			continue;
+		}
+
+		job = g_new0( sLoaderJob, 1 );
+		job->loader = loader;
+		job->row = row;
+		job->filename = g_strdup( loader->filenames[row] );
+		job->size = loader->size;
+
+		loader->status[row] = ROW_RUNNING;
+		loader->in_flight += 1;
+		loader->ref_count += 1;
+
+		g_thread_pool_push( st_pool, job, NULL );
+	}
+}
+
+/*
+ * the visible rows first, then the rows which follow them, wrapping
+ * to the start of the store
+ */
+static gint
+next_pending( sLoader *loader )
+{
+	guint i, n;
+
+	if( !loader->pending ){
+		return( -1 );
+	}
+
+	for( i = loader->first_visible ; i <= loader->last_visible && i < loader->count ; ++i ){
+		if( loader->status[i] == ROW_PENDING ){
+			return( i );
+		}
+	}
+
+	for( n = 0 ; n < loader->count ; ++n ){
+		i = loader->cursor;
+		loader->cursor = ( loader->cursor + 1 ) % loader->count;
+		if( loader->status[i] == ROW_PENDING ){
+			return( i );
+		}
+	}
+
+	return( -1 );
+}
+
+static void
+load_builtin( sLoader *loader, guint row )
+{
+	static const gchar *thisfn = "fma_icon_loader_load_builtin";
+	GtkTreeIter iter;
+	gchar *name;
+	GdkPixbuf *pixbuf;
+	GError *error;
+
+	loader->status[row] = ROW_DONE;
+
+	if( gtk_tree_model_iter_nth_child( GTK_TREE_MODEL( loader->store ), &iter, NULL, row )){
+		gtk_tree_model_get( GTK_TREE_MODEL( loader->store ), &iter, ICON_LOADER_LABEL_COLUMN, &name, -1 );
+		error = NULL;
+		pixbuf = gtk_icon_theme_load_icon(
+				gtk_icon_theme_get_default(), name, loader->size, GTK_ICON_LOOKUP_GENERIC_FALLBACK, &error );
+		if( error ){
+			g_warning( "%s: %s", thisfn, error->message );
+			g_error_free( error );
+		} else {
+			gtk_list_store_set( loader->store, &iter, ICON_LOADER_PIXBUF_COLUMN, pixbuf, -1 );
+			g_object_unref( pixbuf );
+		}
+		g_free( name );
+	}
+}
+
+/*
+ * run on a worker thread
+ * only decodes the image file, and hands the pixbuf back to the main loop
+ */
+static void
+load_job( sLoaderJob *job, void *empty )
+{
+	static const gchar *thisfn = "fma_icon_loader_load_job";
+	GError *error;
+
+	error = NULL;
+	job->pixbuf = gdk_pixbuf_new_from_file_at_size( job->filename, job->size, job->size, &error );
+	if( error ){
+		g_warning( "%s: %s", thisfn, error->message );
+		g_error_free( error );
+	}
+
+	g_idle_add(( GSourceFunc ) on_job_done, job );
+}
+
+static gboolean
+on_job_done( sLoaderJob *job )
+{
+	sLoader *loader;
+
+	loader = job->loader;
+	loader->status[job->row] = ROW_DONE;
+	loader->in_flight -= 1;
+
+	if( job->pixbuf ){
+		set_row_pixbuf( loader, job->row, job->pixbuf );
+		g_object_unref( job->pixbuf );
+	}
+
+	feed( loader );
+	loader_unref( loader );
+
+	g_free( job->filename );
+	g_free( job );
+
+	return( FALSE );
+}
+
+static void
+set_row_pixbuf( sLoader *loader, guint row, GdkPixbuf *pixbuf )
+{
+	GtkTreeIter iter;
+
+	if( gtk_tree_model_iter_nth_child( GTK_TREE_MODEL( loader->store ), &iter, NULL, row )){
+		gtk_list_store_set( loader->store, &iter, ICON_LOADER_PIXBUF_COLUMN, pixbuf, -1 );
+	}
+}
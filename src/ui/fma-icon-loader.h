@@ -0,0 +1,68 @@
+/*
+ * Nautilus Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __UI_FMA_ICON_LOADER_H__
+#define __UI_FMA_ICON_LOADER_H__
+
+/**
+ * SECTION: fma-icon-loader
+ * @title: FMAIconLoader
+ * @short_description: Background loading of the themed icons
+ * @include: ui/fma-icon-loader.h
+ *
+ * The icon loader provides the list stores displayed by the
+ * #FMAIconChooser dialog, one per theme context.
+ *
+ * The names of the icons are available as soon as the store is
+ * returned; the pixbufs are rendered later by a worker thread, the
+ * visible rows being loaded first.
+ *
+ * The stores are cached for the life of the program, per icon theme,
+ * context and size. The cache is cleared when the icon theme changes.
+ */
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/* column ordering in the icon stores
+ */
+enum {
+	ICON_LOADER_LABEL_COLUMN = 0,
+	ICON_LOADER_PIXBUF_COLUMN,
+	ICON_LOADER_N_COLUMN
+};
+
+GtkListStore *fma_icon_loader_get_store  ( const gchar *context, gint size );
+
+void          fma_icon_loader_set_visible( GtkListStore *store, gint first, gint last );
+
+G_END_DECLS
+
+#endif /* __UI_FMA_ICON_LOADER_H__ */
@@ -56,7 +56,11 @@ static gchar *st_save_warning     = N_( "Some items may not have been saved" );
 static gchar *st_level_zero_write = N_( "Unable to rewrite the level-zero items list" );
 static gchar *st_delete_error     = N_( "Some items have not been deleted" );
 
-static gboolean save_item( FMAMainWindow *window, FMAUpdater *updater, FMAObjectItem *item, GSList **messages );
+static void     collect_modified_rec( GList *items, GList **modified );
+static void     after_write( FMAMainWindow *window, GList *modified, GList *unsaved, GList *failed, GHashTable *written );
+static GList   *patch_pivot( FMAPivot *pivot, GList *items, GHashTable *written );
+static void     collect_pivot_rec( GList *tree, GHashTable *nodes );
+static FMAObjectItem *patch_origin_rec( FMAObjectItem *item, FMAObjectItem *parent, GHashTable *nodes, GHashTable *claimed, GHashTable *written );
 static void     install_autosave( FMAMainWindow *main_window );
 static void     on_autosave_prefs_changed( const gchar *group, const gchar *key, gconstpointer new_value, gpointer user_data );
 static void     on_autosave_prefs_timeout( FMAMainWindow *main_window );
@@ -208,8 +212,10 @@ fma_menu_file_new_profile( FMAMainWindow *main_window )
  *
  * Synopsis:
  * - rewrite the level-zero items list
- * - delete the items which are marked to be deleted
- * - rewrite (i.e. delete/write) updated items
+ * - collect the items which are marked to be deleted, and the modified
+ *   items
+ * - hand them to the I/O providers, as one batch per provider
+ * - patch the tree of the #FMAPivot with the written items
  *
  * The difficulty here is that some sort of pseudo-transactionnal process
  * must be setup:
@@ -218,14 +224,19 @@ fma_menu_file_new_profile( FMAMainWindow *main_window )
  *   is displayed, and we abort the whole processus
  *
  * - if some items cannot be actually deleted, then an error message is
- *   displayed, and the whole processus is aborted;
+ *   displayed;
  *   plus:
  *   a/ items which have not been deleted must be restored (maybe marked
  *      as deleted ?) -> so these items are modified
  *   b/ the level-zero list must be updated with these restored items
  *      and reset modified
  *
- * - idem if some items cannot be actually rewritten...
+ * - items which cannot be actually written are left modified, so that
+ *   they will be written again at next save.
+ *
+ * Only the written items are duplicated to the #FMAPivot tree: other
+ * items keep their current origin, so that saving one item does not
+ * cost a copy of the whole tree.
  */
 void
 fma_menu_file_save_items( FMAMainWindow *window )
@@ -234,8 +245,8 @@ fma_menu_file_save_items( FMAMainWindow *window )
 	sMenuData *sdata;
 	FMATreeView *items_view;
 	GList *items, *it;
-	GList *new_pivot;
-	FMAObjectItem *duplicate;
+	GList *deleted, *modified, *unsaved, *failed, *not_deleted;
+	GHashTable *written;
 	GSList *messages;
 	gchar *msg;
 
@@ -268,11 +279,39 @@ fma_menu_file_save_items( FMAMainWindow *window )
 		g_signal_emit_by_name( items_view, TREE_SIGNAL_LEVEL_ZERO_CHANGED, FALSE );
 	}
 
-	/* remove deleted items
-	 * so that new actions with same id do not risk to be deleted later
-	 * not deleted items are reinserted in the tree
+	/* collect the deleted and the modified items, and hand them to the
+	 * I/O providers: deleted items are removed first, so that new actions
+	 * with same id do not risk to be deleted later
+	 * check is useless here if item was not modified, but not very costly;
+	 * above all, it is less costly to check the status here, than to check
+	 * recursively each and every modified item
+	 */
+	deleted = fma_tree_ieditable_get_deleted( FMA_TREE_IEDITABLE( items_view ));
+	modified = NULL;
+	collect_modified_rec( items, &modified );
+	modified = g_list_reverse( modified );
+	failed = NULL;
+
+	unsaved = NULL;
+	for( it = modified ; it ; it = it->next ){
+		if( !fma_object_get_provider( it->data )){
+			unsaved = g_list_prepend( unsaved, it->data );
+		}
+	}
+
+	fma_updater_write_items( sdata->updater, modified, deleted, &failed, &messages );
+
+	/* not deleted items are reinserted in the tree
 	 */
-	if( !fma_tree_ieditable_remove_deleted( FMA_TREE_IEDITABLE( items_view ), &messages )){
+	not_deleted = NULL;
+	for( it = deleted ; it ; it = it->next ){
+		if( g_list_find( failed, it->data )){
+			not_deleted = g_list_prepend( not_deleted, it->data );
+		}
+	}
+	not_deleted = g_list_reverse( not_deleted );
+
+	if( not_deleted ){
 		if( g_slist_length( messages )){
 			msg = fma_core_utils_slist_join_at_end( messages, "\n" );
 		} else {
@@ -282,26 +321,11 @@ fma_menu_file_save_items( FMAMainWindow *window )
 		g_free( msg );
 		fma_core_utils_slist_free( messages );
 		messages = NULL;
-
-	} else {
-		fma_object_free_items( items );
-		items = fma_tree_view_get_items( items_view );
 	}
 
-	/* recursively save the modified items
-	 * check is useless here if item was not modified, but not very costly;
-	 * above all, it is less costly to check the status here, than to check
-	 * recursively each and every modified item
-	 */
-	new_pivot = NULL;
-
-	for( it = items ; it ; it = it->next ){
-		save_item( window, sdata->updater, FMA_OBJECT_ITEM( it->data ), &messages );
-		duplicate = FMA_OBJECT_ITEM( fma_object_duplicate( it->data, FMA_DUPLICATE_REC ));
-		fma_object_reset_origin( it->data, duplicate );
-		fma_object_check_status( it->data );
-		new_pivot = g_list_prepend( new_pivot, duplicate );
-	}
+	fma_tree_ieditable_clear_deleted( FMA_TREE_IEDITABLE( items_view ), not_deleted );
+	g_list_free( not_deleted );
+	fma_object_free_items( deleted );
 
 	if( g_slist_length( messages )){
 		msg = fma_core_utils_slist_join_at_end( messages, "\n" );
@@ -311,65 +335,212 @@ fma_menu_file_save_items( FMAMainWindow *window )
 		messages = NULL;
 	}
 
-	fma_pivot_set_new_items( FMA_PIVOT( sdata->updater ), g_list_reverse( new_pivot ));
+	written = g_hash_table_new( g_direct_hash, g_direct_equal );
+	after_write( window, modified, unsaved, failed, written );
+	g_list_free( modified );
+	g_list_free( unsaved );
+	g_list_free( failed );
+
+	fma_object_free_items( items );
+	items = fma_tree_view_get_items( items_view );
+
+	fma_pivot_set_new_items( FMA_PIVOT( sdata->updater ), patch_pivot( FMA_PIVOT( sdata->updater ), items, written ));
+	g_hash_table_destroy( written );
+
+	for( it = items ; it ; it = it->next ){
+		fma_object_check_status( it->data );
+	}
+
 	fma_object_free_items( items );
 	fma_main_window_block_reload( window );
 	g_signal_emit_by_name( items_view, TREE_SIGNAL_MODIFIED_STATUS_CHANGED, FALSE );
 }
 
 /*
- * iterates here on each and every FMAObjectItem row stored in the tree
+ * iterates here on each and every FMAObjectItem row stored in the tree,
+ * collecting the modified ones, children first
  */
-static gboolean
-save_item( FMAMainWindow *window, FMAUpdater *updater, FMAObjectItem *item, GSList **messages )
+static void
+collect_modified_rec( GList *items, GList **modified )
 {
-	static const gchar *thisfn = "fma_menu_file_save_item";
-	gboolean ret;
-	FMAIOProvider *provider_before;
-	FMAIOProvider *provider_after;
-	GList *subitems, *it;
+	static const gchar *thisfn = "fma_menu_file_collect_modified_rec";
+	GList *it;
+	FMAObjectItem *item;
 	gchar *label;
-	guint save_ret;
 
-	g_return_val_if_fail( FMA_IS_MAIN_WINDOW( window ), FALSE );
-	g_return_val_if_fail( FMA_IS_UPDATER( updater ), FALSE );
-	g_return_val_if_fail( FMA_IS_OBJECT_ITEM( item ), FALSE );
+	for( it = items ; it ; it = it->next ){
+		item = FMA_OBJECT_ITEM( it->data );
 
-	ret = TRUE;
+		if( FMA_IS_OBJECT_MENU( item )){
+			collect_modified_rec( fma_object_get_items( item ), modified );
+		}
 
-	if( FMA_IS_OBJECT_MENU( item )){
-		subitems = fma_object_get_items( item );
-		for( it = subitems ; it ; it = it->next ){
-			ret &= save_item( window, updater, FMA_OBJECT_ITEM( it->data ), messages );
+		if( fma_object_is_modified( item )){
+			label = fma_object_get_label( item );
+			g_debug( "%s: saving %p (%s) '%s'", thisfn, ( void * ) item, G_OBJECT_TYPE_NAME( item ), label );
+			g_free( label );
+
+			*modified = g_list_prepend( *modified, item );
 		}
 	}
+}
 
-	provider_before = fma_object_get_provider( item );
+/*
+ * the items which have been successfully written are recorded in the
+ * 'written' set; the display is updated if a not yet saved item has got
+ * its I/O provider
+ */
+static void
+after_write( FMAMainWindow *window, GList *modified, GList *unsaved, GList *failed, GHashTable *written )
+{
+	static const gchar *thisfn = "fma_menu_file_after_write";
+	GList *it;
+	FMAObjectItem *item;
+
+	for( it = modified ; it ; it = it->next ){
+		item = FMA_OBJECT_ITEM( it->data );
 
-	if( fma_object_is_modified( item )){
-		label = fma_object_get_label( item );
-		g_debug( "%s: saving %p (%s) '%s'", thisfn, ( void * ) item, G_OBJECT_TYPE_NAME( item ), label );
-		g_free( label );
+		if( g_list_find( failed, item )){
+			g_warning( "%s: unable to write item %p (%s)", thisfn, ( void * ) item, G_OBJECT_TYPE_NAME( item ));
 
-		save_ret = fma_updater_write_item( updater, item, messages );
-		ret = ( save_ret == IIO_PROVIDER_CODE_OK );
+		} else {
+			g_hash_table_add( written, item );
 
-		if( ret ){
 			if( FMA_IS_OBJECT_ACTION( item )){
 				fma_object_reset_last_allocated( item );
 			}
 
-			provider_after = fma_object_get_provider( item );
-			if( provider_after != provider_before ){
+			if( g_list_find( unsaved, item )){
 				g_signal_emit_by_name( window, MAIN_SIGNAL_ITEM_UPDATED, item, MAIN_DATA_PROVIDER );
 			}
+		}
+	}
+}
+
+/*
+ * builds the new tree of the pivot from the items of the view:
+ * - written items, and items which have no origin in the current tree,
+ *   are duplicated, and become the new origin
+ * - other items keep their current origin, which is moved from the
+ *   current tree to the new one
+ *
+ * The menus of the current tree are first detached from their children,
+ * so that each node is released individually once the new tree is built.
+ */
+static GList *
+patch_pivot( FMAPivot *pivot, GList *items, GHashTable *written )
+{
+	GList *tree, *it, *new_tree;
+	GHashTable *nodes, *claimed;
+	GHashTableIter iter;
+	gpointer node;
+	GList *children;
+
+	tree = fma_pivot_get_items( pivot );
+	nodes = g_hash_table_new( g_direct_hash, g_direct_equal );
+	collect_pivot_rec( tree, nodes );
+
+	g_hash_table_iter_init( &iter, nodes );
+	while( g_hash_table_iter_next( &iter, &node, NULL )){
+		if( FMA_IS_OBJECT_MENU( node )){
+			children = fma_object_get_items( node );
+			fma_object_set_items( node, NULL );
+			g_list_free( children );
+		}
+	}
+
+	claimed = g_hash_table_new( g_direct_hash, g_direct_equal );
+	new_tree = NULL;
+
+	for( it = items ; it ; it = it->next ){
+		new_tree = g_list_prepend( new_tree, patch_origin_rec( FMA_OBJECT_ITEM( it->data ), NULL, nodes, claimed, written ));
+	}
 
+	/* fma_pivot_set_new_items() will release the level-zero nodes of the
+	 * current tree along with their new children: balance it first
+	 */
+	for( it = tree ; it ; it = it->next ){
+		fma_object_ref( it->data );
+	}
+
+	g_hash_table_iter_init( &iter, nodes );
+	while( g_hash_table_iter_next( &iter, &node, NULL )){
+		if( FMA_IS_OBJECT_MENU( node )){
+			g_object_unref( node );
 		} else {
-			g_warning( "%s: unable to write item: save_ret=%d", thisfn, save_ret );
+			fma_object_unref( node );
 		}
 	}
 
-	return( ret );
+	g_hash_table_destroy( claimed );
+	g_hash_table_destroy( nodes );
+
+	return( g_list_reverse( new_tree ));
+}
+
+/*
+ * collects the menus and actions of the current tree of the pivot
+ */
+static void
+collect_pivot_rec( GList *tree, GHashTable *nodes )
+{
+	GList *it;
+
+	for( it = tree ; it ; it = it->next ){
+		g_hash_table_add( nodes, it->data );
+
+		if( FMA_IS_OBJECT_MENU( it->data )){
+			collect_pivot_rec( fma_object_get_items( it->data ), nodes );
+		}
+	}
+}
+
+/*
+ * returns the new origin of the @item, with a new reference on it
+ *
+ * the profiles of an action are always kept with their action, while
+ * the children of a menu are patched in turn
+ */
+static FMAObjectItem *
+patch_origin_rec( FMAObjectItem *item, FMAObjectItem *parent, GHashTable *nodes, GHashTable *claimed, GHashTable *written )
+{
+	FMAObjectItem *origin;
+	GList *children, *it;
+	gboolean reuse;
+
+	origin = ( FMAObjectItem * ) fma_object_get_origin( item );
+	reuse = origin &&
+			g_hash_table_contains( nodes, origin ) &&
+			!g_hash_table_contains( claimed, origin ) &&
+			!g_hash_table_contains( written, item );
+
+	if( FMA_IS_OBJECT_MENU( item )){
+		if( reuse ){
+			g_object_ref( origin );
+		} else {
+			origin = FMA_OBJECT_ITEM( fma_object_duplicate( item, FMA_DUPLICATE_ONLY ));
+			fma_object_set_origin( item, origin );
+			fma_object_set_origin( origin, NULL );
+		}
+
+		children = NULL;
+		for( it = fma_object_get_items( item ) ; it ; it = it->next ){
+			children = g_list_prepend( children, patch_origin_rec( FMA_OBJECT_ITEM( it->data ), origin, nodes, claimed, written ));
+		}
+		fma_object_set_items( origin, g_list_reverse( children ));
+
+	} else if( reuse ){
+		fma_object_ref( origin );
+
+	} else {
+		origin = FMA_OBJECT_ITEM( fma_object_duplicate( item, FMA_DUPLICATE_REC ));
+		fma_object_reset_origin( item, origin );
+	}
+
+	g_hash_table_add( claimed, origin );
+	fma_object_set_parent( origin, parent );
+
+	return( origin );
 }
 
 /*
@@ -549,59 +549,46 @@ decrement_counters( FMATreeIEditable *view, IEditableData *ied, GList *items )
 }
 
 /**
- * fma_tree_ieditable_remove_deleted:
+ * fma_tree_ieditable_clear_deleted:
  * @instance: this #FMATreeIEditable *instance.
- * @messages: a pointer to a #GSList of error messages.
+ * @not_deleted: the list of the items which have not been actually
+ *  deleted from the underlying I/O storage subsystem.
  *
- * Actually removes the deleted items from the underlying I/O storage subsystem.
+ * Clears the 'deleted' list once the deleted items have been handed
+ * to the I/O providers.
  *
- * @messages #GSList is only filled up in case of an error has occured.
- * If there is no error (fma_tree_ieditable_remove_deleted() returns %TRUE),
- * then the caller may safely assume that @messages is returned in the
- * same state that it has been provided.
- *
- * Returns: %TRUE if all candidate items have been successfully deleted,
- * %FALSE else.
+ * The items which have not been deleted are reinserted in the tree view.
  */
-gboolean
-fma_tree_ieditable_remove_deleted( FMATreeIEditable *instance, GSList **messages )
+void
+fma_tree_ieditable_clear_deleted( FMATreeIEditable *instance, GList *not_deleted )
 {
-	static const gchar *thisfn = "fma_tree_ieditable_remove_deleted";
-	gboolean delete_ok;
+	static const gchar *thisfn = "fma_tree_ieditable_clear_deleted";
 	IEditableData *ied;
-	GList *it;
-	FMAObjectItem *item;
-	GList *not_deleted;
+	GList *it, *reinserted;
 
-	g_return_val_if_fail( FMA_IS_TREE_IEDITABLE( instance ), TRUE );
-
-	delete_ok = TRUE;
-	ied = get_instance_data( instance );
-	not_deleted = NULL;
+	g_return_if_fail( FMA_IS_TREE_IEDITABLE( instance ));
 
-	for( it = ied->deleted ; it ; it = it->next ){
-		item = FMA_OBJECT_ITEM( it->data );
-		g_debug( "%s: item=%p (%s)", thisfn, ( void * ) item, G_OBJECT_TYPE_NAME( item ));
-		fma_object_dump_norec( item );
+	g_debug( "%s: instance=%p, not_deleted=%p (count=%d)",
+			thisfn, ( void * ) instance, ( void * ) not_deleted, g_list_length( not_deleted ));
 
-		if( fma_updater_delete_item( ied->updater, item, messages ) != IIO_PROVIDER_CODE_OK ){
-			not_deleted = g_list_prepend( not_deleted, fma_object_ref( item ));
-			delete_ok = FALSE;
-		}
-	}
-
-	ied->deleted = fma_object_free_items( ied->deleted );
+	ied = get_instance_data( instance );
 
 	/* items that we cannot delete are reinserted in the tree view
 	 * in the state they were when they were deleted
 	 * (i.e. possibly modified)
 	 */
-	if( not_deleted ){
-		fma_tree_ieditable_insert_items( instance, not_deleted, NULL );
-		fma_object_free_items( not_deleted );
+	reinserted = NULL;
+	for( it = not_deleted ; it ; it = it->next ){
+		reinserted = g_list_prepend( reinserted, fma_object_ref( it->data ));
 	}
 
-	return( delete_ok );
+	ied->deleted = fma_object_free_items( ied->deleted );
+
+	if( reinserted ){
+		reinserted = g_list_reverse( reinserted );
+		fma_tree_ieditable_insert_items( instance, reinserted, NULL );
+		fma_object_free_items( reinserted );
+	}
 }
 
 /**
@@ -88,8 +88,8 @@ void     fma_tree_ieditable_delete                ( FMATreeIEditable *instance,
 															GList *items,
 															TreeIEditableDeleteOpe ope );
 
-gboolean fma_tree_ieditable_remove_deleted        ( FMATreeIEditable *instance,
-															GSList **messages );
+void     fma_tree_ieditable_clear_deleted         ( FMATreeIEditable *instance,
+															GList *not_deleted );
 
 GList   *fma_tree_ieditable_get_deleted           ( FMATreeIEditable *instance );
 
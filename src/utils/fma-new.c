@@ -94,6 +94,7 @@ static gboolean   output_stdout    = FALSE;
 static gboolean   output_desktop   = FALSE;
 /* misc entries */
 static gboolean   version          = FALSE;
+static gboolean   force_migration  = FALSE;
 
 extern FMADataGroup action_data_groups[];			/* defined in fma-object-action-factory.c */
 extern FMADataGroup profile_data_groups[];			/* defined in fma-object-profile-factory.c */
@@ -155,6 +156,8 @@ static GOptionEntry misc_entries[] = {
 
 	{ "version"              , 'v', 0, G_OPTION_ARG_NONE        , &version,
 			N_( "Output the version number" ), NULL },
+	{ "force-migration"      ,  0 , 0, G_OPTION_ARG_NONE        , &force_migration,
+			N_( "Run the GConf migration, even if it has already been done" ), NULL },
 	{ NULL }
 };
 
@@ -187,12 +190,6 @@ main( int argc, char** argv )
 	setlocale( LC_ALL, "" );
 	console_init_log_handler();
 
-	/* pwi 2011-01-05
-	 * run GConf migration tools before doing anything else
-	 * above all before allocating a new FMAPivot
-	 */
-	fma_gconf_migration_run();
-
 	context = init_options();
 
 	if( argc == 1 ){
@@ -214,6 +211,17 @@ main( int argc, char** argv )
 		exit( status );
 	}
 
+	/* pwi 2011-01-05
+	 * run GConf migration tools before doing anything else
+	 * above all before allocating a new FMAPivot
+	 */
+	if( force_migration ){
+		fma_gconf_migration_force();
+
+	} else {
+		fma_gconf_migration_run();
+	}
+
 	errors = 0;
 
 	if( !label || !g_utf8_strlen( label, -1 )){
@@ -33,6 +33,7 @@
 
 #include <glib.h>
 #include <glib/gi18n.h>
+#include <gtk/gtk.h>
 #include <locale.h>
 #include <stdlib.h>
 #include <string.h>
@@ -42,16 +43,50 @@
 #include <api/fma-dbus.h>
 
 #include <core/fma-gconf-migration.h>
+#include <core/fma-job-runner.h>
 #include <core/fma-pivot.h>
 #include <core/fma-selected-info.h>
+#include <core/fma-settings.h>
 #include <core/fma-tokens.h>
 
 #include "console-utils.h"
 #include "fma-run-bindings.h"
 
+/* the session service which keeps the items loaded between two runs
+ */
+#define FMA_RUN_DBUS_SERVICE			"org.filemanager-actions.Run"
+#define FMA_RUN_DBUS_PATH				"/org/filemanager_actions/Run"
+#define FMA_RUN_DBUS_IFACE				"org.filemanager_actions.DBus.Run1"
+
+/* the service only has to spawn the commands: do not let a stalled
+ * service block the caller for the default D-Bus timeout
+ */
+#define FMA_RUN_DBUS_TIMEOUT			25000
+
+static const gchar st_introspection_xml[] =
+	"<node>"
+	"  <interface name='" FMA_RUN_DBUS_IFACE "'>"
+	"    <method name='RunAction'>"
+	"      <arg type='s' name='id' direction='in'/>"
+	"      <arg type='as' name='uris' direction='in'/>"
+	"      <arg type='as' name='mimetypes' direction='in'/>"
+	"      <arg type='s' name='cwd' direction='in'/>"
+	"      <arg type='as' name='environ' direction='in'/>"
+	"      <arg type='b' name='success' direction='out'/>"
+	"      <arg type='s' name='message' direction='out'/>"
+	"    </method>"
+	"  </interface>"
+	"</node>";
+
 static gchar     *id               = "";
 static gchar    **targets_array    = NULL;
+static gboolean   service          = FALSE;
+static gboolean   no_service       = FALSE;
 static gboolean   version          = FALSE;
+static gboolean   force_migration  = FALSE;
+
+static FMAPivot  *st_pivot         = NULL;			/* when run as a session service */
+static guint      st_reload_id     = 0;
 
 static GOptionEntry entries[] = {
 
@@ -59,6 +94,10 @@ static GOptionEntry entries[] = {
 			N_( "The internal identifier of the action to be launched" ), N_( "<STRING>" ) },
 	{ "target"               , 't', 0, G_OPTION_ARG_FILENAME_ARRAY, &targets_array,
 			N_( "A target, file or folder, for the action. More than one target may be specified" ), N_( "<URI>" ) },
+	{ "service"              , 's', 0, G_OPTION_ARG_NONE          , &service,
+			N_( "Run as a session service which keeps the actions loaded, and executes them on behalf of next invocations" ), NULL },
+	{ "no-service"           , 'n', 0, G_OPTION_ARG_NONE          , &no_service,
+			N_( "Do not try to execute the action through the session service" ), NULL },
 	{ NULL }
 };
 
@@ -66,18 +105,32 @@ static GOptionEntry misc_entries[] = {
 
 	{ "version"              , 'v', 0, G_OPTION_ARG_NONE        , &version,
 			N_( "Output the version number" ), NULL },
+	{ "force-migration"      ,  0 , 0, G_OPTION_ARG_NONE        , &force_migration,
+			N_( "Run the GConf migration, even if it has already been done" ), NULL },
 	{ NULL }
 };
 
-static GOptionContext  *init_options( void );
-static FMAObjectAction  *get_action( const gchar *id );
-static GList           *targets_from_selection( void );
-static GList           *targets_from_commandline( void );
-static GList           *get_selection_from_strv( const gchar **strv, gboolean has_mimetype );
+static GOptionContext   *init_options( void );
+static void              run_migration( void );
+static FMAPivot         *pivot_new( void );
+static gboolean          run_action( FMAPivot *pivot, const gchar *id, gchar **uris, gchar **mimetypes, const gchar *cwd, gchar **envp, gchar **message );
+static FMAObjectAction  *get_action( FMAPivot *pivot, const gchar *id, gchar **message );
+static gchar           **targets_from_args( gchar **args );
+static gchar           **targets_from_selection( gchar ***mimetypes );
+static void              split_selected_paths( gchar **paths, gchar ***uris, gchar ***mimetypes );
+static GList            *get_selection( gchar **uris, gchar **mimetypes );
 static FMAObjectProfile *get_profile_for_targets( FMAObjectAction *action, GList *targets );
-static void             execute_action( FMAObjectAction *action, FMAObjectProfile *profile, GList *targets );
-static void             dump_targets( GList *targets );
-static void             exit_with_usage( void );
+static void              execute_action( FMAObjectAction *action, FMAObjectProfile *profile, GList *targets, const gchar *cwd, gchar **envp );
+static gboolean          run_remote( const gchar *id, gchar **uris, gchar **mimetypes, gboolean *success );
+static void              run_service( void );
+static void              on_bus_acquired( GDBusConnection *connection, const gchar *name, GMainLoop *loop );
+static void              on_name_lost( GDBusConnection *connection, const gchar *name, GMainLoop *loop );
+static void              on_method_call( GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *parameters, GDBusMethodInvocation *invocation, void *empty );
+static void              on_pivot_items_changed( FMAPivot *pivot, void *empty );
+static void              on_settings_key_changed( const gchar *group, const gchar *key, gconstpointer new_value, gboolean mandatory, void *empty );
+static gboolean          on_settings_reload_idle( void *empty );
+static void              dump_targets( GList *targets );
+static void              exit_with_usage( void );
 
 int
 main( int argc, char** argv )
@@ -88,9 +141,10 @@ main( int argc, char** argv )
 	GError *error = NULL;
 	gchar *help;
 	gint errors;
-	FMAObjectAction *action;
-	FMAObjectProfile *profile;
-	GList *targets;
+	gchar **uris, **mimetypes;
+	gchar *message;
+	gboolean success;
+	FMAPivot *pivot;
 
 #if !GLIB_CHECK_VERSION( 2,36, 0 )
 	g_type_init();
@@ -99,12 +153,6 @@ main( int argc, char** argv )
 	setlocale( LC_ALL, "" );
 	console_init_log_handler();
 
-	/* pwi 2011-01-05
-	 * run GConf migration tools before doing anything else
-	 * above all before allocating a new FMAPivot
-	 */
-	fma_gconf_migration_run();
-
 	context = init_options();
 
 	if( argc == 1 ){
@@ -128,6 +176,11 @@ main( int argc, char** argv )
 		exit( status );
 	}
 
+	if( service ){
+		run_service();
+		exit( status );
+	}
+
 	errors = 0;
 
 	if( !id || !strlen( id )){
@@ -135,46 +188,58 @@ main( int argc, char** argv )
 		errors += 1;
 	}
 
-	action = get_action( id );
-	if( !action ){
-		errors += 1;
-	} else {
-		g_debug( "%s: action %s have been found, and is enabled and valid", thisfn, id );
-	}
-
 	if( errors ){
 		exit_with_usage();
 	}
 
+	mimetypes = NULL;
+
 	if( targets_array ){
-		targets = targets_from_commandline();
+		uris = targets_from_args( targets_array );
 
 	} else {
-		targets = targets_from_selection();
+		uris = targets_from_selection( &mimetypes );
 	}
 
-	dump_targets( targets );
+	/* the session service, when it runs, already has the items loaded
+	 */
+	if( !no_service && run_remote( id, uris, mimetypes, &success )){
+		g_debug( "%s: action %s executed by the session service", thisfn, id );
 
-	if( g_list_length( targets ) == 0 ){
-		g_print( _( "No current selection. Nothing to do. Exiting.\n" ));
-		exit( status );
-	}
+	} else {
+		/* pwi 2011-01-05
+		 * run GConf migration tools before doing anything else
+		 * above all before allocating a new FMAPivot
+		 */
+		run_migration();
+
+		pivot = pivot_new();
+		message = NULL;
+		success = run_action( pivot, id, uris, mimetypes, NULL, NULL, &message );
+
+		if( message ){
+			if( success ){
+				g_print( "%s\n", message );
+			} else {
+				g_printerr( "%s\n", message );
+			}
+			g_free( message );
+		}
 
-	if( !fma_icontext_is_candidate( FMA_ICONTEXT( action ), ITEM_TARGET_ANY, targets )){
-		g_printerr( _( "Action %s is not a valid candidate. Exiting.\n" ), id );
-		exit( status );
+		/* commands which exceed the count of parallel executions are queued:
+		 * spawn them all before exiting
+		 */
+		fma_job_runner_wait_pending( fma_job_runner_get_default());
+		g_object_unref( pivot );
 	}
 
-	profile = get_profile_for_targets( action, targets );
-	if( !profile ){
-		g_print( _( "No valid profile is candidate to execution. Exiting.\n" ));
-		exit( status );
-	}
-	g_debug( "%s: profile %p found", thisfn, ( void * ) profile );
+	g_strfreev( mimetypes );
+	g_strfreev( uris );
 
-	execute_action( action, profile, targets );
+	if( !success ){
+		exit_with_usage();
+	}
 
-	fma_selected_info_free_list( targets );
 	exit( status );
 }
 
@@ -215,54 +280,145 @@ init_options( void )
 	return( context );
 }
 
-/*
- * search for the action in the repository
- */
-static FMAObjectAction *
-get_action( const gchar *id )
+static void
+run_migration( void )
 {
-	FMAPivot *pivot;
-	FMAObjectAction *action;
+	if( force_migration ){
+		fma_gconf_migration_force();
 
-	action = NULL;
+	} else {
+		fma_gconf_migration_run();
+	}
+}
+
+static FMAPivot *
+pivot_new( void )
+{
+	FMAPivot *pivot;
 
 	pivot = fma_pivot_new();
 	fma_pivot_set_loadable( pivot, !PIVOT_LOAD_DISABLED & !PIVOT_LOAD_INVALID );
+	fma_pivot_set_cacheable( pivot, TRUE );
 	fma_pivot_load_items( pivot );
 
-	action = ( FMAObjectAction * ) fma_pivot_get_item( pivot, id );
+	return( pivot );
+}
+
+/*
+ * executes the action on the targets; this is the same code whether we
+ * are run as a one-shot program or as the session service
+ *
+ * @cwd and @envp are the execution context of the caller when we are
+ * run as the session service, %NULL else.
+ *
+ * Returns: %FALSE if the action cannot be run, %TRUE else; @message is
+ * set to an informational or error message to be displayed to the user.
+ */
+static gboolean
+run_action( FMAPivot *pivot, const gchar *id, gchar **uris, gchar **mimetypes, const gchar *cwd, gchar **envp, gchar **message )
+{
+	static const gchar *thisfn = "nautilus_actions_run_run_action";
+	FMAObjectAction *action;
+	FMAObjectProfile *profile;
+	GList *targets;
 
+	action = get_action( pivot, id, message );
 	if( !action ){
-		g_printerr( _( "Error: action “%s” doesn’t exist.\n" ), id );
+		return( FALSE );
+	}
+	g_debug( "%s: action %s have been found, and is enabled and valid", thisfn, id );
+
+	targets = get_selection( uris, mimetypes );
+
+	if( !service ){
+		dump_targets( targets );
+	}
+
+	if( g_list_length( targets ) == 0 ){
+		*message = g_strdup( _( "No current selection. Nothing to do. Exiting." ));
+
+	} else if( !fma_icontext_is_candidate( FMA_ICONTEXT( action ), ITEM_TARGET_ANY, targets )){
+		*message = g_strdup_printf( _( "Action %s is not a valid candidate. Exiting." ), id );
 
 	} else {
-		if( !fma_object_is_enabled( action )){
-			g_printerr( _( "Error: action “%s” is disabled.\n" ), id );
-			g_object_unref( action );
-			action = NULL;
-		}
-		if( !fma_object_is_valid( action )){
-			g_printerr( _( "Error: action “%s” is not valid.\n" ), id );
-			g_object_unref( action );
-			action = NULL;
+		profile = get_profile_for_targets( action, targets );
+
+		if( !profile ){
+			*message = g_strdup( _( "No valid profile is candidate to execution. Exiting." ));
+
+		} else {
+			g_debug( "%s: profile %p found", thisfn, ( void * ) profile );
+			execute_action( action, profile, targets, cwd, envp );
 		}
 	}
 
+	fma_selected_info_free_list( targets );
+
+	return( TRUE );
+}
+
+/*
+ * search for the action in the repository
+ */
+static FMAObjectAction *
+get_action( FMAPivot *pivot, const gchar *id, gchar **message )
+{
+	FMAObjectAction *action;
+
+	action = ( FMAObjectAction * ) fma_pivot_get_item( pivot, id );
+
+	if( !action ){
+		*message = g_strdup_printf( _( "Error: action “%s” doesn’t exist." ), id );
+
+	} else if( !fma_object_is_enabled( action )){
+		*message = g_strdup_printf( _( "Error: action “%s” is disabled." ), id );
+		action = NULL;
+
+	} else if( !fma_object_is_valid( action )){
+		*message = g_strdup_printf( _( "Error: action “%s” is not valid." ), id );
+		action = NULL;
+	}
+
 	return( action );
 }
 
+/*
+ * the targets given on the command-line may be relative paths: make
+ * them absolute URIs, so that they are not resolved against the working
+ * directory of the session service
+ */
+static gchar **
+targets_from_args( gchar **args )
+{
+	gchar **uris;
+	GFile *file;
+	guint count, i;
+
+	count = g_strv_length( args );
+	uris = g_new0( gchar *, count+1 );
+
+	for( i = 0 ; i < count ; ++i ){
+		file = g_file_new_for_commandline_arg( args[i] );
+		uris[i] = g_file_get_uri( file );
+		g_object_unref( file );
+	}
+
+	return( uris );
+}
+
 /*
  * the DBus.Tracker.Properties1 interface returns a list of strings
  * where each selected item brings up both its URI and its Nautilus
  * mime type.
  *
- * We return to the caller a GList of FMASelectedInfo objects
+ * We return to the caller a newly allocated array of URIs, and set
+ * @mimetypes to the corresponding newly allocated array of mimetypes.
  */
-static GList *
-targets_from_selection( void )
+static gchar **
+targets_from_selection( gchar ***mimetypes )
 {
 	static const gchar *thisfn = "nautilus_actions_run_targets_from_selection";
-	GList *selection;
+	gchar **uris;
 	GError *error;
 	gchar **paths;
 	GDBusObjectManager *manager;
@@ -272,7 +428,7 @@ targets_from_selection( void )
 
 	g_debug( "%s", thisfn );
 
-	selection = NULL;
+	uris = NULL;
 	error = NULL;
 	paths = NULL;
 
@@ -318,64 +474,78 @@ targets_from_selection( void )
 			NULL,
 			&error );
 
-	selection = get_selection_from_strv(( const gchar ** ) paths, TRUE );
+	if( error ){
+		g_printerr( "%s: unable to get the selected paths: %s\n", thisfn, error->message );
+		g_error_free( error );
+	}
+
+	if( paths ){
+		split_selected_paths( paths, &uris, mimetypes );
+		g_strfreev( paths );
+	}
 
-	g_strfreev( paths );
+	g_object_unref( iface );
+	g_object_unref( object );
+	g_object_unref( manager );
 
-	return( selection );
+	return( uris );
 }
 
 /*
- * get targets from command-line
- *
- * We return to the caller a GList of FMASelectedInfo objects.
+ * the selected paths are a list of URI and mimetype pairs
  */
-static GList *
-targets_from_commandline( void )
+static void
+split_selected_paths( gchar **paths, gchar ***uris, gchar ***mimetypes )
 {
-	static const gchar *thisfn = "nautilus_actions_run_targets_from_commandline";
-	GList *targets;
-
-	g_debug( "%s", thisfn );
+	guint count, i;
 
-	targets = get_selection_from_strv(( const gchar ** ) targets_array, FALSE );
+	count = g_strv_length( paths ) / 2;
+	*uris = g_new0( gchar *, count+1 );
+	*mimetypes = g_new0( gchar *, count+1 );
 
-	return( targets );
+	for( i = 0 ; i < count ; ++i ){
+		( *uris )[i] = g_strdup( paths[2*i] );
+		( *mimetypes )[i] = g_strdup( paths[2*i+1] );
+	}
 }
 
+/*
+ * We return to the caller a GList of FMASelectedInfo objects.
+ * @mimetypes may be %NULL or empty, else it has as many elements as @uris.
+ */
 static GList *
-get_selection_from_strv( const gchar **strv, gboolean has_mimetype )
+get_selection( gchar **uris, gchar **mimetypes )
 {
 	GList *list;
+	GList *uris_list, *mimetypes_list;
 	gchar **iter;
 	gchar *errmsg;
 
-	list = NULL;
-	iter = ( gchar ** ) strv;
+	uris_list = NULL;
+	mimetypes_list = NULL;
 
-	while( *iter ){
-		const gchar *uri = ( const gchar * ) *iter;
-		const gchar *mimetype = NULL;
-		if( has_mimetype ){
-			iter++;
-			mimetype = ( const gchar * ) *iter;
-		}
+	for( iter = uris ; iter && *iter ; ++iter ){
+		uris_list = g_list_prepend( uris_list, *iter );
+	}
+	for( iter = mimetypes ; iter && *iter ; ++iter ){
+		mimetypes_list = g_list_prepend( mimetypes_list, *iter );
+	}
 
-		errmsg = NULL;
-		FMASelectedInfo *nsi = fma_selected_info_create_for_uri( uri, mimetype, &errmsg );
+	uris_list = g_list_reverse( uris_list );
+	mimetypes_list = g_list_reverse( mimetypes_list );
 
-		if( errmsg ){
-			g_printerr( "%s\n", errmsg );
-			g_free( errmsg );
-		}
+	errmsg = NULL;
+	list = fma_selected_info_create_for_uris( uris_list, mimetypes_list, SELECTED_INFO_ATTR_ALL, &errmsg );
 
-		if( nsi ){
-			list = g_list_prepend( list, nsi );
-		}
-		iter++;
+	if( errmsg ){
+		g_printerr( "%s\n", errmsg );
+		g_free( errmsg );
 	}
 
-	return( g_list_reverse( list ));
+	g_list_free( mimetypes_list );
+	g_list_free( uris_list );
+
+	return( list );
 }
 
 /*
@@ -401,13 +571,259 @@ get_profile_for_targets( FMAObjectAction *action, GList *targets )
 }
 
 static void
-execute_action( FMAObjectAction *action, FMAObjectProfile *profile, GList *targets )
+execute_action( FMAObjectAction *action, FMAObjectProfile *profile, GList *targets, const gchar *cwd, gchar **envp )
 {
 	/*static const gchar *thisfn = "nautilus_action_run_execute_action";*/
 	FMATokens *tokens;
 
 	tokens = fma_tokens_new_from_selection( targets );
+
+	if( cwd || envp ){
+		fma_tokens_set_environment( tokens, cwd, envp );
+	}
 	fma_tokens_execute_action( tokens, profile );
+	g_object_unref( tokens );
+}
+
+/*
+ * ask the session service, if it runs, to execute the action
+ *
+ * Returns: %TRUE if the service has handled the request, setting
+ * @success to its result; %FALSE if the action has to be executed
+ * in-process.
+ */
+static gboolean
+run_remote( const gchar *id, gchar **uris, gchar **mimetypes, gboolean *success )
+{
+	static const gchar *thisfn = "nautilus_actions_run_run_remote";
+	static const gchar *empty[] = { NULL };
+	GDBusConnection *connection;
+	GVariant *result;
+	GError *error;
+	const gchar *message;
+	gchar *cwd;
+	gchar **envp;
+
+	error = NULL;
+	connection = g_bus_get_sync( G_BUS_TYPE_SESSION, NULL, &error );
+
+	if( !connection ){
+		g_debug( "%s: g_bus_get_sync: %s", thisfn, error->message );
+		g_error_free( error );
+		return( FALSE );
+	}
+
+	/* the commands are run in our working directory and with our
+	 * environment, as if they were executed in-process
+	 */
+	cwd = g_get_current_dir();
+	envp = g_get_environ();
+
+	/* do not auto-start the service: the in-process execution is
+	 * cheaper than the service startup
+	 */
+	result = g_dbus_connection_call_sync(
+			connection,
+			FMA_RUN_DBUS_SERVICE,
+			FMA_RUN_DBUS_PATH,
+			FMA_RUN_DBUS_IFACE,
+			"RunAction",
+			g_variant_new( "(s^as^ass^as)", id,
+					uris ? uris : ( gchar ** ) empty, mimetypes ? mimetypes : ( gchar ** ) empty,
+					cwd, envp ),
+			G_VARIANT_TYPE( "(bs)" ),
+			G_DBUS_CALL_FLAGS_NO_AUTO_START,
+			FMA_RUN_DBUS_TIMEOUT,
+			NULL,
+			&error );
+
+	g_strfreev( envp );
+	g_free( cwd );
+	g_object_unref( connection );
+
+	if( !result ){
+		g_debug( "%s: session service not available: %s", thisfn, error->message );
+		g_error_free( error );
+		return( FALSE );
+	}
+
+	g_variant_get( result, "(b&s)", success, &message );
+
+	if( strlen( message )){
+		if( *success ){
+			g_print( "%s\n", message );
+		} else {
+			g_printerr( "%s\n", message );
+		}
+	}
+
+	g_variant_unref( result );
+
+	return( TRUE );
+}
+
+/*
+ * run as a session service
+ *
+ * The items are loaded once, and then reloaded each time the I/O
+ * providers report a modification, or the preferences which drive the
+ * building of the tree are changed.
+ * Commands are run in the working directory and with the environment
+ * of the caller.
+ */
+static void
+run_service( void )
+{
+	static const gchar *thisfn = "nautilus_actions_run_run_service";
+	GMainLoop *loop;
+	guint owner_id;
+
+	g_debug( "%s", thisfn );
+
+	/* needed to display the output of DisplayOutput commands
+	 */
+	gtk_init_check( NULL, NULL );
+
+	run_migration();
+
+	st_pivot = pivot_new();
+	g_signal_connect( st_pivot, PIVOT_SIGNAL_ITEMS_CHANGED, G_CALLBACK( on_pivot_items_changed ), NULL );
+
+	fma_settings_register_key_callback(
+			IPREFS_IO_PROVIDERS_READ_STATUS, G_CALLBACK( on_settings_key_changed ), NULL );
+	fma_settings_register_key_callback(
+			IPREFS_ITEMS_LEVEL_ZERO_ORDER, G_CALLBACK( on_settings_key_changed ), NULL );
+	fma_settings_register_key_callback(
+			IPREFS_ITEMS_LIST_ORDER_MODE, G_CALLBACK( on_settings_key_changed ), NULL );
+
+	loop = g_main_loop_new( NULL, FALSE );
+
+	owner_id = g_bus_own_name(
+			G_BUS_TYPE_SESSION,
+			FMA_RUN_DBUS_SERVICE,
+			G_BUS_NAME_OWNER_FLAGS_NONE,
+			( GBusAcquiredCallback ) on_bus_acquired,
+			NULL,
+			( GBusNameLostCallback ) on_name_lost,
+			loop,
+			NULL );
+
+	g_main_loop_run( loop );
+
+	g_bus_unown_name( owner_id );
+	g_main_loop_unref( loop );
+	g_object_unref( st_pivot );
+	st_pivot = NULL;
+}
+
+static void
+on_bus_acquired( GDBusConnection *connection, const gchar *name, GMainLoop *loop )
+{
+	static const gchar *thisfn = "nautilus_actions_run_on_bus_acquired";
+	static const GDBusInterfaceVTable st_vtable = {
+		( GDBusInterfaceMethodCallFunc ) on_method_call,
+		NULL,
+		NULL
+	};
+	GDBusNodeInfo *node;
+	GError *error;
+
+	g_debug( "%s: name=%s", thisfn, name );
+
+	error = NULL;
+	node = g_dbus_node_info_new_for_xml( st_introspection_xml, &error );
+
+	if( !node ){
+		g_warning( "%s: g_dbus_node_info_new_for_xml: %s", thisfn, error->message );
+		g_error_free( error );
+		g_main_loop_quit( loop );
+		return;
+	}
+
+	if( !g_dbus_connection_register_object(
+			connection, FMA_RUN_DBUS_PATH, node->interfaces[0], &st_vtable, NULL, NULL, &error )){
+
+		g_warning( "%s: g_dbus_connection_register_object: %s", thisfn, error->message );
+		g_error_free( error );
+		g_main_loop_quit( loop );
+	}
+
+	g_dbus_node_info_unref( node );
+}
+
+/*
+ * either another service already runs, or the session bus is not
+ * reachable
+ */
+static void
+on_name_lost( GDBusConnection *connection, const gchar *name, GMainLoop *loop )
+{
+	g_printerr( _( "Error: unable to own the %s name on the session bus.\n" ), name );
+	g_main_loop_quit( loop );
+}
+
+static void
+on_method_call( GDBusConnection *connection, const gchar *sender, const gchar *object_path,
+		const gchar *interface_name, const gchar *method_name, GVariant *parameters,
+		GDBusMethodInvocation *invocation, void *empty )
+{
+	static const gchar *thisfn = "nautilus_actions_run_on_method_call";
+	const gchar *action_id;
+	const gchar **uris, **mimetypes, **envp;
+	const gchar *cwd;
+	gchar *message;
+	gboolean success;
+
+	g_debug( "%s: sender=%s, method=%s", thisfn, sender, method_name );
+
+	if( !strcmp( method_name, "RunAction" )){
+		g_variant_get( parameters, "(&s^a&s^a&s&s^a&s)", &action_id, &uris, &mimetypes, &cwd, &envp );
+
+		message = NULL;
+		success = run_action( st_pivot, action_id, ( gchar ** ) uris, ( gchar ** ) mimetypes,
+				strlen( cwd ) ? cwd : NULL, envp[0] ? ( gchar ** ) envp : NULL, &message );
+
+		g_dbus_method_invocation_return_value( invocation,
+				g_variant_new( "(bs)", success, message ? message : "" ));
+
+		g_free( message );
+		g_free( envp );
+		g_free( mimetypes );
+		g_free( uris );
+	}
+}
+
+static void
+on_pivot_items_changed( FMAPivot *pivot, void *empty )
+{
+	fma_pivot_reload_items( pivot );
+}
+
+/*
+ * several keys are usually changed at once: only reload the items once
+ */
+static void
+on_settings_key_changed( const gchar *group, const gchar *key, gconstpointer new_value, gboolean mandatory, void *empty )
+{
+	static const gchar *thisfn = "nautilus_actions_run_on_settings_key_changed";
+
+	g_debug( "%s: group=%s, key=%s", thisfn, group, key );
+
+	if( !st_reload_id ){
+		st_reload_id = g_idle_add(( GSourceFunc ) on_settings_reload_idle, NULL );
+	}
+}
+
+static gboolean
+on_settings_reload_idle( void *empty )
+{
+	st_reload_id = 0;
+
+	if( st_pivot ){
+		fma_pivot_load_items( st_pivot );
+	}
+
+	return( FALSE );
 }
 
 /*